@@ -36,6 +36,39 @@ typedef void (*sh1106_send8_cmd_t)(uint8_t cmd);
  */
 typedef void (*sh1106_send8_data_t)(uint8_t data);
 
+/**
+ * @def SH1106_PAGES
+ *
+ * Number of pages in display RAM. Each page is 8 lines high, a bit in a page mask selects a single page.
+ */
+#define SH1106_PAGES 8
+
+/**
+ * @def SH1106_COLUMNS
+ *
+ * Number of columns in display RAM.
+ */
+#define SH1106_COLUMNS 132
+
+/**
+ * @def SH1106_PAGE_MASK_ALL
+ *
+ * Page mask that selects every page of display RAM.
+ */
+#define SH1106_PAGE_MASK_ALL 0xFF
+
+/**
+ * @def SH1106_COMMANDS_API
+ *
+ * Linkage of the command functions. They are out-of-line functions of sh1106.c unless SH1106_INLINE_COMMANDS is
+ * defined, then every translation unit gets them as static inline functions from this header.
+ */
+#ifdef SH1106_INLINE_COMMANDS
+#define SH1106_COMMANDS_API static inline
+#else
+#define SH1106_COMMANDS_API
+#endif
+
 /**
  * @brief Set column address.
  *
@@ -46,6 +79,7 @@ typedef void (*sh1106_send8_data_t)(uint8_t data);
  * @param[in] send8_cmd TODO
  * @param[in] column_addr TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_column_address(const sh1106_send8_cmd_t send8_cmd, uint8_t column_addr);
 
 /**
@@ -70,6 +104,7 @@ enum sh1106_pump_voltage {
  * @param[in] send8_cmd TODO
  * @param[in] pump_voltage TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_pump_voltage(const sh1106_send8_cmd_t send8_cmd, enum sh1106_pump_voltage pump_voltage);
 
 /**
@@ -82,6 +117,7 @@ void sh1106_set_pump_voltage(const sh1106_send8_cmd_t send8_cmd, enum sh1106_pum
  * @param[in] send8_cmd TODO
  * @param[in] line_addr TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_display_start_line(const sh1106_send8_cmd_t send8_cmd, uint8_t line_addr);
 
 /**
@@ -94,6 +130,7 @@ void sh1106_set_display_start_line(const sh1106_send8_cmd_t send8_cmd, uint8_t l
  * @param[in] send8_cmd TODO
  * @param[in] contrast_step TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_contrast_control_register(const sh1106_send8_cmd_t send8_cmd, uint8_t contrast_step);
 
 /**
@@ -116,6 +153,7 @@ enum sh1106_segment_re_map_direction {
  * @param[in] send8_cmd TODO
  * @param[in] segment_re_map_direction TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_segment_re_map(const sh1106_send8_cmd_t send8_cmd,
                                enum sh1106_segment_re_map_direction segment_re_map_direction);
 
@@ -157,6 +195,7 @@ enum sh1106_display_state {
  * @param[in] send8_cmd TODO
  * @param[in] display_state TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_display_state(const sh1106_send8_cmd_t send8_cmd, enum sh1106_display_state display_state);
 
 enum sh1106_display_direction {
@@ -174,6 +213,7 @@ enum sh1106_display_direction {
  * @param[in] send8_cmd TODO
  * @param[in] display_direction TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_display_direction(const sh1106_send8_cmd_t send8_cmd, enum sh1106_display_direction display_direction);
 
 /**
@@ -185,6 +225,7 @@ void sh1106_set_display_direction(const sh1106_send8_cmd_t send8_cmd, enum sh110
  * @param[in] send8_cmd TODO
  * @param[in] multiplex_ratio TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_multiplex_ration(const sh1106_send8_cmd_t send8_cmd, uint8_t multiplex_ratio);
 
 /**
@@ -219,6 +260,7 @@ enum sh1106_dc_dc_mode {
  * @param[in] send8_cmd TODO
  * @param[in] dc_dc_mode TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_dc_dc_mode(const sh1106_send8_cmd_t send8_cmd, enum sh1106_dc_dc_mode dc_dc_mode);
 
 /**
@@ -230,6 +272,7 @@ void sh1106_set_dc_dc_mode(const sh1106_send8_cmd_t send8_cmd, enum sh1106_dc_dc
  * @param[in] send8_cmd TODO
  * @param[in] page_addr TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_page_address(const sh1106_send8_cmd_t send8_cmd, uint8_t page_addr);
 
 /**
@@ -252,6 +295,7 @@ enum sh1106_common_output_scan_direction {
  * @param[in] send8_cmd TODO
  * @param[in] common_output_scan_direction TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_common_output_scan_direction(const sh1106_send8_cmd_t send8_cmd,
                                              enum sh1106_common_output_scan_direction common_output_scan_direction);
 
@@ -266,6 +310,7 @@ void sh1106_set_common_output_scan_direction(const sh1106_send8_cmd_t send8_cmd,
  * @param[in] send8_cmd TODO
  * @param[in] display_offset TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_display_offset(const sh1106_send8_cmd_t send8_cmd, uint8_t display_offset);
 
 /**
@@ -317,6 +362,7 @@ enum sh1106_oscillator_frequency {
  * @param[in] clock_divide_ration TODO
  * @param[in] oscillator_frequency TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_display_clock_divide_ratio_oscillator_frequency(const sh1106_send8_cmd_t send8_cmd,
                                                                 uint8_t clock_divide_ration,
                                                                 enum sh1106_oscillator_frequency oscillator_frequency);
@@ -331,6 +377,7 @@ void sh1106_set_display_clock_divide_ratio_oscillator_frequency(const sh1106_sen
  * @param[in] pre_charge_period TODO
  * @param[in] dis_charge_period TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_dis_charge_pre_charge_period(const sh1106_send8_cmd_t send8_cmd,
                                              uint8_t pre_charge_period,
                                              uint8_t dis_charge_period);
@@ -372,6 +419,7 @@ enum sh1106_common_signals_pad_configuration {
  * @param[in] send8_cmd TODO
  * @param[in] common_signals_pad_configuration TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_common_pads_hardware_configuration(const sh1106_send8_cmd_t send8_cmd,
                                                    enum sh1106_common_signals_pad_configuration common_signals_pad_configuration);
 
@@ -423,6 +471,7 @@ void sh1106_set_common_pads_hardware_configuration(const sh1106_send8_cmd_t send
  * @param[in] send8_cmd TODO
  * @param[in] deselect_level TODO
  */
+SH1106_COMMANDS_API
 void sh1106_set_vcom_deselect_level(const sh1106_send8_cmd_t send8_cmd, uint8_t deselect_level);
 
 /**
@@ -485,6 +534,7 @@ void sh1106_set_vcom_deselect_level(const sh1106_send8_cmd_t send8_cmd, uint8_t
  *
  * @param[in] send8_cmd TODO
  */
+SH1106_COMMANDS_API
 void sh1106_read_modify_write(const sh1106_send8_cmd_t send8_cmd);
 
 /**
@@ -503,6 +553,7 @@ void sh1106_read_modify_write(const sh1106_send8_cmd_t send8_cmd);
  *
  * @param[in] send8_cmd TODO
  */
+SH1106_COMMANDS_API
 void sh1106_end(const sh1106_send8_cmd_t send8_cmd);
 
 /**
@@ -512,6 +563,7 @@ void sh1106_end(const sh1106_send8_cmd_t send8_cmd);
  *
  * @param[in] send8_cmd TODO
  */
+SH1106_COMMANDS_API
 void sh1106_nop(const sh1106_send8_cmd_t send8_cmd);
 
 /**
@@ -523,6 +575,7 @@ void sh1106_nop(const sh1106_send8_cmd_t send8_cmd);
  * @param[in] send8_data TODO
  * @param[in] data TODO
  */
+SH1106_COMMANDS_API
 void sh1106_write_display_data(const sh1106_send8_data_t send8_data, uint8_t data);
 
 /**
@@ -558,4 +611,8 @@ void sh1106_write_display_data(const sh1106_send8_data_t send8_data, uint8_t dat
  */
 // TODO
 
+#ifdef SH1106_INLINE_COMMANDS
+#include "sh1106_commands_impl.h"
+#endif
+
 #endif // YET_ANOTHER_GAUGE__SH1106__SH1106_H
@@ -0,0 +1,257 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_HPP
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_HPP
+
+#include <stdint.h>
+
+extern "C" {
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_syscfg.h"
+}
+
+/**
+ * Header-only C++ wrapper.
+ *
+ * The C API calls the transport through sh1106_send8_cmd_t/sh1106_send8_data_t function pointers, which the compiler
+ * can not inline. sh1106::device takes the transport as a static policy type instead, so command encoding and
+ * transport writes inline into the caller and enum-to-opcode mapping folds at compile time. The emitted byte stream
+ * is identical to the C API.
+ *
+ * struct spi_transport {
+ *   static void send8_cmd(uint8_t cmd) { ... }
+ *   static void send8_data(uint8_t data) { ... }
+ * };
+ *
+ * typedef sh1106::device<spi_transport> display;
+ * display::set_page_address(0);
+ */
+namespace sh1106 {
+
+/**
+ * @brief Geometry of the whole 132x64 display RAM.
+ *
+ * A geometry of a smaller panel, e.g. struct { static const uint8_t columns = 128; static const uint8_t pages = 4; }
+ * for 128x32, keeps flushes inside of its columns and pages.
+ */
+struct geometry_132x64 {
+  static const uint8_t columns = SH1106_COLUMNS;
+  static const uint8_t pages = SH1106_PAGES;
+};
+
+/**
+ * @brief Opcodes of enum parameters.
+ */
+struct opcode {
+  static inline uint8_t pump_voltage(enum sh1106_pump_voltage pump_voltage) {
+    return pump_voltage == SH1106_PUMP_VOLTAGE_7_4 ? SH1106_SET_PUMP_VOLTAGE_7_4 :
+           pump_voltage == SH1106_PUMP_VOLTAGE_8_0 ? SH1106_SET_PUMP_VOLTAGE_8_0 :
+           pump_voltage == SH1106_PUMP_VOLTAGE_8_4 ? SH1106_SET_PUMP_VOLTAGE_8_4 :
+           SH1106_SET_PUMP_VOLTAGE_9_0;
+  }
+
+  static inline uint8_t segment_re_map(enum sh1106_segment_re_map_direction segment_re_map_direction) {
+    return segment_re_map_direction == SH1106_SEGMENT_RE_MAP_NORMAL_DIRECTION
+           ? SH1106_SET_SEGMENT_RE_MAP_NORMAL_DIRECTION
+           : SH1106_SET_SEGMENT_RE_MAP_REVERSE_DIRECTION;
+  }
+
+  static inline uint8_t display_state(enum sh1106_display_state display_state) {
+    return display_state == SH1106_INTERNAL_ON ? SH1106_SET_ENTIRE_DISPLAY_ON :
+           display_state == SH1106_INTERNAL_OFF ? SH1106_SET_ENTIRE_DISPLAY_OFF :
+           display_state == SH1106_OLED_ON ? SH1106_DISPLAY_ON_OLED :
+           SH1106_DISPLAY_OFF_OLED;
+  }
+
+  static inline uint8_t display_direction(enum sh1106_display_direction display_direction) {
+    return display_direction == SH1106_DISPLAY_NORMAL_DIRECTION
+           ? SH1106_SET_NORMAL_DISPLAY_DIRECTION
+           : SH1106_SET_REVERSE_DISPLAY_DIRECTION;
+  }
+
+  static inline uint8_t dc_dc_mode(enum sh1106_dc_dc_mode dc_dc_mode) {
+    return dc_dc_mode == SH1106_DC_DC_ENABLE ? SH1106_DC_DC_ON_MODE_SET : SH1106_DC_DC_OFF_MODE_SET;
+  }
+
+  static inline uint8_t common_output_scan_direction(
+      enum sh1106_common_output_scan_direction common_output_scan_direction) {
+    return common_output_scan_direction == SH1106_COMMON_OUTPUT_SCAN_NORMAL_DIRECTION
+           ? SH1106_SET_COMMON_OUTPUT_SCAN_DIRECTION_FROM_COM0_TO_COMN
+           : SH1106_SET_COMMON_OUTPUT_SCAN_DIRECTION_FROM_COMN_TO_COM0;
+  }
+
+  static inline uint8_t common_pads_hardware_configuration(
+      enum sh1106_common_signals_pad_configuration common_signals_pad_configuration) {
+    return common_signals_pad_configuration == SH1106_COMMON_SIGNALS_PAD_CONFIGURATION_SEQUENTIAL
+           ? SH1106_SEQUENTIAL_MODE_SET
+           : SH1106_ALTERNATIVE_MODE_SET;
+  }
+};
+
+/**
+ * @brief SH1106 device with an inlined transport.
+ *
+ * flush() sends only the dirty columns and pages that are inside of the geometry. The pages of the framebuffer stay
+ * SH1106_COLUMNS bytes apart like those of every sh1106_framebuffer.
+ *
+ * @tparam Transport Type with static send8_cmd(uint8_t) and send8_data(uint8_t) members
+ * @tparam Geometry Type with static columns and pages members
+ */
+template<class Transport, class Geometry = geometry_132x64>
+class device {
+ public:
+  static inline void set_column_address(uint8_t column_addr) {
+    Transport::send8_cmd(SH1106_SET_LOWER_COLUMN_ADDRESS(column_addr));
+    Transport::send8_cmd(SH1106_SET_HIGHER_COLUMN_ADDRESS(column_addr));
+  }
+
+  static inline void set_pump_voltage(enum sh1106_pump_voltage pump_voltage) {
+    Transport::send8_cmd(opcode::pump_voltage(pump_voltage));
+  }
+
+  static inline void set_display_start_line(uint8_t line_addr) {
+    Transport::send8_cmd(SH1106_SET_DISPLAY_START_LINE(line_addr));
+  }
+
+  static inline void set_contrast_control_register(uint8_t contrast_step) {
+    Transport::send8_cmd(SH1106_CONTRAST_CONTROL_MODE_SET);
+    Transport::send8_cmd(SH1106_CONTRAST_DATA_REGISTER_SET(contrast_step));
+  }
+
+  static inline void set_segment_re_map(enum sh1106_segment_re_map_direction segment_re_map_direction) {
+    Transport::send8_cmd(opcode::segment_re_map(segment_re_map_direction));
+  }
+
+  static inline void set_display_state(enum sh1106_display_state display_state) {
+    Transport::send8_cmd(opcode::display_state(display_state));
+  }
+
+  static inline void set_display_direction(enum sh1106_display_direction display_direction) {
+    Transport::send8_cmd(opcode::display_direction(display_direction));
+  }
+
+  static inline void set_multiplex_ration(uint8_t multiplex_ratio) {
+    Transport::send8_cmd(SH1106_MULTIPLE_RATION_MODE_SET);
+    Transport::send8_cmd(SH1106_MULTIPLEX_RATION_DATA_SET(multiplex_ratio));
+  }
+
+  static inline void set_dc_dc_mode(enum sh1106_dc_dc_mode dc_dc_mode) {
+    Transport::send8_cmd(SH1106_DC_DC_CONTROL_MODE_SET);
+    Transport::send8_cmd(opcode::dc_dc_mode(dc_dc_mode));
+  }
+
+  static inline void set_page_address(uint8_t page_addr) {
+    Transport::send8_cmd(SH1106_SET_PAGE_ADDRESS(page_addr));
+  }
+
+  static inline void set_common_output_scan_direction(
+      enum sh1106_common_output_scan_direction common_output_scan_direction) {
+    Transport::send8_cmd(opcode::common_output_scan_direction(common_output_scan_direction));
+  }
+
+  static inline void set_display_offset(uint8_t display_offset) {
+    Transport::send8_cmd(SH1106_DISPLAY_OFFSET_MODE_SET);
+    Transport::send8_cmd(SH1106_DISPLAY_OFFSET_DATA_SET(display_offset));
+  }
+
+  static inline void set_display_clock_divide_ratio_oscillator_frequency(
+      uint8_t clock_divide_ration, enum sh1106_oscillator_frequency oscillator_frequency) {
+    Transport::send8_cmd(SH1106_DIVIDE_RATIO_OSCILLATOR_FREQUENCY_MODE_SET);
+    Transport::send8_cmd(SH1106_DIVIDE_RATIO_OSCILLATOR_FREQUENCY_DATA_SET(clock_divide_ration,
+                                                                          (uint8_t) oscillator_frequency));
+  }
+
+  static inline void set_dis_charge_pre_charge_period(uint8_t pre_charge_period, uint8_t dis_charge_period) {
+    Transport::send8_cmd(SH1106_PRE_CHARGE_PERIOD_MODE_SET);
+    Transport::send8_cmd(SH1106_DIS_CHARGE_PRE_CHARGE_PERIOD_DATA_SET(pre_charge_period, dis_charge_period));
+  }
+
+  static inline void set_common_pads_hardware_configuration(
+      enum sh1106_common_signals_pad_configuration common_signals_pad_configuration) {
+    Transport::send8_cmd(SH1106_COMMON_PADS_HARDWARE_CONFIGURATION_MODE_SET);
+    Transport::send8_cmd(opcode::common_pads_hardware_configuration(common_signals_pad_configuration));
+  }
+
+  static inline void set_vcom_deselect_level(uint8_t deselect_level) {
+    Transport::send8_cmd(SH1106_VCOM_DESELECT_LEVEL_MODE_SET);
+    Transport::send8_cmd(SH1106_VCOM_DESELECT_LEVEL_DATA_SET(deselect_level));
+  }
+
+  static inline void read_modify_write() {
+    Transport::send8_cmd(SH1106_READ_MODIFY_WRITE);
+  }
+
+  static inline void end() {
+    Transport::send8_cmd(SH1106_END);
+  }
+
+  static inline void nop() {
+    Transport::send8_cmd(SH1106_NOP);
+  }
+
+  static inline void write_display_data(uint8_t data) {
+    Transport::send8_data(SH1106_WRITE_DISPLAY_DATA(data));
+  }
+
+  /**
+   * @brief Flush dirty set of a framebuffer.
+   *
+   * Same byte stream as sh1106_framebuffer_flush() for the geometry of the whole display RAM, and as the flush of a
+   * window of the geometry otherwise. The loop is repeated here rather than shared with sh1106_framebuffer_flush_at(),
+   * which would send through the transport pointers again. The whole dirty set is cleared.
+   *
+   * @param[in,out] framebuffer Framebuffer or window
+   *
+   * @return Number of data bytes sent
+   */
+  static inline uint16_t flush(struct sh1106_framebuffer &framebuffer) {
+    uint16_t sent = 0;
+
+    for (uint8_t page_addr = 0; page_addr < framebuffer.pages && page_addr < Geometry::pages; page_addr++) {
+      uint8_t first = framebuffer.dirty.first[page_addr];
+      uint8_t last = framebuffer.dirty.last[page_addr];
+
+      if (!(framebuffer.dirty.pages & (1 << page_addr)) || first >= Geometry::columns) {
+        continue;
+      }
+      if (last >= Geometry::columns) {
+        last = Geometry::columns - 1;
+      }
+
+      const uint8_t *pixel = &framebuffer.pixels[page_addr * SH1106_COLUMNS + first];
+      const uint8_t *end = &framebuffer.pixels[page_addr * SH1106_COLUMNS + last + 1];
+      sent = (uint16_t) (sent + (end - pixel));
+
+      set_page_address(page_addr);
+      set_column_address(first);
+      for (; pixel < end; pixel++) {
+        write_display_data(*pixel);
+      }
+    }
+
+    framebuffer.dirty.pages = 0;
+    return sent;
+  }
+};
+
+} // namespace sh1106
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_HPP
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_AFFINE_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_AFFINE_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_asset.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @brief Inverse affine mapping.
+ *
+ * Maps local framebuffer coordinates back to source pixels in 16.16 fixed point: the centre of pixel (X, Y) samples
+ * the source at u = u0 + X * dudx + Y * dudy, v = v0 + X * dvdx + Y * dvdy. A step is up to 2^24 at the smallest
+ * scale, so the origin and the sampled positions are 64 bit.
+ */
+struct sh1106_affine {
+  int32_t dudx;
+  int32_t dudy;
+  int32_t dvdx;
+  int32_t dvdy;
+  int64_t u0;
+  int64_t v0;
+};
+
+/**
+ * @brief Sine.
+ *
+ * @param[in] degrees Angle in degrees
+ *
+ * @return Sine in 16.16 fixed point
+ */
+int32_t sh1106_sin(int16_t degrees);
+
+/**
+ * @brief Cosine.
+ *
+ * @param[in] degrees Angle in degrees
+ *
+ * @return Cosine in 16.16 fixed point
+ */
+int32_t sh1106_cos(int16_t degrees);
+
+/**
+ * @brief Rotation and scaling about a pivot.
+ *
+ * The source pixel (source_x, source_y) is drawn at the local pixel (x, y) and the source is turned clockwise around
+ * it.
+ *
+ * @param[out] affine Inverse mapping
+ * @param[in] degrees Clockwise rotation in degrees
+ * @param[in] scale Scale in 8.8 fixed point, 256 draws the source at its size
+ * @param[in] source_x Pivot column of the source
+ * @param[in] source_y Pivot line of the source
+ * @param[in] x Column of the pivot in local coordinates
+ * @param[in] y Line of the pivot in local coordinates
+ */
+void sh1106_affine_rotation(struct sh1106_affine *affine,
+                            int16_t degrees,
+                            uint16_t scale,
+                            int16_t source_x,
+                            int16_t source_y,
+                            int16_t x,
+                            int16_t y);
+
+/**
+ * @brief Draw asset frame through an affine mapping.
+ *
+ * Walks the bounding box of the mapped frame, clipped to the clip rectangle, column by column and assembles the 8
+ * lines of every page column into one byte before it is merged into the framebuffer. Pixels of images and fonts
+ * inside of the frame replace the framebuffer pixels, sprites replace only the pixels selected by their mask.
+ *
+ * @param[in,out] framebuffer Framebuffer or window
+ * @param[in] asset Asset
+ * @param[in] frame Frame index
+ * @param[in] affine Inverse mapping from local coordinates to the frame
+ */
+void sh1106_framebuffer_draw_affine(struct sh1106_framebuffer *framebuffer,
+                                    const struct sh1106_asset *asset,
+                                    uint16_t frame,
+                                    const struct sh1106_affine *affine);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_AFFINE_H
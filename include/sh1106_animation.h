@@ -0,0 +1,179 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_ANIMATION_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_ANIMATION_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * XOR-delta animation.
+ *
+ * An animation is a single read-only blob that holds a keyframe and the XOR deltas from every frame to the next one,
+ * in the display RAM order (page by page, column by column, one byte holds 8 vertical pixels, LSB is the top line).
+ * It is played in place, from MCU flash or a memory-mapped file. All numbers are little-endian.
+ *
+ * +----------+----------------------------------------------------+---------------------------------------------+
+ * | Header   | "SHAN", width, pages, frames (16 bit)              | 8 bytes                                     |
+ * +----------+----------------------------------------------------+---------------------------------------------+
+ * | Keyframe | width * pages bytes of pixels                      | Frame 0                                     |
+ * +----------+----------------------------------------------------+---------------------------------------------+
+ * | Deltas   | runs of skip, count and count XOR bytes, ended by  | One per frame: to frames 1, 2, ... and from |
+ * |          | a run with skip and count 0                        | the last frame back to frame 0              |
+ * +----------+----------------------------------------------------+---------------------------------------------+
+ *
+ * A run skips skip unchanged bytes, then XORs the next count bytes. A run never crosses a page, skips may, a run
+ * with count 0 only skips.
+ */
+
+/**
+ * @def SH1106_ANIMATION_HEADER_SIZE
+ *
+ * Size of the animation header in bytes.
+ */
+#define SH1106_ANIMATION_HEADER_SIZE 8
+
+/**
+ * @def SH1106_ANIMATION_SPEED_NORMAL
+ *
+ * Playback speed of the frame period as given, speeds are 8.8 fixed point.
+ */
+#define SH1106_ANIMATION_SPEED_NORMAL 0x0100
+
+/**
+ * @brief Animation player.
+ *
+ * Plays an animation into a page aligned region of the display. Every frame sends only the changed runs, each after
+ * a column address and, when it moves to another page, a page address. Only a run that continues the previous one
+ * on the same page goes without an address. Players of regions that do not overlap run side by side. The caller
+ * passes the current time in ticks of any monotonic clock to sh1106_animation_poll().
+ */
+struct sh1106_animation {
+  /** Animation */
+  const uint8_t *data;
+  /** Next delta */
+  const uint8_t *delta;
+  /** Current frame, width * pages bytes */
+  uint8_t *pixels;
+  /** Width in columns */
+  uint8_t width;
+  /** Height in pages */
+  uint8_t pages;
+  /** Left column of the region */
+  uint8_t column;
+  /** Top page of the region */
+  uint8_t page_addr;
+  /** Number of frames */
+  uint16_t frames;
+  /** Frame shown, UINT16_MAX before the keyframe is sent */
+  uint16_t frame;
+  /** Plays left including the current one, 0 plays forever */
+  uint16_t loops;
+  /** Playback speed, 8.8 fixed point, 0 pauses */
+  uint16_t speed;
+  /** Non-zero while playing */
+  uint8_t playing;
+  /** Ticks per frame at normal speed */
+  uint32_t period;
+  /** Time the next frame is due in ticks */
+  uint32_t next;
+};
+
+/**
+ * @brief Validate animation.
+ *
+ * Checks the header and that every delta lies inside of the animation and the frame. Call it once for an animation
+ * from an untrusted source, the player does not check the deltas.
+ *
+ * @param[in] data Animation
+ * @param[in] size Size of the animation in bytes
+ *
+ * @return Number of frames, -1 if the animation is malformed
+ */
+int32_t sh1106_animation_check(const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Initialize animation player.
+ *
+ * The region must fit the display: column + width <= SH1106_COLUMNS and page_addr + pages <= SH1106_PAGES.
+ *
+ * @param[out] animation Animation player
+ * @param[in] data Animation, must stay valid while it plays
+ * @param[in] pixels Current frame, width * pages bytes
+ * @param[in] column Left column of the region
+ * @param[in] page_addr Top page of the region
+ */
+void sh1106_animation_init(struct sh1106_animation *animation,
+                           const uint8_t *data,
+                           uint8_t *pixels,
+                           uint8_t column,
+                           uint8_t page_addr);
+
+/**
+ * @brief Play animation from the keyframe.
+ *
+ * The keyframe is sent by the first poll. Playback runs at normal speed.
+ *
+ * @param[in,out] animation Animation player
+ * @param[in] now Current time in ticks
+ * @param[in] period Ticks per frame at normal speed
+ * @param[in] loops Number of plays, 0 plays forever
+ */
+void sh1106_animation_play(struct sh1106_animation *animation, uint32_t now, uint32_t period, uint16_t loops);
+
+/**
+ * @brief Set playback speed.
+ *
+ * Takes effect with the next frame.
+ *
+ * @param[in,out] animation Animation player
+ * @param[in] speed Speed, 8.8 fixed point (SH1106_ANIMATION_SPEED_NORMAL is the frame period as given), 0 pauses
+ */
+void sh1106_animation_set_speed(struct sh1106_animation *animation, uint16_t speed);
+
+/**
+ * @brief Stop animation.
+ *
+ * The frame shown stays on the display.
+ *
+ * @param[in,out] animation Animation player
+ */
+void sh1106_animation_stop(struct sh1106_animation *animation);
+
+/**
+ * @brief Advance animation.
+ *
+ * Sends the frame due at the given time. Frames are never dropped because every delta builds on the previous frame,
+ * a late poll delays the rest of the animation instead. The last frame of the last play stays on the display.
+ *
+ * @param[in,out] animation Animation player
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] now Current time in ticks
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_animation_poll(struct sh1106_animation *animation,
+                               const sh1106_send8_cmd_t send8_cmd,
+                               const sh1106_send8_data_t send8_data,
+                               uint32_t now);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_ANIMATION_H
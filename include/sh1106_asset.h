@@ -0,0 +1,153 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_ASSET_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_ASSET_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * Asset bundle.
+ *
+ * A bundle is a single read-only blob that holds images, sprites and fonts already converted to the display RAM
+ * order (page by page, column by column, one byte holds 8 vertical pixels, LSB is the top line). It is used in place,
+ * from MCU flash or a memory-mapped file, and assets are looked up by their index. All numbers are little-endian.
+ *
+ * +--------+-------------------------------------------------------+------------------------------------------+
+ * | Header | "SHAB", count (16 bit), reserved (16 bit)             | 8 bytes                                  |
+ * +--------+-------------------------------------------------------+------------------------------------------+
+ * | Index  | offset (32 bit), frames (16 bit), kind, width, pages, | 12 bytes per asset, offset of the frames |
+ * |        | first, reserved (16 bit)                              | from the start of the bundle             |
+ * +--------+-------------------------------------------------------+------------------------------------------+
+ * | Frames | width * pages bytes of pixels per frame, followed by  | Frames of the assets                     |
+ * |        | width * pages bytes of mask for a sprite              |                                          |
+ * +--------+-------------------------------------------------------+------------------------------------------+
+ *
+ * The glyphs of a font are its frames, frame 0 is the character code first.
+ */
+
+/**
+ * @def SH1106_ASSET_HEADER_SIZE
+ *
+ * Size of the bundle header in bytes.
+ */
+#define SH1106_ASSET_HEADER_SIZE 8
+
+/**
+ * @def SH1106_ASSET_ENTRY_SIZE
+ *
+ * Size of an index entry in bytes.
+ */
+#define SH1106_ASSET_ENTRY_SIZE 12
+
+enum sh1106_asset_kind {
+  /** Opaque image, one or more frames */
+                          SH1106_ASSET_IMAGE = 0,
+  /** Image with a mask, set mask bits select the pixels that are drawn */
+                          SH1106_ASSET_SPRITE = 1,
+  /** Fixed width font, one frame per character */
+                          SH1106_ASSET_FONT = 2
+};
+
+/**
+ * @brief Asset.
+ *
+ * Describes an asset of a bundle, the frames are not copied.
+ */
+struct sh1106_asset {
+  /** Frames inside of the bundle */
+  const uint8_t *frames;
+  /** Number of frames */
+  uint16_t count;
+  /** Asset kind, see enum sh1106_asset_kind */
+  uint8_t kind;
+  /** Width in columns */
+  uint8_t width;
+  /** Height in pages */
+  uint8_t pages;
+  /** Character code of the first glyph of a font */
+  uint8_t first;
+};
+
+/**
+ * @brief Validate bundle.
+ *
+ * Checks the header, that no asset is higher than the display and that every asset lies inside of the bundle. Call it
+ * once for a bundle from an untrusted source, sh1106_asset_get() does not check the frames.
+ *
+ * @param[in] bundle Bundle
+ * @param[in] size Size of the bundle in bytes
+ *
+ * @return Number of assets, -1 if the bundle is malformed
+ */
+int32_t sh1106_asset_bundle_check(const uint8_t *bundle, uint32_t size);
+
+/**
+ * @brief Look up asset.
+ *
+ * @param[in] bundle Bundle
+ * @param[in] id Asset index
+ * @param[out] asset Asset
+ *
+ * @return 0 on success, -1 if there is no such asset
+ */
+int sh1106_asset_get(const uint8_t *bundle, uint16_t id, struct sh1106_asset *asset);
+
+/**
+ * @brief Get frame.
+ *
+ * @param[in] asset Asset
+ * @param[in] frame Frame index
+ *
+ * @return Pixels of the frame (followed by its mask for a sprite), NULL if there is no such frame
+ */
+const uint8_t *sh1106_asset_frame(const struct sh1106_asset *asset, uint16_t frame);
+
+/**
+ * @brief Get glyph of a font.
+ *
+ * @param[in] font Font asset
+ * @param[in] code Character code
+ *
+ * @return Pixels of the glyph, NULL if the font has no such glyph
+ */
+const uint8_t *sh1106_asset_glyph(const struct sh1106_asset *font, uint8_t code);
+
+/**
+ * @brief Draw asset frame into framebuffer.
+ *
+ * The frame is drawn at any line, pages of the frame are shifted across two pages of the framebuffer. Images and
+ * fonts replace the whole rectangle, sprites replace only the pixels selected by their mask.
+ *
+ * @param[in,out] framebuffer Framebuffer or window
+ * @param[in] asset Asset
+ * @param[in] frame Frame index
+ * @param[in] x Left column in local coordinates
+ * @param[in] y Top line in local coordinates
+ */
+void sh1106_framebuffer_draw_asset(struct sh1106_framebuffer *framebuffer,
+                                   const struct sh1106_asset *asset,
+                                   uint16_t frame,
+                                   int16_t x,
+                                   int16_t y);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_ASSET_H
@@ -0,0 +1,172 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_BUDGET_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_BUDGET_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_trace.h"
+
+/**
+ * @def SH1106_BUDGET_MAX_REGIONS
+ *
+ * Maximal number of priority regions.
+ */
+#ifndef SH1106_BUDGET_MAX_REGIONS
+#define SH1106_BUDGET_MAX_REGIONS 8
+#endif
+
+/**
+ * @def SH1106_BUDGET_CHUNK
+ *
+ * Most data bytes sent between two reads of the clock, bounds how far a time budget can be overrun.
+ */
+#ifndef SH1106_BUDGET_CHUNK
+#define SH1106_BUDGET_CHUNK 16
+#endif
+
+/**
+ * @def SH1106_BUDGET_OCCUPANCY_SIZE
+ *
+ * Size of the pending column bitmap of a page in bytes.
+ */
+#define SH1106_BUDGET_OCCUPANCY_SIZE ((SH1106_COLUMNS + 7) / 8)
+
+/**
+ * @brief Priority region.
+ *
+ * Pages and columns of the framebuffer, dirty columns inside of it are sent before those of lower priority regions.
+ */
+struct sh1106_budget_region {
+  /** First page */
+  uint8_t first_page;
+  /** Last page */
+  uint8_t last_page;
+  /** First column */
+  uint8_t first;
+  /** Last column */
+  uint8_t last;
+  /** Priority, higher is sent first */
+  uint8_t priority;
+};
+
+/**
+ * @brief Budgeted flush metrics.
+ */
+struct sh1106_budget_metrics {
+  /** Number of flushes */
+  uint32_t calls;
+  /** Number of flushes that stopped at the budget with columns left */
+  uint32_t partial;
+  /** Number of bytes sent (commands and data) */
+  uint32_t bytes;
+  /** Most bytes sent by a single flush */
+  uint16_t max_bytes;
+  /** Most ticks taken by a single flush, if there is a clock */
+  uint32_t max_ticks;
+};
+
+/**
+ * @brief Budgeted incremental flush.
+ *
+ * Flushes a framebuffer a slice at a time, so display I/O fits a fixed slot of the main loop. Dirty columns are moved
+ * from the dirty set of the framebuffer into a column bitmap, and every flush sends them highest priority region first
+ * until a byte or time budget is spent. A column is cleared as it is sent, so the next flush resumes where this one
+ * stopped without sending anything twice; columns drawn again in between are simply sent once more. Every run starts
+ * with its page and column address, except where it continues the previous one.
+ */
+struct sh1106_budget {
+  /** Framebuffer */
+  struct sh1106_framebuffer *framebuffer;
+  /** Regions by descending priority */
+  struct sh1106_budget_region regions[SH1106_BUDGET_MAX_REGIONS];
+  /** Number of regions */
+  uint8_t count;
+  /** Columns left to be sent, bit N of byte M selects column 8 * M + N */
+  uint8_t pending[SH1106_PAGES][SH1106_BUDGET_OCCUPANCY_SIZE];
+  /** Clock for time budgets, may be NULL */
+  sh1106_clock_t clock;
+  /** Budgeted flush metrics */
+  struct sh1106_budget_metrics metrics;
+};
+
+/**
+ * @brief Initialize budgeted flush.
+ *
+ * @param[out] budget Budgeted flush
+ * @param[in,out] framebuffer Framebuffer, SH1106_COLUMNS wide from column 0
+ * @param[in] clock Clock for time budgets, may be NULL if only byte budgets are used
+ */
+void sh1106_budget_init(struct sh1106_budget *budget, struct sh1106_framebuffer *framebuffer, sh1106_clock_t clock);
+
+/**
+ * @brief Add priority region.
+ *
+ * The rectangle is rounded out to pages. Columns outside of every region are sent last.
+ *
+ * @param[in,out] budget Budgeted flush
+ * @param[in] x Left column
+ * @param[in] y Top line
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] priority Priority, higher is sent first
+ *
+ * @return 0 on success, -1 if there are SH1106_BUDGET_MAX_REGIONS regions or the rectangle is off the framebuffer
+ */
+int sh1106_budget_add_region(struct sh1106_budget *budget,
+                             int16_t x,
+                             int16_t y,
+                             int16_t width,
+                             int16_t height,
+                             uint8_t priority);
+
+/**
+ * @brief Flush within a budget.
+ *
+ * Stops before a run would exceed the byte budget, and before the next chunk of at most SH1106_BUDGET_CHUNK data bytes
+ * once the time budget is spent. The first chunk is sent even if the time budget is already spent, so a flush that is
+ * called late still makes progress.
+ *
+ * @param[in,out] budget Budgeted flush
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] bytes Byte budget (commands and data, at least 4 to make progress), 0 for none
+ * @param[in] ticks Time budget in ticks of the clock, 0 for none
+ *
+ * @return Number of bytes sent (commands and data)
+ */
+uint16_t sh1106_budget_flush(struct sh1106_budget *budget,
+                             const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             uint16_t bytes,
+                             uint32_t ticks);
+
+/**
+ * @brief Check for columns left to be sent.
+ *
+ * @param[in] budget Budgeted flush
+ *
+ * @return Non-zero if a flush has something to send
+ */
+int sh1106_budget_pending(const struct sh1106_budget *budget);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_BUDGET_H
@@ -0,0 +1,160 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_BUS_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_BUS_H
+
+#include <stdint.h>
+
+/**
+ * @brief Bus interface.
+ */
+enum sh1106_bus {
+  /** 4-wire SPI: 8 bits per byte, A0 on the D/C line */
+      SH1106_BUS_SPI_4_WIRE,
+  /** 3-wire SPI: 9 bits per byte, A0 sent as the first bit */
+      SH1106_BUS_SPI_3_WIRE,
+  /** I2C: start, slave address, control byte, 9 bits per byte (with ACK), stop */
+      SH1106_BUS_I2C,
+};
+
+/**
+ * @brief Bus wire-time model.
+ *
+ * A transaction is a run of bytes of the same kind (commands or data) sent with chip select held (SPI) or between
+ * START and STOP (I2C). Every transaction pays a fixed overhead, on 4-wire SPI every change of kind also pays the
+ * D/C line switch.
+ */
+struct sh1106_bus_model {
+  /** Bus interface */
+  enum sh1106_bus bus;
+  /** Bus clock in Hz */
+  uint32_t clock;
+  /** Chip select setup/hold and driver overhead per transaction in ns */
+  uint32_t transaction_overhead;
+  /** D/C line switch in ns (4-wire SPI) */
+  uint32_t dc_switch;
+  /** Maximal number of payload bytes per transaction, 0 for unlimited */
+  uint16_t transaction_max;
+};
+
+/**
+ * @brief Wire-time estimate.
+ */
+struct sh1106_bus_stats {
+  /** Number of command bytes */
+  uint32_t commands;
+  /** Number of data bytes */
+  uint32_t data;
+  /** Number of transactions */
+  uint32_t transactions;
+  /** Number of D/C line switches */
+  uint32_t dc_switches;
+  /** Number of bit times on the wire, including protocol overhead */
+  uint64_t bits;
+  /** Transaction and D/C switch overheads in ns */
+  uint64_t overhead;
+  /** Wire time in ns, the overheads plus the bit times of all bytes accounted so far rounded down once */
+  uint64_t time;
+  /** Kind of the open transaction: 0 none, 1 command, 2 data */
+  uint8_t kind;
+  /** Level of the D/C line: 0 unknown, 1 command, 2 data */
+  uint8_t dc;
+  /** Number of payload bytes in the open transaction */
+  uint16_t length;
+};
+
+/**
+ * @brief Initialize bus model with typical overheads.
+ *
+ * 4-wire and 3-wire SPI: 100 ns per transaction, 50 ns per D/C switch, unlimited transactions. I2C: 32 payload bytes
+ * per transaction (a common driver buffer size) and the bus free time between STOP and START (1.3 us fast mode).
+ *
+ * @param[out] model Bus model
+ * @param[in] bus Bus interface
+ * @param[in] clock Bus clock in Hz
+ */
+void sh1106_bus_model_init(struct sh1106_bus_model *model, enum sh1106_bus bus, uint32_t clock);
+
+/**
+ * @brief Reset estimate.
+ *
+ * @param[out] stats Wire-time estimate
+ */
+void sh1106_bus_reset(struct sh1106_bus_stats *stats);
+
+/**
+ * @brief Account bytes.
+ *
+ * Consecutive calls with the same kind continue the open transaction.
+ *
+ * @param[in] model Bus model
+ * @param[in,out] stats Wire-time estimate
+ * @param[in] data Non-zero for data bytes, 0 for command bytes
+ * @param[in] count Number of bytes
+ */
+void sh1106_bus_account(const struct sh1106_bus_model *model,
+                        struct sh1106_bus_stats *stats,
+                        uint8_t data,
+                        uint32_t count);
+
+/**
+ * @brief Close the open transaction.
+ *
+ * Call at the end of a flush, the next bytes start a new transaction.
+ *
+ * @param[in,out] stats Wire-time estimate
+ */
+void sh1106_bus_end(struct sh1106_bus_stats *stats);
+
+/**
+ * @brief Account a transport trace.
+ *
+ * @param[in] model Bus model
+ * @param[in,out] stats Wire-time estimate
+ * @param[in] trace Trace (see sh1106_trace.h)
+ * @param[in] size Size of the trace
+ *
+ * @return 0 on success, -1 if the trace is malformed
+ */
+int sh1106_bus_account_trace(const struct sh1106_bus_model *model,
+                             struct sh1106_bus_stats *stats,
+                             const uint8_t *trace,
+                             uint32_t size);
+
+/**
+ * @brief Achievable frame rate.
+ *
+ * @param[in] frame Wire-time estimate of one frame
+ *
+ * @return Maximal number of frames per second in 1/100 fps, 0 if the frame is empty
+ */
+uint32_t sh1106_bus_max_fps(const struct sh1106_bus_stats *frame);
+
+/**
+ * @brief Bus utilization.
+ *
+ * @param[in] frame Wire-time estimate of one frame
+ * @param[in] fps Frame rate in frames per second
+ *
+ * @return Bus utilization in 1/100 percent, may exceed 10000 if the frame rate is not achievable
+ */
+uint32_t sh1106_bus_utilization(const struct sh1106_bus_stats *frame, uint16_t fps);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_BUS_H
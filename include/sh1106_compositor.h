@@ -0,0 +1,133 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_COMPOSITOR_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_COMPOSITOR_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_timing.h"
+
+/**
+ * @def SH1106_COMPOSITOR_MAX_LAYERS
+ *
+ * Maximum number of layers of a compositor, at most 255 as the layer count is a byte. It sizes struct
+ * sh1106_compositor, so the library and its users must be built with the same value.
+ */
+#ifndef SH1106_COMPOSITOR_MAX_LAYERS
+#define SH1106_COMPOSITOR_MAX_LAYERS 4
+#endif
+
+#if SH1106_COMPOSITOR_MAX_LAYERS < 1 || SH1106_COMPOSITOR_MAX_LAYERS > 255
+#error "SH1106_COMPOSITOR_MAX_LAYERS must be in 1 - 255"
+#endif
+
+/**
+ * @brief Layer.
+ *
+ * A full screen page-major framebuffer drawn with the sh1106_framebuffer_*() functions, which record what changed in
+ * its dirty set. Without a mask the lit pixels of the layer are ORed over the layers below. With a mask (same layout
+ * as the pixels) every set mask bit replaces the pixel below with the layer pixel and every clear bit keeps it, so
+ * a layer can also erase. Invalidate the layer after changing its mask.
+ */
+struct sh1106_layer {
+  /** Pixels and dirty set */
+  struct sh1106_framebuffer framebuffer;
+  /** Mask, SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES) bytes, or NULL */
+  const uint8_t *mask;
+};
+
+/**
+ * @brief Layer stack.
+ *
+ * Layers are composited bottom to top into the output framebuffer, which is in display RAM order and can be sent as
+ * is. Only the union of the layer dirty sets is recomposited, so a static layer is rasterized once and then only
+ * read where another layer changed.
+ */
+struct sh1106_compositor {
+  /** Layers, bottom first */
+  struct sh1106_layer *layers[SH1106_COMPOSITOR_MAX_LAYERS];
+  /** Number of layers */
+  uint8_t count;
+  /** Composited pixels and the dirty set not yet flushed */
+  struct sh1106_framebuffer output;
+  /** Flush timing, or NULL; recorded only if built with SH1106_TIMING */
+  struct sh1106_timing *timing;
+};
+
+/**
+ * @brief Initialize layer.
+ *
+ * Clears the pixels and marks the whole layer as dirty.
+ *
+ * @param[out] layer Layer
+ * @param[in] pixels Pixel storage, SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES) bytes
+ * @param[in] mask Mask, SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES) bytes, or NULL to OR the layer
+ */
+void sh1106_layer_init(struct sh1106_layer *layer, uint8_t *pixels, const uint8_t *mask);
+
+/**
+ * @brief Initialize compositor.
+ *
+ * @param[out] compositor Compositor without layers and without flush timing
+ * @param[in] pixels Output pixel storage, SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES) bytes
+ */
+void sh1106_compositor_init(struct sh1106_compositor *compositor, uint8_t *pixels);
+
+/**
+ * @brief Add layer on top of the stack.
+ *
+ * @param[in,out] compositor Compositor
+ * @param[in] layer Layer, must stay valid while the compositor is used
+ *
+ * @return 0 on success, -1 if the stack is full
+ */
+int sh1106_compositor_add(struct sh1106_compositor *compositor, struct sh1106_layer *layer);
+
+/**
+ * @brief Composite dirty regions.
+ *
+ * Recomposites the union of the layer dirty sets a machine word at a time, adds it to the dirty set of the output
+ * and clears the layer dirty sets. With flush timing, the union ends SH1106_STAGE_DIFF and the recompositing ends
+ * SH1106_STAGE_ENCODE.
+ *
+ * @param[in,out] compositor Compositor
+ */
+void sh1106_compositor_compose(struct sh1106_compositor *compositor);
+
+/**
+ * @brief Composite and flush dirty regions.
+ *
+ * Calls sh1106_compositor_compose() and sends the output with sh1106_framebuffer_flush(). With flush timing, the
+ * call ends SH1106_STAGE_RENDER, the last byte sent ends SH1106_STAGE_TRANSFER and the flush ends the measurement
+ * started by sh1106_timing_begin(), e.g. when the displayed value changed.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] compositor Compositor
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_compositor_flush(const sh1106_send8_cmd_t send8_cmd,
+                                 const sh1106_send8_data_t send8_data,
+                                 struct sh1106_compositor *compositor);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_COMPOSITOR_H
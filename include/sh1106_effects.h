@@ -0,0 +1,210 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_EFFECTS_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_EFFECTS_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+enum sh1106_effect {
+  /** No effect is running */
+                      SH1106_EFFECT_NONE = 0,
+  /** Display OFF/ON OLED toggled every step */
+                      SH1106_EFFECT_BLINK = 1,
+  /** Normal/reverse display toggled every step */
+                      SH1106_EFFECT_INVERT_PULSE = 2,
+  /** Display offset moved up and down every step */
+                      SH1106_EFFECT_SHAKE = 3,
+  /** Start line scrolled while the pages of a new frame are written right before they scroll in */
+                      SH1106_EFFECT_SLIDE_IN = 4
+};
+
+/**
+ * @def SH1106_EFFECTS
+ *
+ * Number of effect kinds including SH1106_EFFECT_NONE.
+ */
+#define SH1106_EFFECTS 5
+
+/**
+ * @brief Register state restored by the effects.
+ *
+ * Keep it in sync when the application changes these registers itself.
+ */
+struct sh1106_effect_registers {
+  /** Display start line (0 - 63) */
+  uint8_t start_line;
+  /** Display offset (0 - 63) */
+  uint8_t display_offset;
+  /** Normal or reverse display */
+  enum sh1106_display_direction display_direction;
+};
+
+/**
+ * @brief Effect metrics.
+ */
+struct sh1106_effect_metrics {
+  /** Number of effects started, per kind */
+  uint32_t runs[SH1106_EFFECTS];
+  /** Number of bytes sent (commands and display data), per kind */
+  uint32_t bytes[SH1106_EFFECTS];
+};
+
+/**
+ * @brief Hardware effects engine.
+ *
+ * Animates a static frame through the controller registers instead of redrawing it: each step costs a few command
+ * bytes. One effect runs at a time, the caller passes the current time in ticks of any monotonic clock to
+ * sh1106_effects_poll(), which applies the steps and restores the registers when the effect ends. An effect starts
+ * with the first poll after it was scheduled.
+ */
+struct sh1106_effects {
+  /** Registers to be restored */
+  struct sh1106_effect_registers registers;
+  /** Running effect */
+  enum sh1106_effect effect;
+  /** Time the effect started in ticks */
+  uint32_t start;
+  /** Ticks per step */
+  uint32_t period;
+  /** Number of steps */
+  uint16_t steps;
+  /** Last step applied, UINT16_MAX before the first one */
+  uint16_t step;
+  /** Lines moved by a step of a shake or a slide-in */
+  uint8_t lines;
+  /** Pages of the new frame already written by a slide-in */
+  uint8_t written;
+  /** New frame of a slide-in */
+  struct sh1106_framebuffer *framebuffer;
+  /** Effect metrics */
+  struct sh1106_effect_metrics metrics;
+};
+
+/**
+ * @brief Initialize effects engine.
+ *
+ * The registers to be restored are set to their POR values.
+ *
+ * @param[out] effects Effects engine
+ */
+void sh1106_effects_init(struct sh1106_effects *effects);
+
+/**
+ * @brief Blink the display.
+ *
+ * @param[in,out] effects Effects engine
+ * @param[in] now Current time in ticks
+ * @param[in] period Ticks the display stays off and on
+ * @param[in] count Number of blinks
+ *
+ * @return 0 on success, -1 if an effect is running
+ */
+int sh1106_effect_blink(struct sh1106_effects *effects, uint32_t now, uint32_t period, uint8_t count);
+
+/**
+ * @brief Invert the display for a moment.
+ *
+ * @param[in,out] effects Effects engine
+ * @param[in] now Current time in ticks
+ * @param[in] period Ticks the display stays inverted and normal
+ * @param[in] count Number of pulses
+ *
+ * @return 0 on success, -1 if an effect is running
+ */
+int sh1106_effect_invert_pulse(struct sh1106_effects *effects, uint32_t now, uint32_t period, uint8_t count);
+
+/**
+ * @brief Shake the display vertically.
+ *
+ * Lines moved off one edge wrap around to the other one.
+ *
+ * @param[in,out] effects Effects engine
+ * @param[in] now Current time in ticks
+ * @param[in] period Ticks per step, a shake is up, center, down, center
+ * @param[in] count Number of shakes
+ * @param[in] amplitude Lines moved up and down
+ *
+ * @return 0 on success, -1 if an effect is running
+ */
+int sh1106_effect_shake(struct sh1106_effects *effects,
+                        uint32_t now,
+                        uint32_t period,
+                        uint8_t count,
+                        uint8_t amplitude);
+
+/**
+ * @brief Slide a new frame in from the bottom.
+ *
+ * The displayed frame scrolls up with the start line while the new frame follows it. Every page of the new frame is
+ * written to display RAM right before it scrolls into view, so the frame is sent exactly once. The start line should
+ * be a multiple of 8. The dirty set of the framebuffer is cleared when the slide-in ends.
+ *
+ * A page of the new frame goes to the display RAM page that held the same page of the old frame. The frame therefore
+ * scrolls whole pages: lines is rounded up to a multiple of 8, so a page is written only once the old page has left
+ * the screen, and the new lines never show at the top.
+ *
+ * @param[in,out] effects Effects engine
+ * @param[in] now Current time in ticks
+ * @param[in] period Ticks per step
+ * @param[in] framebuffer New frame, SH1106_PAGES pages, must stay valid while the effect runs
+ * @param[in] lines Lines scrolled per step (1 - 64), rounded up to a multiple of 8
+ *
+ * @return 0 on success, -1 if an effect is running
+ */
+int sh1106_effect_slide_in(struct sh1106_effects *effects,
+                           uint32_t now,
+                           uint32_t period,
+                           struct sh1106_framebuffer *framebuffer,
+                           uint8_t lines);
+
+/**
+ * @brief Advance running effect.
+ *
+ * Applies the step due at the given time, skipped steps are not replayed. Restores the registers after the last step.
+ *
+ * @param[in,out] effects Effects engine
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] now Current time in ticks
+ *
+ * @return Running effect, SH1106_EFFECT_NONE once it ended
+ */
+enum sh1106_effect sh1106_effects_poll(struct sh1106_effects *effects,
+                                       const sh1106_send8_cmd_t send8_cmd,
+                                       const sh1106_send8_data_t send8_data,
+                                       uint32_t now);
+
+/**
+ * @brief Stop running effect and restore the registers.
+ *
+ * A slide-in is completed: the pages of the new frame not written yet are sent.
+ *
+ * @param[in,out] effects Effects engine
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ */
+void sh1106_effects_stop(struct sh1106_effects *effects,
+                         const sh1106_send8_cmd_t send8_cmd,
+                         const sh1106_send8_data_t send8_data);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_EFFECTS_H
@@ -0,0 +1,110 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_EMULATOR_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_EMULATOR_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * @brief SH1106 command decoder.
+ *
+ * Decodes the byte stream sent to the controller into display RAM and register state. Used to replay traces and to
+ * run the drawing code on a host without a panel.
+ */
+struct sh1106_emulator {
+  /** Display RAM */
+  uint8_t ram[SH1106_PAGES][SH1106_COLUMNS];
+  /** Page address register */
+  uint8_t page_addr;
+  /** Column address counter */
+  uint8_t column_addr;
+  /** Column address saved by Read-Modify-Write */
+  uint8_t rmw_column_addr;
+  /** Non-zero in Read-Modify-Write mode */
+  uint8_t rmw;
+  /** First byte of a double byte command waiting for its data byte, 0 if none */
+  uint8_t pending;
+  /** Display start line (0 - 63) */
+  uint8_t start_line;
+  /** Contrast step */
+  uint8_t contrast;
+  /** Non-zero if segment re-map is reversed */
+  uint8_t segment_re_map;
+  /** Non-zero if entire display is forced on */
+  uint8_t entire_display_on;
+  /** Non-zero in reverse display */
+  uint8_t reverse;
+  /** Multiplex ratio data (ratio - 1) */
+  uint8_t multiplex_ratio;
+  /** Non-zero if DC-DC is on */
+  uint8_t dc_dc;
+  /** Non-zero if display is on */
+  uint8_t display_on;
+  /** Non-zero if COM scan direction is flipped */
+  uint8_t scan_flipped;
+  /** Display offset */
+  uint8_t display_offset;
+  /** Divide ratio/oscillator frequency data */
+  uint8_t clock;
+  /** Dis-charge/pre-charge period data */
+  uint8_t pre_charge;
+  /** Common pads hardware configuration data */
+  uint8_t pads;
+  /** VCOM deselect level */
+  uint8_t vcom;
+  /** Pump voltage data (0 - 3) */
+  uint8_t pump;
+  /** Number of command bytes decoded */
+  uint32_t commands;
+  /** Number of data bytes decoded */
+  uint32_t data;
+};
+
+/**
+ * @brief Reset emulator to the power on state.
+ *
+ * Display RAM is cleared.
+ *
+ * @param[out] emulator Emulator
+ */
+void sh1106_emulator_reset(struct sh1106_emulator *emulator);
+
+/**
+ * @brief Decode command byte.
+ *
+ * @param[in,out] emulator Emulator
+ * @param[in] cmd Command byte (A0 = 0)
+ */
+void sh1106_emulator_cmd(struct sh1106_emulator *emulator, uint8_t cmd);
+
+/**
+ * @brief Decode data byte.
+ *
+ * Writes display RAM at the current page and column and increments the column address. Writes past column 131 are
+ * ignored.
+ *
+ * @param[in,out] emulator Emulator
+ * @param[in] data Data byte (A0 = 1)
+ */
+void sh1106_emulator_data(struct sh1106_emulator *emulator, uint8_t data);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_EMULATOR_H
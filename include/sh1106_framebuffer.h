@@ -0,0 +1,260 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_FRAMEBUFFER_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_FRAMEBUFFER_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * @def SH1106_FRAMEBUFFER_API
+ *
+ * Linkage of the dirty set and framebuffer functions. They are out-of-line functions of sh1106_framebuffer.c unless
+ * SH1106_INLINE_FRAMEBUFFER is defined, then every translation unit gets them as static inline functions from this
+ * header.
+ */
+#ifdef SH1106_INLINE_FRAMEBUFFER
+#define SH1106_FRAMEBUFFER_API static inline
+#else
+#define SH1106_FRAMEBUFFER_API
+#endif
+
+/**
+ * @def SH1106_FRAMEBUFFER_SIZE(pages)
+ *
+ * Size of a page-major framebuffer in bytes.
+ */
+#define SH1106_FRAMEBUFFER_SIZE(pages) ((pages) * SH1106_COLUMNS)
+
+/**
+ * @brief Dirty set.
+ *
+ * One column span per page, a page is dirty when its bit is set in the page mask.
+ */
+struct sh1106_dirty {
+  /** Dirty pages, bit N selects page N */
+  uint8_t pages;
+  /** First dirty column of every page */
+  uint8_t first[SH1106_PAGES];
+  /** Last dirty column of every page */
+  uint8_t last[SH1106_PAGES];
+};
+
+/**
+ * @brief Clear dirty set.
+ *
+ * @param[out] dirty Dirty set
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_dirty_reset(struct sh1106_dirty *dirty);
+
+/**
+ * @brief Add column span of a page to dirty set.
+ *
+ * @param[in,out] dirty Dirty set
+ * @param[in] page_addr Page address
+ * @param[in] first First column
+ * @param[in] last Last column
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_dirty_mark(struct sh1106_dirty *dirty, uint8_t page_addr, uint8_t first, uint8_t last);
+
+/**
+ * @brief Page-major framebuffer.
+ *
+ * The pixels are stored in display RAM order, SH1106_COLUMNS bytes per page, one byte holds 8 vertical pixels (LSB
+ * is the top line). Drawing is translated by the origin, clipped to the clip rectangle and recorded in the dirty set,
+ * so a flush sends only what changed.
+ *
+ * A window (see sh1106_window_init()) is a framebuffer that shares the pixels of another one but has its own origin,
+ * clip rectangle and dirty set. Flushing a window sends only its rectangle.
+ */
+struct sh1106_framebuffer {
+  /** Pixels, SH1106_FRAMEBUFFER_SIZE(pages) bytes */
+  uint8_t *pixels;
+  /** Number of pages */
+  uint8_t pages;
+  /** Screen column of local column 0 */
+  int16_t origin_x;
+  /** Screen line of local line 0 */
+  int16_t origin_y;
+  /** Clip rectangle in screen coordinates, the right and bottom edges are exclusive */
+  uint8_t clip_x0;
+  uint8_t clip_y0;
+  uint8_t clip_x1;
+  uint8_t clip_y1;
+  /** Dirty set */
+  struct sh1106_dirty dirty;
+};
+
+/**
+ * @brief Initialize framebuffer.
+ *
+ * Clears the pixels and marks the whole framebuffer as dirty.
+ *
+ * @param[out] framebuffer Framebuffer
+ * @param[in] pixels Pixel storage, SH1106_FRAMEBUFFER_SIZE(pages) bytes
+ * @param[in] pages Number of pages (1 - 8)
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_init(struct sh1106_framebuffer *framebuffer, uint8_t *pixels, uint8_t pages);
+
+/**
+ * @brief Initialize window.
+ *
+ * The window draws into the pixels of the screen framebuffer. Local coordinates start at (x, y) of the screen and
+ * drawing is clipped to the window rectangle. The window has its own dirty set, flushing it never resends pixels
+ * of other windows.
+ *
+ * @param[out] window Window
+ * @param[in] screen Framebuffer that owns the pixels
+ * @param[in] x Left column in screen coordinates
+ * @param[in] y Top line in screen coordinates
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_window_init(struct sh1106_framebuffer *window,
+                        const struct sh1106_framebuffer *screen,
+                        int16_t x,
+                        int16_t y,
+                        int16_t width,
+                        int16_t height);
+
+/**
+ * @brief Mark the whole clip rectangle as dirty.
+ *
+ * @param[in,out] framebuffer Framebuffer or window
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_invalidate(struct sh1106_framebuffer *framebuffer);
+
+/**
+ * @brief Clear the clip rectangle.
+ *
+ * @param[in,out] framebuffer Framebuffer or window
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_clear(struct sh1106_framebuffer *framebuffer);
+
+/**
+ * @brief Set pixel.
+ *
+ * @param[in,out] framebuffer Framebuffer or window
+ * @param[in] x Column in local coordinates
+ * @param[in] y Line in local coordinates
+ * @param[in] on Non-zero to light the pixel, 0 to clear it
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_set_pixel(struct sh1106_framebuffer *framebuffer, int16_t x, int16_t y, uint8_t on);
+
+/**
+ * @brief Get pixel.
+ *
+ * @param[in] framebuffer Framebuffer or window
+ * @param[in] x Column in local coordinates
+ * @param[in] y Line in local coordinates
+ *
+ * @return 1 if the pixel is lit, 0 if it is not or lies outside of the clip rectangle
+ */
+SH1106_FRAMEBUFFER_API
+uint8_t sh1106_framebuffer_get_pixel(const struct sh1106_framebuffer *framebuffer, int16_t x, int16_t y);
+
+/**
+ * @brief Fill rectangle.
+ *
+ * Columns are filled a whole byte at a time.
+ *
+ * @param[in,out] framebuffer Framebuffer or window
+ * @param[in] x Left column in local coordinates
+ * @param[in] y Top line in local coordinates
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] on Non-zero to light the pixels, 0 to clear them
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_fill_rect(struct sh1106_framebuffer *framebuffer,
+                                  int16_t x,
+                                  int16_t y,
+                                  int16_t width,
+                                  int16_t height,
+                                  uint8_t on);
+
+/**
+ * @brief Write span of display RAM.
+ *
+ * Sends sh1106_set_page_address(), sh1106_set_column_address() and one sh1106_write_display_data() per byte.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] page_addr Page address
+ * @param[in] column_addr Column address of the first byte
+ * @param[in] data Bytes
+ * @param[in] size Number of bytes
+ */
+SH1106_FRAMEBUFFER_API
+void sh1106_write_span(const sh1106_send8_cmd_t send8_cmd,
+                       const sh1106_send8_data_t send8_data,
+                       uint8_t page_addr,
+                       uint8_t column_addr,
+                       const uint8_t *data,
+                       uint16_t size);
+
+/**
+ * @brief Flush dirty set.
+ *
+ * Every dirty page is sent as one span with its own sh1106_set_page_address() and sh1106_set_column_address(). The
+ * dirty set is cleared.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] framebuffer Framebuffer or window
+ *
+ * @return Number of data bytes sent
+ */
+SH1106_FRAMEBUFFER_API
+uint16_t sh1106_framebuffer_flush(const sh1106_send8_cmd_t send8_cmd,
+                                  const sh1106_send8_data_t send8_data,
+                                  struct sh1106_framebuffer *framebuffer);
+
+/**
+ * @brief Flush dirty set to display RAM pages from an offset.
+ *
+ * Like sh1106_framebuffer_flush(), page N of the framebuffer is sent to display RAM page page_offset + N.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] framebuffer Framebuffer or window
+ * @param[in] page_offset Display RAM page of framebuffer page 0
+ *
+ * @return Number of data bytes sent
+ */
+SH1106_FRAMEBUFFER_API
+uint16_t sh1106_framebuffer_flush_at(const sh1106_send8_cmd_t send8_cmd,
+                                     const sh1106_send8_data_t send8_data,
+                                     struct sh1106_framebuffer *framebuffer,
+                                     uint8_t page_offset);
+
+#ifdef SH1106_INLINE_FRAMEBUFFER
+#include "sh1106_framebuffer_impl.h"
+#endif
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_FRAMEBUFFER_H
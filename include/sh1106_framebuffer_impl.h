@@ -0,0 +1,249 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_FRAMEBUFFER_IMPL_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_FRAMEBUFFER_IMPL_H
+
+/*
+ * Definitions of the dirty set and framebuffer functions, compiled by sh1106_framebuffer.c or, with
+ * SH1106_INLINE_FRAMEBUFFER, included by sh1106_framebuffer.h.
+ */
+
+#include <string.h>
+
+#include "sh1106_framebuffer.h"
+
+SH1106_FRAMEBUFFER_API
+void sh1106_dirty_reset(struct sh1106_dirty *dirty) {
+  dirty->pages = 0;
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_dirty_mark(struct sh1106_dirty *dirty, uint8_t page_addr, uint8_t first, uint8_t last) {
+  uint8_t bit = (uint8_t) (1 << page_addr);
+
+  if (!(dirty->pages & bit)) {
+    dirty->pages |= bit;
+    dirty->first[page_addr] = first;
+    dirty->last[page_addr] = last;
+    return;
+  }
+
+  if (first < dirty->first[page_addr]) {
+    dirty->first[page_addr] = first;
+  }
+  if (last > dirty->last[page_addr]) {
+    dirty->last[page_addr] = last;
+  }
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_init(struct sh1106_framebuffer *framebuffer, uint8_t *pixels, uint8_t pages) {
+  framebuffer->pixels = pixels;
+  framebuffer->pages = pages;
+  framebuffer->origin_x = 0;
+  framebuffer->origin_y = 0;
+  framebuffer->clip_x0 = 0;
+  framebuffer->clip_y0 = 0;
+  framebuffer->clip_x1 = SH1106_COLUMNS;
+  framebuffer->clip_y1 = (uint8_t) (pages * 8);
+
+  memset(pixels, 0x00, SH1106_FRAMEBUFFER_SIZE(pages));
+  sh1106_dirty_reset(&framebuffer->dirty);
+  sh1106_framebuffer_invalidate(framebuffer);
+}
+
+static inline uint8_t sh1106_framebuffer_clamp(int16_t value, uint8_t min, uint8_t max) {
+  return value < min ? min : (value > max ? max : (uint8_t) value);
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_window_init(struct sh1106_framebuffer *window,
+                        const struct sh1106_framebuffer *screen,
+                        int16_t x,
+                        int16_t y,
+                        int16_t width,
+                        int16_t height) {
+  window->pixels = screen->pixels;
+  window->pages = screen->pages;
+  window->origin_x = x;
+  window->origin_y = y;
+  window->clip_x0 = sh1106_framebuffer_clamp(x, screen->clip_x0, screen->clip_x1);
+  window->clip_y0 = sh1106_framebuffer_clamp(y, screen->clip_y0, screen->clip_y1);
+  window->clip_x1 = sh1106_framebuffer_clamp((int16_t) (x + width), window->clip_x0, screen->clip_x1);
+  window->clip_y1 = sh1106_framebuffer_clamp((int16_t) (y + height), window->clip_y0, screen->clip_y1);
+  sh1106_dirty_reset(&window->dirty);
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_invalidate(struct sh1106_framebuffer *framebuffer) {
+  uint8_t page_addr;
+
+  if (framebuffer->clip_x0 >= framebuffer->clip_x1 || framebuffer->clip_y0 >= framebuffer->clip_y1) {
+    return;
+  }
+
+  for (page_addr = framebuffer->clip_y0 / 8; page_addr <= (framebuffer->clip_y1 - 1) / 8; page_addr++) {
+    sh1106_dirty_mark(&framebuffer->dirty, page_addr, framebuffer->clip_x0, (uint8_t) (framebuffer->clip_x1 - 1));
+  }
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_clear(struct sh1106_framebuffer *framebuffer) {
+  sh1106_framebuffer_fill_rect(framebuffer,
+                               (int16_t) (framebuffer->clip_x0 - framebuffer->origin_x),
+                               (int16_t) (framebuffer->clip_y0 - framebuffer->origin_y),
+                               (int16_t) (framebuffer->clip_x1 - framebuffer->clip_x0),
+                               (int16_t) (framebuffer->clip_y1 - framebuffer->clip_y0),
+                               0);
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_set_pixel(struct sh1106_framebuffer *framebuffer, int16_t x, int16_t y, uint8_t on) {
+  uint8_t *pixel;
+
+  x = (int16_t) (x + framebuffer->origin_x);
+  y = (int16_t) (y + framebuffer->origin_y);
+  if (x < framebuffer->clip_x0 || x >= framebuffer->clip_x1 || y < framebuffer->clip_y0 || y >= framebuffer->clip_y1) {
+    return;
+  }
+
+  pixel = &framebuffer->pixels[(y >> 3) * SH1106_COLUMNS + x];
+  if (on) {
+    *pixel |= (uint8_t) (1 << (y & 0x07));
+  } else {
+    *pixel &= (uint8_t) ~(1 << (y & 0x07));
+  }
+  sh1106_dirty_mark(&framebuffer->dirty, (uint8_t) (y >> 3), (uint8_t) x, (uint8_t) x);
+}
+
+SH1106_FRAMEBUFFER_API
+uint8_t sh1106_framebuffer_get_pixel(const struct sh1106_framebuffer *framebuffer, int16_t x, int16_t y) {
+  x = (int16_t) (x + framebuffer->origin_x);
+  y = (int16_t) (y + framebuffer->origin_y);
+  if (x < framebuffer->clip_x0 || x >= framebuffer->clip_x1 || y < framebuffer->clip_y0 || y >= framebuffer->clip_y1) {
+    return 0;
+  }
+
+  return (uint8_t) ((framebuffer->pixels[(y >> 3) * SH1106_COLUMNS + x] >> (y & 0x07)) & 0x01);
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_framebuffer_fill_rect(struct sh1106_framebuffer *framebuffer,
+                                  int16_t x,
+                                  int16_t y,
+                                  int16_t width,
+                                  int16_t height,
+                                  uint8_t on) {
+  uint8_t x0;
+  uint8_t x1;
+  uint8_t y0;
+  uint8_t y1;
+  uint8_t page_addr;
+
+  x = (int16_t) (x + framebuffer->origin_x);
+  y = (int16_t) (y + framebuffer->origin_y);
+  x0 = sh1106_framebuffer_clamp(x, framebuffer->clip_x0, framebuffer->clip_x1);
+  x1 = sh1106_framebuffer_clamp((int16_t) (x + width), x0, framebuffer->clip_x1);
+  y0 = sh1106_framebuffer_clamp(y, framebuffer->clip_y0, framebuffer->clip_y1);
+  y1 = sh1106_framebuffer_clamp((int16_t) (y + height), y0, framebuffer->clip_y1);
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+
+  for (page_addr = y0 / 8; page_addr <= (y1 - 1) / 8; page_addr++) {
+    uint8_t top = (uint8_t) (page_addr * 8);
+    uint8_t mask = 0xFF;
+    uint8_t *pixel = &framebuffer->pixels[page_addr * SH1106_COLUMNS + x0];
+    uint8_t *end = pixel + (x1 - x0);
+
+    if (y0 > top) {
+      mask &= (uint8_t) (0xFF << (y0 - top));
+    }
+    if (y1 < top + 8) {
+      mask &= (uint8_t) (0xFF >> (top + 8 - y1));
+    }
+
+    if (on) {
+      for (; pixel < end; pixel++) {
+        *pixel |= mask;
+      }
+    } else {
+      for (; pixel < end; pixel++) {
+        *pixel &= (uint8_t) ~mask;
+      }
+    }
+    sh1106_dirty_mark(&framebuffer->dirty, page_addr, x0, (uint8_t) (x1 - 1));
+  }
+}
+
+SH1106_FRAMEBUFFER_API
+void sh1106_write_span(const sh1106_send8_cmd_t send8_cmd,
+                       const sh1106_send8_data_t send8_data,
+                       uint8_t page_addr,
+                       uint8_t column_addr,
+                       const uint8_t *data,
+                       uint16_t size) {
+  const uint8_t *end = data + size;
+
+  sh1106_set_page_address(send8_cmd, page_addr);
+  sh1106_set_column_address(send8_cmd, column_addr);
+  for (; data < end; data++) {
+    sh1106_write_display_data(send8_data, *data);
+  }
+}
+
+SH1106_FRAMEBUFFER_API
+uint16_t sh1106_framebuffer_flush(const sh1106_send8_cmd_t send8_cmd,
+                                  const sh1106_send8_data_t send8_data,
+                                  struct sh1106_framebuffer *framebuffer) {
+  return sh1106_framebuffer_flush_at(send8_cmd, send8_data, framebuffer, 0);
+}
+
+SH1106_FRAMEBUFFER_API
+uint16_t sh1106_framebuffer_flush_at(const sh1106_send8_cmd_t send8_cmd,
+                                     const sh1106_send8_data_t send8_data,
+                                     struct sh1106_framebuffer *framebuffer,
+                                     uint8_t page_offset) {
+  uint16_t sent = 0;
+  uint8_t page_addr;
+
+  for (page_addr = 0; page_addr < framebuffer->pages; page_addr++) {
+    uint8_t first = framebuffer->dirty.first[page_addr];
+    uint16_t size;
+
+    if (!(framebuffer->dirty.pages & (1 << page_addr))) {
+      continue;
+    }
+
+    size = (uint16_t) (framebuffer->dirty.last[page_addr] - first + 1);
+    sh1106_write_span(send8_cmd,
+                      send8_data,
+                      (uint8_t) (page_offset + page_addr),
+                      first,
+                      &framebuffer->pixels[page_addr * SH1106_COLUMNS + first],
+                      size);
+    sent = (uint16_t) (sent + size);
+  }
+
+  sh1106_dirty_reset(&framebuffer->dirty);
+  return sent;
+}
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_FRAMEBUFFER_IMPL_H
@@ -0,0 +1,126 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_HASH_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_HASH_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @def SH1106_HASH_CHUNK_COLUMNS
+ *
+ * Number of columns covered by one chunk hash.
+ */
+#define SH1106_HASH_CHUNK_COLUMNS 16
+
+/**
+ * @def SH1106_HASH_CHUNKS
+ *
+ * Number of chunk hashes per page.
+ */
+#define SH1106_HASH_CHUNKS ((SH1106_COLUMNS + SH1106_HASH_CHUNK_COLUMNS - 1) / SH1106_HASH_CHUNK_COLUMNS)
+
+/**
+ * @brief Hashes of the pages last sent to display RAM (36 bytes).
+ */
+struct sh1106_page_hashes {
+  uint32_t pages[SH1106_PAGES];
+  /** Pages whose hash is known, bit N selects page N */
+  uint8_t valid;
+};
+
+/**
+ * @brief Hashes of the 16 column chunks last sent to display RAM (292 bytes).
+ */
+struct sh1106_chunk_hashes {
+  uint32_t chunks[SH1106_PAGES][SH1106_HASH_CHUNKS];
+  /** Pages whose hashes are known, bit N selects page N */
+  uint8_t valid;
+};
+
+/**
+ * @brief Hash a span of pixels.
+ *
+ * Mixes the span 32 bits at a time. Used to detect changed pages without a shadow copy of display RAM; equal hashes
+ * of different content (probability about 2^-32) leave a stale page until it changes again.
+ *
+ * @param[in] pixels Pixels
+ * @param[in] size Number of bytes
+ *
+ * @return 32 bit hash
+ */
+uint32_t sh1106_hash(const uint8_t *pixels, uint16_t size);
+
+/**
+ * @brief Forget page hashes.
+ *
+ * The next flush sends every page, e.g. after display RAM was lost.
+ *
+ * @param[out] hashes Page hashes
+ */
+void sh1106_page_hashes_reset(struct sh1106_page_hashes *hashes);
+
+/**
+ * @brief Forget chunk hashes.
+ *
+ * @param[out] hashes Chunk hashes
+ */
+void sh1106_chunk_hashes_reset(struct sh1106_chunk_hashes *hashes);
+
+/**
+ * @brief Flush pages whose content changed.
+ *
+ * Hashes the columns of the clip rectangle of every page it covers at flush time and sends them only if the hash
+ * differs from the one last sent, so a window sends only its rectangle like sh1106_framebuffer_flush(). The hashes
+ * replace the dirty set, which is not read and is cleared. Keep one set of hashes per framebuffer or window.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] framebuffer Framebuffer
+ * @param[in,out] hashes Hashes of the pages in display RAM
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_framebuffer_flush_hashed(const sh1106_send8_cmd_t send8_cmd,
+                                         const sh1106_send8_data_t send8_data,
+                                         struct sh1106_framebuffer *framebuffer,
+                                         struct sh1106_page_hashes *hashes);
+
+/**
+ * @brief Flush 16 column chunks whose content changed.
+ *
+ * Like sh1106_framebuffer_flush_hashed() with finer granularity: every run of changed chunks, cut to the clip
+ * rectangle, is sent as one span with its own page and column address.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] framebuffer Framebuffer
+ * @param[in,out] hashes Hashes of the chunks in display RAM
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_framebuffer_flush_hashed_chunks(const sh1106_send8_cmd_t send8_cmd,
+                                                const sh1106_send8_data_t send8_data,
+                                                struct sh1106_framebuffer *framebuffer,
+                                                struct sh1106_chunk_hashes *hashes);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_HASH_H
@@ -0,0 +1,110 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_IMAGE_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * Compressed page-major image.
+ *
+ * The image is stored in the display RAM order: page by page, column by column, one byte holds 8 vertical pixels of a
+ * page (LSB is the top line). The stream starts with a 2 byte header followed by tokens:
+ *
+ * +-----------+-----------------------------------+--------------------------------------------------+
+ * |    Header | width, pages                      | Size in columns (1 - 132) and pages (1 - 8)      |
+ * +-----------+-----------------------------------+--------------------------------------------------+
+ * | 0x00-0x3F | LITERAL n = (t & 0x3F) + 1, b...  | n bytes copied as is                             |
+ * | 0x40-0x7F | ZERO    n = (t & 0x3F) + 1        | n bytes of 0x00                                  |
+ * | 0x80-0x9F | FILL    n = (t & 0x1F) + 2, b     | n bytes of b                                     |
+ * | 0xA0-0xFF | COPY    n = t - 0xA0 + 3, d       | n bytes copied from d + 1 bytes back (LZ)        |
+ * +-----------+-----------------------------------+--------------------------------------------------+
+ *
+ * A COPY reaches at most 256 bytes back, which covers the same columns of the previous page, so the decoder needs a
+ * constant 256 byte window instead of a framebuffer. Tokens may span page boundaries.
+ */
+
+/**
+ * @def SH1106_IMAGE_HEADER_SIZE
+ *
+ * Size of the compressed image header in bytes.
+ */
+#define SH1106_IMAGE_HEADER_SIZE 2
+
+/**
+ * @def SH1106_IMAGE_WINDOW_SIZE
+ *
+ * Size of the decoder history window in bytes. A COPY token can not reach further back.
+ */
+#define SH1106_IMAGE_WINDOW_SIZE 256
+
+#define SH1106_IMAGE_LITERAL 0x00
+#define SH1106_IMAGE_LITERAL_MAX 64
+#define SH1106_IMAGE_ZERO 0x40
+#define SH1106_IMAGE_ZERO_MAX 64
+#define SH1106_IMAGE_FILL 0x80
+#define SH1106_IMAGE_FILL_MIN 2
+#define SH1106_IMAGE_FILL_MAX 33
+#define SH1106_IMAGE_COPY 0xA0
+#define SH1106_IMAGE_COPY_MIN 3
+#define SH1106_IMAGE_COPY_MAX 98
+
+/**
+ * @brief Draw compressed image.
+ *
+ * Decodes the image and streams it directly to display RAM: every page is addressed with sh1106_set_page_address()
+ * and sh1106_set_column_address() and followed by `width` calls to sh1106_write_display_data(). Only the 256 byte
+ * history window is kept in RAM.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] image Compressed image
+ * @param[in] size Size of the compressed image in bytes
+ * @param[in] column_addr Column address of the left edge of the image
+ * @param[in] page_addr Page address of the top edge of the image
+ *
+ * @return 0 on success, -1 if the image is malformed or does not fit into display RAM
+ */
+int sh1106_draw_image(const sh1106_send8_cmd_t send8_cmd,
+                      const sh1106_send8_data_t send8_data,
+                      const uint8_t *image,
+                      size_t size,
+                      uint8_t column_addr,
+                      uint8_t page_addr);
+
+/**
+ * @brief Compress image.
+ *
+ * Host side encoder. Picks the cheapest of ZERO, FILL and COPY tokens at every position and falls back to LITERAL.
+ *
+ * @param[in] pixels Page-major image, width * pages bytes
+ * @param[in] width Image width in columns (1 - 132)
+ * @param[in] pages Image height in pages (1 - 8)
+ * @param[out] image Compressed image
+ * @param[in] size Size of the output buffer in bytes
+ *
+ * @return Size of the compressed image in bytes, 0 if the output buffer is too small or the geometry is invalid
+ */
+size_t sh1106_encode_image(const uint8_t *pixels, uint8_t width, uint8_t pages, uint8_t *image, size_t size);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_IMAGE_H
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_ORIENTATION_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_ORIENTATION_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * @brief Display orientation.
+ *
+ * 0/180 degrees and mirroring are done by the controller for free. Portrait orientations (90/270 degrees) need the
+ * frame to be transposed in software with sh1106_transpose_region(), the mirroring half of the rotation is still done
+ * by the controller. Angles are those of the mounted module turned clockwise, so the frame is shown upright.
+ */
+enum sh1106_orientation {
+  /** Landscape (POR) */
+      SH1106_ORIENTATION_0,
+  /** Portrait, module turned 90 degrees clockwise: portrait pixel (x, y) lights segment y of COM line 63 - x */
+      SH1106_ORIENTATION_90,
+  /** Landscape, rotated 180 degrees */
+      SH1106_ORIENTATION_180,
+  /** Portrait, module turned 270 degrees clockwise: portrait pixel (x, y) lights segment 131 - y of COM line x */
+      SH1106_ORIENTATION_270,
+  /** Landscape, mirrored left to right */
+      SH1106_ORIENTATION_MIRROR_HORIZONTAL,
+  /** Landscape, mirrored top to bottom */
+      SH1106_ORIENTATION_MIRROR_VERTICAL,
+};
+
+/**
+ * @brief Set display orientation.
+ *
+ * Programs sh1106_set_segment_re_map() and sh1106_set_common_output_scan_direction(). The controller takes effect
+ * immediately, display RAM does not have to be rewritten for 0/180 degrees and mirroring.
+ *
+ * +-------------------+-------------------+-------------------+------------+
+ * |       Orientation |    Segment re-map |    COM scan dir.  | Transpose  |
+ * +-------------------+-------------------+-------------------+------------+
+ * |                 0 |            normal |            normal |         no |
+ * |                90 |            normal |           flipped |        yes |
+ * |               180 |           reverse |           flipped |         no |
+ * |               270 |           reverse |            normal |        yes |
+ * | mirror horizontal |           reverse |            normal |         no |
+ * |   mirror vertical |            normal |           flipped |         no |
+ * +-------------------+-------------------+-------------------+------------+
+ *
+ * Note that the reversed segment re-map mirrors all 132 columns, modules which show columns 2 - 129 keep the same
+ * visible window.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] orientation Display orientation
+ */
+void sh1106_set_orientation(const sh1106_send8_cmd_t send8_cmd, enum sh1106_orientation orientation);
+
+/**
+ * @brief Check whether orientation needs a software transpose.
+ *
+ * @param[in] orientation Display orientation
+ *
+ * @return Non-zero for portrait orientations (90/270 degrees)
+ */
+int sh1106_orientation_is_portrait(enum sh1106_orientation orientation);
+
+/**
+ * @brief Transpose 8x8 pixel block.
+ *
+ * Swaps lines and columns of a page-major 8x8 block (8 column bytes, LSB is the top line). The block is transposed as
+ * a single 64 bit word in three mask-and-shift steps instead of 64 single pixel moves.
+ *
+ * @param[in] src Source block, 8 bytes
+ * @param[out] dst Transposed block, 8 bytes
+ */
+void sh1106_transpose_block(const uint8_t *src, uint8_t *dst);
+
+/**
+ * @brief Transpose region of a portrait frame into display RAM layout.
+ *
+ * Both frames are page-major. A source pixel (x, y) ends up at (y, x) in the destination, the controller mirrors the
+ * result according to sh1106_set_orientation(). The region is rounded out to 8x8 blocks, so call it once per dirty
+ * region rather than per pixel. Source column block N becomes destination page N, source page M becomes destination
+ * columns 8 * M to 8 * M + 7. The portrait frame is at most SH1106_PAGES * 8 columns wide, its columns become the
+ * lines of display RAM.
+ *
+ * @param[in] src Portrait frame
+ * @param[in] src_width Width of the portrait frame in columns
+ * @param[out] dst Landscape frame
+ * @param[in] dst_width Width of the landscape frame in columns
+ * @param[in] column Left column of the region in the portrait frame
+ * @param[in] page Top page of the region in the portrait frame
+ * @param[in] columns Width of the region in columns
+ * @param[in] pages Height of the region in pages
+ *
+ * @return 0 on success, -1 if the portrait frame is wider than SH1106_PAGES * 8 columns, or the rounded out region
+ *         lies outside of the portrait frame or of the destination width
+ */
+int sh1106_transpose_region(const uint8_t *src,
+                            uint16_t src_width,
+                            uint8_t *dst,
+                            uint16_t dst_width,
+                            uint16_t column,
+                            uint16_t page,
+                            uint16_t columns,
+                            uint16_t pages);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_ORIENTATION_H
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_PACER_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_PACER_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * @brief Frame pacing metrics.
+ */
+struct sh1106_pacer_metrics {
+  /** Number of calls to sh1106_pacer_invalidate() */
+  uint32_t invalidations;
+  /** Number of flushes granted by sh1106_pacer_poll() */
+  uint32_t flushes;
+  /** Number of flushes that carried more than one invalidation */
+  uint32_t merged;
+  /** Number of intermediate frames that were superseded before they reached the display */
+  uint32_t dropped;
+};
+
+/**
+ * @brief Frame pacer.
+ *
+ * Coalesces bursts of invalidations into at most one flush per frame period (latest-wins). Every invalidation since
+ * the last flush is merged into the page mask returned by the next sh1106_pacer_poll(), so a redraw never waits more
+ * than one frame period for the bus. Flushes that had to wait keep a steady cadence, the others start a new frame
+ * period, so a pacer polled every tick never grants two flushes less than a frame period apart. The pacer does not
+ * read a clock itself, the caller passes the current time in ticks of any monotonic clock (e.g. microseconds or a
+ * simulated clock in tests).
+ */
+struct sh1106_pacer {
+  /** Minimal number of ticks between two flushes */
+  uint32_t frame_period;
+  /** Time of the last flush in ticks */
+  uint32_t last_flush;
+  /** Pages invalidated since the last flush */
+  uint8_t dirty_pages;
+  /** Number of invalidations since the last flush */
+  uint32_t pending;
+  /** Non-zero until the first flush is granted */
+  uint8_t idle;
+  /** Non-zero while invalidations wait for the frame period to end */
+  uint8_t waiting;
+  /** Pacing metrics */
+  struct sh1106_pacer_metrics metrics;
+};
+
+/**
+ * @brief Initialize frame pacer.
+ *
+ * @param[out] pacer Frame pacer to be initialized
+ * @param[in] ticks_per_second Resolution of the clock passed to sh1106_pacer_poll()
+ * @param[in] target_fps Target frame rate, 0 disables pacing (every poll with pending invalidations flushes)
+ */
+void sh1106_pacer_init(struct sh1106_pacer *pacer, uint32_t ticks_per_second, uint16_t target_fps);
+
+/**
+ * @brief Invalidate pages.
+ *
+ * Marks pages as changed. The invalidation is merged with every other invalidation since the last flush.
+ *
+ * @param[in,out] pacer Frame pacer
+ * @param[in] page_mask Pages to be invalidated, bit N selects page N
+ */
+void sh1106_pacer_invalidate(struct sh1106_pacer *pacer, uint8_t page_mask);
+
+/**
+ * @brief Poll frame pacer.
+ *
+ * Returns the pages to be flushed now. When it returns a non-zero mask the caller must flush those pages before the
+ * next call, the pending invalidations are consumed and the frame period restarts.
+ *
+ * @param[in,out] pacer Frame pacer
+ * @param[in] now Current time in ticks
+ *
+ * @return Page mask to be flushed, 0 if nothing is due
+ */
+uint8_t sh1106_pacer_poll(struct sh1106_pacer *pacer, uint32_t now);
+
+/**
+ * @brief Time until the next flush is due.
+ *
+ * Can be used to sleep until the next call to sh1106_pacer_poll().
+ *
+ * @param[in] pacer Frame pacer
+ * @param[in] now Current time in ticks
+ *
+ * @return Number of ticks until the pending invalidations may be flushed, 0 if a flush is due now and UINT32_MAX if
+ *         nothing is pending
+ */
+uint32_t sh1106_pacer_time_until_due(const struct sh1106_pacer *pacer, uint32_t now);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_PACER_H
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_PARALLEL_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_PARALLEL_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_strip.h"
+#include "sh1106_tiled.h"
+
+/**
+ * @def SH1106_PARALLEL_MAX_WORKERS
+ *
+ * Maximal number of worker threads.
+ */
+#define SH1106_PARALLEL_MAX_WORKERS 8
+
+/**
+ * @brief Page-parallel render executor.
+ *
+ * Splits a frame into page bands, one per worker. A worker renders the pages of its band front to back and steals
+ * from the back of the largest remaining band when its own is empty. Every page is rasterized into its own slice of
+ * the framebuffer, so drawing needs no locks; the mutex only guards the page queues. The calling thread flushes page
+ * K as soon as it is done, while the workers keep rendering the following pages.
+ *
+ * Requires POSIX threads, the module is built with the SH1106_PARALLEL CMake option.
+ */
+struct sh1106_parallel {
+  /** Worker threads */
+  struct sh1106_parallel_worker {
+    struct sh1106_parallel *parallel;
+    pthread_t thread;
+    uint8_t index;
+  } threads[SH1106_PARALLEL_MAX_WORKERS];
+  /** Number of worker threads */
+  uint8_t workers;
+  /** Guards the page queues and frame state */
+  pthread_mutex_t mutex;
+  /** Signalled when a frame is started or the executor is destroyed */
+  pthread_cond_t work;
+  /** Signalled when a page is done */
+  pthread_cond_t done;
+  /** Pages of the current frame */
+  uint8_t pages[SH1106_PAGES];
+  /** Next page of every band, index into pages */
+  uint8_t next[SH1106_PARALLEL_MAX_WORKERS];
+  /** End of every band (exclusive), index into pages */
+  uint8_t end[SH1106_PARALLEL_MAX_WORKERS];
+  /** Pages rendered in the current frame */
+  uint8_t rendered;
+  /** Pages reported as changed in the current frame */
+  uint8_t changed;
+  /** Frame generation, incremented for every frame */
+  uint32_t frame;
+  /** Non-zero when the executor is being destroyed */
+  uint8_t stop;
+  sh1106_strip_draw_t draw;
+  void *context;
+  uint8_t *pixels;
+};
+
+/**
+ * @brief Start worker threads.
+ *
+ * @param[out] parallel Executor
+ * @param[in] workers Number of worker threads (1 - SH1106_PARALLEL_MAX_WORKERS)
+ *
+ * @return 0 on success, -1 if the threads can not be created
+ */
+int sh1106_parallel_init(struct sh1106_parallel *parallel, uint8_t workers);
+
+/**
+ * @brief Stop worker threads.
+ *
+ * @param[in,out] parallel Executor
+ */
+void sh1106_parallel_destroy(struct sh1106_parallel *parallel);
+
+/**
+ * @brief Render and flush a frame.
+ *
+ * The draw callback is called from the worker threads, once per page with the cleared page slice of the framebuffer
+ * (see sh1106_strip_draw_t), and must be safe to run concurrently for different pages. Pages reported as changed are
+ * sent in page order from the calling thread as soon as they are done.
+ *
+ * @param[in,out] parallel Executor
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] draw Draw callback
+ * @param[in] context Application context passed to the draw callback
+ * @param[out] pixels Page-major framebuffer, SH1106_PAGES * SH1106_COLUMNS bytes
+ * @param[in] page_mask Pages to be rendered, bit N selects page N
+ *
+ * @return Mask of pages that were sent
+ */
+uint8_t sh1106_parallel_render(struct sh1106_parallel *parallel,
+                               const sh1106_send8_cmd_t send8_cmd,
+                               const sh1106_send8_data_t send8_data,
+                               sh1106_strip_draw_t draw,
+                               void *context,
+                               uint8_t *pixels,
+                               uint8_t page_mask);
+
+/**
+ * @brief Flush dirty panels of a tiled canvas, one thread per bus.
+ *
+ * Panels on the same bus are sent one after another, the buses are sent at the same time. The calling thread sends
+ * the bus of the first dirty panel and waits for the others.
+ *
+ * @param[in,out] tiled Tiled canvas
+ *
+ * @return Mask of panels that were sent, bit N selects panel N
+ */
+uint8_t sh1106_parallel_flush_tiled(struct sh1106_tiled *tiled);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_PARALLEL_H
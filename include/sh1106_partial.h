@@ -0,0 +1,143 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_PARTIAL_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_PARTIAL_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @def SH1106_LINES
+ *
+ * Number of COM lines of the controller.
+ */
+#define SH1106_LINES (SH1106_PAGES * 8)
+
+/**
+ * @def SH1106_CLOCKS_PER_ROW_POR
+ *
+ * Display clocks (DCLKs) per row after reset: pre-charge phases of 2 DCLKs each and 50 DCLKs of current drive.
+ */
+#define SH1106_CLOCKS_PER_ROW_POR 54
+
+/**
+ * @brief Partial display.
+ *
+ * Drives only a band of whole pages: the multiplex ratio is reduced to the lines of the band, the display offset
+ * moves the band to its COM lines and the start line selects the display RAM pages it shows. The framebuffer holds
+ * just the pages of the band, so RAM, dirty tracking and flushes shrink with it and the frame rate grows with the
+ * inverse of the multiplex ratio.
+ */
+struct sh1106_partial {
+  /** First display RAM page shown */
+  uint8_t ram_page;
+  /** Number of pages shown (1 - 8) */
+  uint8_t pages;
+  /** COM line of the top line of the band (0 - 63) */
+  uint8_t com_line;
+};
+
+/**
+ * @brief Initialize partial display.
+ *
+ * Values are clamped to the 8 pages of display RAM and the 64 COM lines.
+ *
+ * @param[out] partial Partial display
+ * @param[in] ram_page First display RAM page shown
+ * @param[in] pages Number of pages shown (1 - 8)
+ * @param[in] com_line COM line of the top line of the band, e.g. 0 for a 128x32 module
+ */
+void sh1106_partial_init(struct sh1106_partial *partial, uint8_t ram_page, uint8_t pages, uint8_t com_line);
+
+/**
+ * @brief Switch to partial display.
+ *
+ * Sends sh1106_set_multiplex_ration(), sh1106_set_display_offset() and sh1106_set_display_start_line() together.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] partial Partial display
+ */
+void sh1106_set_partial_display(const sh1106_send8_cmd_t send8_cmd, const struct sh1106_partial *partial);
+
+/**
+ * @brief Switch back to all 64 lines, with no display offset and start line 0.
+ *
+ * @param[in] send8_cmd Command transport
+ */
+void sh1106_set_full_display(const sh1106_send8_cmd_t send8_cmd);
+
+/**
+ * @brief Initialize framebuffer of partial display.
+ *
+ * @param[in] partial Partial display
+ * @param[out] framebuffer Framebuffer, local line 0 is the top line of the band
+ * @param[in] pixels Pixel storage, SH1106_FRAMEBUFFER_SIZE(partial->pages) bytes
+ */
+void sh1106_partial_framebuffer_init(const struct sh1106_partial *partial,
+                                     struct sh1106_framebuffer *framebuffer,
+                                     uint8_t *pixels);
+
+/**
+ * @brief Flush dirty set of partial display.
+ *
+ * Like sh1106_framebuffer_flush(), page N of the framebuffer is sent to display RAM page ram_page + N.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] partial Partial display
+ * @param[in,out] framebuffer Framebuffer of the partial display
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_partial_flush(const sh1106_send8_cmd_t send8_cmd,
+                              const sh1106_send8_data_t send8_data,
+                              const struct sh1106_partial *partial,
+                              struct sh1106_framebuffer *framebuffer);
+
+/**
+ * @brief Frame rate of the panel.
+ *
+ * Frame frequency = ƒOSC / (D * K * MUX), where D is the clock divide ratio, K the display clocks per row and MUX the
+ * number of driven lines.
+ *
+ * @param[in] oscillator_frequency Oscillator frequency in Hz
+ * @param[in] clock_divide_ratio Clock divide ratio (1 - 16)
+ * @param[in] clocks_per_row Display clocks per row, SH1106_CLOCKS_PER_ROW_POR after reset
+ * @param[in] lines Number of driven lines (1 - 64)
+ *
+ * @return Frame rate in 1/100 Hz
+ */
+uint32_t sh1106_frame_rate(uint32_t oscillator_frequency,
+                           uint8_t clock_divide_ratio,
+                           uint8_t clocks_per_row,
+                           uint8_t lines);
+
+/**
+ * @brief Frame rate gain of partial display over all 64 lines.
+ *
+ * @param[in] partial Partial display
+ *
+ * @return Frame rate gain in 1/100, e.g. 200 for 32 lines
+ */
+uint16_t sh1106_partial_frame_rate_gain(const struct sh1106_partial *partial);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_PARTIAL_H
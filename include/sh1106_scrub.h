@@ -0,0 +1,164 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_SCRUB_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_SCRUB_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @def SH1106_SCRUB_REGISTERS
+ *
+ * Number of registers re-sent by the scrubber.
+ */
+#define SH1106_SCRUB_REGISTERS 5
+
+/**
+ * @def SH1106_SCRUB_MIN_BUDGET
+ *
+ * Smallest byte budget, a page address, a column address and one data byte.
+ */
+#define SH1106_SCRUB_MIN_BUDGET 4
+
+/**
+ * @brief Configured registers.
+ *
+ * Keep it in sync when the application changes these registers, the scrubber sends what it holds.
+ */
+struct sh1106_registers {
+  /** Contrast step */
+  uint8_t contrast;
+  /** Segment re-map */
+  enum sh1106_segment_re_map_direction segment_re_map;
+  /** Common output scan direction */
+  enum sh1106_common_output_scan_direction common_output_scan_direction;
+  /** Multiplex ratio (number of lines - 1) */
+  uint8_t multiplex_ratio;
+  /** DC-DC mode */
+  enum sh1106_dc_dc_mode dc_dc_mode;
+};
+
+/**
+ * @brief Scrubber metrics.
+ */
+struct sh1106_scrub_metrics {
+  /** Number of full refreshes */
+  uint32_t cycles;
+  /** Number of full refreshes not finished by the second poll at or after the end of the period */
+  uint32_t overruns;
+  /** Ticks the last full refresh took */
+  uint32_t last_cycle;
+  /** Number of bytes sent (commands and data) */
+  uint32_t bytes;
+  /** Most bytes sent by a single poll, never above the budget */
+  uint16_t max_poll;
+};
+
+/**
+ * @brief Background display RAM and register scrubber.
+ *
+ * Re-sends the configured registers and the display RAM of a framebuffer round-robin, so corruption from ESD or
+ * supply glitches does not outlive one period even though flushes only send dirty regions. The refresh is spread
+ * evenly over the period: a poll sends only what is due at the given time, in chunks of up to the byte budget, and
+ * never more than the budget. The caller passes the current time in ticks of any monotonic clock.
+ */
+struct sh1106_scrub {
+  /** Registers */
+  const struct sh1106_registers *registers;
+  /** Framebuffer with the display RAM, from page 0 and column 0 */
+  const struct sh1106_framebuffer *framebuffer;
+  /** Ticks per full refresh */
+  uint32_t period;
+  /** Bytes per poll */
+  uint16_t budget;
+  /** Time the current refresh started in ticks */
+  uint32_t start;
+  /** Position in the current refresh: registers, then display RAM bytes */
+  uint16_t position;
+  /** Number of polls that found the current refresh due and could not finish it */
+  uint8_t late;
+  /** Scrubber metrics */
+  struct sh1106_scrub_metrics metrics;
+};
+
+/**
+ * @brief Initialize registers to their POR values.
+ *
+ * @param[out] registers Registers
+ */
+void sh1106_registers_init(struct sh1106_registers *registers);
+
+/**
+ * @brief Send registers.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] registers Registers
+ */
+void sh1106_registers_send(const sh1106_send8_cmd_t send8_cmd, const struct sh1106_registers *registers);
+
+/**
+ * @brief Initialize scrubber.
+ *
+ * @param[out] scrub Scrubber
+ * @param[in] registers Registers, must stay valid
+ * @param[in] framebuffer Framebuffer, must stay valid
+ * @param[in] now Current time in ticks
+ * @param[in] period Ticks per full refresh
+ * @param[in] budget Bytes per poll, at least SH1106_SCRUB_MIN_BUDGET
+ */
+void sh1106_scrub_init(struct sh1106_scrub *scrub,
+                       const struct sh1106_registers *registers,
+                       const struct sh1106_framebuffer *framebuffer,
+                       uint32_t now,
+                       uint32_t period,
+                       uint16_t budget);
+
+/**
+ * @brief Send what is due.
+ *
+ * Call it when the bus is idle, e.g. after the foreground flush of a frame. A full refresh finishes with the first or
+ * second poll at or after the end of its period. One that falls further behind, because the budget is too small for
+ * the polls, is counted as an overrun. The next refresh keeps the cadence of the period, unless the scrubber is more
+ * than a whole period behind, then it starts right away.
+ *
+ * @param[in,out] scrub Scrubber
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] now Current time in ticks
+ *
+ * @return Number of bytes sent (commands and data)
+ */
+uint16_t sh1106_scrub_poll(struct sh1106_scrub *scrub,
+                           const sh1106_send8_cmd_t send8_cmd,
+                           const sh1106_send8_data_t send8_data,
+                           uint32_t now);
+
+/**
+ * @brief Coverage of the current refresh.
+ *
+ * @param[in] scrub Scrubber
+ *
+ * @return Part of registers and display RAM re-sent since the current refresh started, in 1/100 percent
+ */
+uint16_t sh1106_scrub_coverage(const struct sh1106_scrub *scrub);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_SCRUB_H
@@ -0,0 +1,162 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_SPARSE_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_SPARSE_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @def SH1106_SPARSE_OCCUPANCY_SIZE
+ *
+ * Size of the column occupancy bitmap of a page in bytes.
+ */
+#define SH1106_SPARSE_OCCUPANCY_SIZE ((SH1106_COLUMNS + 7) / 8)
+
+/**
+ * @brief Sparse framebuffer.
+ *
+ * Stores only the non-zero column bytes. Every page has a column occupancy bitmap, the bytes of the occupied columns
+ * are packed in page and column order into a caller supplied pool, so RAM grows with the content instead of being
+ * 1056 bytes. A second bitmap remembers which columns are lit in display RAM: a flush sends the occupied columns
+ * and the columns to be blanked, and skips columns known to be blank on both sides.
+ */
+struct sh1106_sparse {
+  /** Packed bytes of the occupied columns */
+  uint8_t *bytes;
+  /** Size of the pool in bytes */
+  uint16_t capacity;
+  /** Number of occupied columns */
+  uint16_t size;
+  /** Number of occupied columns of every page */
+  uint8_t counts[SH1106_PAGES];
+  /** Occupied columns, bit N of byte M selects column 8 * M + N */
+  uint8_t occupied[SH1106_PAGES][SH1106_SPARSE_OCCUPANCY_SIZE];
+  /** Columns that may be lit in display RAM */
+  uint8_t shown[SH1106_PAGES][SH1106_SPARSE_OCCUPANCY_SIZE];
+  /** Dirty set */
+  struct sh1106_dirty dirty;
+};
+
+/**
+ * @brief Initialize sparse framebuffer.
+ *
+ * The framebuffer is blank. Display RAM is unknown, so the first flush blanks the whole display.
+ *
+ * @param[out] sparse Sparse framebuffer
+ * @param[in] bytes Pool for the occupied columns
+ * @param[in] capacity Size of the pool in bytes, at most SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES) are used
+ */
+void sh1106_sparse_init(struct sh1106_sparse *sparse, uint8_t *bytes, uint16_t capacity);
+
+/**
+ * @brief Clear sparse framebuffer.
+ *
+ * Takes time in the number of occupied columns instead of the size of the screen.
+ *
+ * @param[in,out] sparse Sparse framebuffer
+ */
+void sh1106_sparse_clear(struct sh1106_sparse *sparse);
+
+/**
+ * @brief Get column byte.
+ *
+ * @param[in] sparse Sparse framebuffer
+ * @param[in] page_addr Page address
+ * @param[in] column Column
+ *
+ * @return 8 vertical pixels of the column (LSB is the top line)
+ */
+uint8_t sh1106_sparse_get(const struct sh1106_sparse *sparse, uint8_t page_addr, uint8_t column);
+
+/**
+ * @brief Set column byte.
+ *
+ * @param[in,out] sparse Sparse framebuffer
+ * @param[in] page_addr Page address
+ * @param[in] column Column
+ * @param[in] byte 8 vertical pixels of the column (LSB is the top line)
+ *
+ * @return 0 on success, -1 if the pool is full
+ */
+int sh1106_sparse_set(struct sh1106_sparse *sparse, uint8_t page_addr, uint8_t column, uint8_t byte);
+
+/**
+ * @brief Set pixel.
+ *
+ * @param[in,out] sparse Sparse framebuffer
+ * @param[in] x Column
+ * @param[in] y Line
+ * @param[in] on Non-zero to light the pixel, 0 to clear it
+ *
+ * @return 0 on success, -1 if the pool is full
+ */
+int sh1106_sparse_set_pixel(struct sh1106_sparse *sparse, int16_t x, int16_t y, uint8_t on);
+
+/**
+ * @brief Get pixel.
+ *
+ * @param[in] sparse Sparse framebuffer
+ * @param[in] x Column
+ * @param[in] y Line
+ *
+ * @return 1 if the pixel is lit, 0 if it is not or lies outside of the screen
+ */
+uint8_t sh1106_sparse_get_pixel(const struct sh1106_sparse *sparse, int16_t x, int16_t y);
+
+/**
+ * @brief Fill rectangle.
+ *
+ * @param[in,out] sparse Sparse framebuffer
+ * @param[in] x Left column
+ * @param[in] y Top line
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] on Non-zero to light the pixels, 0 to clear them
+ *
+ * @return 0 on success, -1 if the pool ran full, the rectangle is then drawn partially
+ */
+int sh1106_sparse_fill_rect(struct sh1106_sparse *sparse,
+                            int16_t x,
+                            int16_t y,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t on);
+
+/**
+ * @brief Flush dirty set.
+ *
+ * Sends the occupied columns of the dirty spans and the columns that have to be blanked. Runs separated by blank
+ * columns get their own sh1106_set_column_address() when that is shorter than sending the blank columns. The dirty
+ * set is cleared.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] sparse Sparse framebuffer
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_sparse_flush(const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             struct sh1106_sparse *sparse);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_SPARSE_H
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_STRIP_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_STRIP_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * @brief Draw one page strip.
+ *
+ * Called by sh1106_render_strips() once per page with a cleared 132 byte strip. The strip holds 8 lines of the page
+ * in display RAM order (one byte per column, LSB is the top line); use sh1106_strip_set_pixel() and
+ * sh1106_strip_fill_rect() to draw in screen coordinates, they clip to the page.
+ *
+ * @param[in] context Application context
+ * @param[in] page_addr Page address of the strip
+ * @param[out] strip Page strip, SH1106_COLUMNS bytes
+ *
+ * @return Non-zero if the strip has to be sent, 0 if the page is unchanged and may be skipped
+ */
+typedef int (*sh1106_strip_draw_t)(void *context, uint8_t page_addr, uint8_t *strip);
+
+/**
+ * @brief Render display without framebuffer.
+ *
+ * Renders the display page by page into a single 132 byte strip on the stack instead of a 1056 byte framebuffer. Every
+ * page the draw callback reports as changed is sent with sh1106_set_page_address(), sh1106_set_column_address() and
+ * sh1106_write_display_data().
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] draw Draw callback
+ * @param[in] context Application context passed to the draw callback
+ * @param[in] page_mask Pages to be rendered, bit N selects page N
+ *
+ * @return Mask of pages that were sent
+ */
+uint8_t sh1106_render_strips(const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             sh1106_strip_draw_t draw,
+                             void *context,
+                             uint8_t page_mask);
+
+/**
+ * @brief Set pixel in a page strip.
+ *
+ * Pixels outside of the page are ignored.
+ *
+ * @param[in,out] strip Page strip
+ * @param[in] page_addr Page address of the strip
+ * @param[in] x Column in screen coordinates
+ * @param[in] y Line in screen coordinates
+ * @param[in] on Non-zero to light the pixel, 0 to clear it
+ */
+void sh1106_strip_set_pixel(uint8_t *strip, uint8_t page_addr, int16_t x, int16_t y, uint8_t on);
+
+/**
+ * @brief Fill rectangle in a page strip.
+ *
+ * The rectangle is clipped to the page, columns are filled a whole byte at a time.
+ *
+ * @param[in,out] strip Page strip
+ * @param[in] page_addr Page address of the strip
+ * @param[in] x Left column in screen coordinates
+ * @param[in] y Top line in screen coordinates
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] on Non-zero to light the pixels, 0 to clear them
+ */
+void sh1106_strip_fill_rect(uint8_t *strip,
+                            uint8_t page_addr,
+                            int16_t x,
+                            int16_t y,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t on);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_STRIP_H
@@ -17,8 +17,13 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef YET_ANOTHER_GAUGE__SH1106__SYSCFG_H
-#define YET_ANOTHER_GAUGE__SH1106__SYSCFG_H
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_SYSCFG_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_SYSCFG_H
+
+/*
+ * Command opcodes of the controller. Public because sh1106.hpp and sh1106_commands_impl.h encode commands inline in
+ * the caller; the C API does not need them.
+ */
 
 /**
  * @def SH1106_SET_LOWER_COLUMN_ADDRESS(addr)
@@ -904,4 +909,4 @@
  */
 #define SH1106_WRITE_DISPLAY_DATA(data) (0xFF & (data))
 
-#endif // YET_ANOTHER_GAUGE__SH1106__SYSCFG_H
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_SYSCFG_H
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_TILED_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_TILED_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_orientation.h"
+
+/**
+ * @def SH1106_TILED_MAX_PANELS
+ *
+ * Maximal number of panels of a canvas, at most 8 as flushes return a mask of panels in a byte. It sizes struct
+ * sh1106_tiled, so the library and its users must be built with the same value.
+ */
+#ifndef SH1106_TILED_MAX_PANELS
+#define SH1106_TILED_MAX_PANELS 4
+#endif
+
+#if SH1106_TILED_MAX_PANELS > 8
+#error "SH1106_TILED_MAX_PANELS must not exceed 8"
+#endif
+
+/**
+ * @brief Panel of a tiled canvas.
+ *
+ * A landscape panel shows width x (pages * 8) canvas pixels, a portrait panel (90/270 degrees) shows
+ * (pages * 8) x width canvas pixels, transposed while they are sent.
+ */
+struct sh1106_panel {
+  /** Command transport */
+  sh1106_send8_cmd_t send8_cmd;
+  /** Data transport */
+  sh1106_send8_data_t send8_data;
+  /** Left canvas column shown by the panel */
+  uint16_t x;
+  /** Top canvas line shown by the panel, a multiple of 8 */
+  uint16_t y;
+  /** Visible columns of the module, a multiple of 8 for portrait panels */
+  uint8_t width;
+  /** Visible pages of the module */
+  uint8_t pages;
+  /** First visible column of display RAM, 2 for modules with 128 columns */
+  uint8_t column_offset;
+  /** Mounting of the module */
+  enum sh1106_orientation orientation;
+  /** Bus of the module, panels on different buses may be flushed at the same time */
+  uint8_t bus;
+  /** Dirty set in display RAM addresses */
+  struct sh1106_dirty dirty;
+};
+
+/**
+ * @brief Tiled canvas.
+ *
+ * One page-major canvas, wider or taller than a controller, shown by several SH1106 panels. Drawing marks the
+ * affected columns of every panel dirty, a flush sends only the dirty spans of the affected panels.
+ */
+struct sh1106_tiled {
+  /** Canvas, page-major, width * pages bytes */
+  uint8_t *pixels;
+  /** Width in columns */
+  uint16_t width;
+  /** Height in pages */
+  uint8_t pages;
+  /** Panels */
+  struct sh1106_panel panels[SH1106_TILED_MAX_PANELS];
+  /** Number of panels */
+  uint8_t count;
+};
+
+/**
+ * @brief Initialize tiled canvas.
+ *
+ * Clears the canvas, panels are added with sh1106_tiled_add_panel().
+ *
+ * @param[out] tiled Tiled canvas
+ * @param[in] pixels Canvas, width * pages bytes
+ * @param[in] width Width in columns
+ * @param[in] pages Height in pages
+ */
+void sh1106_tiled_init(struct sh1106_tiled *tiled, uint8_t *pixels, uint16_t width, uint8_t pages);
+
+/**
+ * @brief Add panel.
+ *
+ * The panel is copied and its dirty set covers everything it shows.
+ *
+ * @param[in,out] tiled Tiled canvas
+ * @param[in] panel Panel, the dirty set is ignored
+ *
+ * @return Panel index, -1 if there are SH1106_TILED_MAX_PANELS panels or the panel does not fit the canvas
+ */
+int sh1106_tiled_add_panel(struct sh1106_tiled *tiled, const struct sh1106_panel *panel);
+
+/**
+ * @brief Program the orientation of every panel.
+ *
+ * @param[in] tiled Tiled canvas
+ */
+void sh1106_tiled_set_orientation(const struct sh1106_tiled *tiled);
+
+/**
+ * @brief Mark rectangle dirty.
+ *
+ * Call it after writing canvas pixels directly.
+ *
+ * @param[in,out] tiled Tiled canvas
+ * @param[in] x Left column
+ * @param[in] y Top line
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ */
+void sh1106_tiled_invalidate(struct sh1106_tiled *tiled, int16_t x, int16_t y, int16_t width, int16_t height);
+
+/**
+ * @brief Clear canvas.
+ *
+ * @param[in,out] tiled Tiled canvas
+ */
+void sh1106_tiled_clear(struct sh1106_tiled *tiled);
+
+/**
+ * @brief Set pixel.
+ *
+ * @param[in,out] tiled Tiled canvas
+ * @param[in] x Column
+ * @param[in] y Line
+ * @param[in] on Non-zero to light the pixel, 0 to clear it
+ */
+void sh1106_tiled_set_pixel(struct sh1106_tiled *tiled, int16_t x, int16_t y, uint8_t on);
+
+/**
+ * @brief Get pixel.
+ *
+ * @param[in] tiled Tiled canvas
+ * @param[in] x Column
+ * @param[in] y Line
+ *
+ * @return 1 if the pixel is lit, 0 if it is not or lies outside of the canvas
+ */
+uint8_t sh1106_tiled_get_pixel(const struct sh1106_tiled *tiled, int16_t x, int16_t y);
+
+/**
+ * @brief Fill rectangle.
+ *
+ * @param[in,out] tiled Tiled canvas
+ * @param[in] x Left column
+ * @param[in] y Top line
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] on Non-zero to light the pixels, 0 to clear them
+ */
+void sh1106_tiled_fill_rect(struct sh1106_tiled *tiled,
+                            int16_t x,
+                            int16_t y,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t on);
+
+/**
+ * @brief Flush dirty set of a panel.
+ *
+ * Only reads the canvas and writes the dirty set of the panel, so panels may be flushed from different threads.
+ *
+ * @param[in,out] tiled Tiled canvas
+ * @param[in] index Panel index
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_tiled_flush_panel(struct sh1106_tiled *tiled, uint8_t index);
+
+/**
+ * @brief Flush dirty panels of a bus.
+ *
+ * @param[in,out] tiled Tiled canvas
+ * @param[in] bus Bus
+ *
+ * @return Mask of panels that were sent, bit N selects panel N
+ */
+uint8_t sh1106_tiled_flush_bus(struct sh1106_tiled *tiled, uint8_t bus);
+
+/**
+ * @brief Flush dirty panels.
+ *
+ * Panels are sent one after another, see sh1106_parallel_flush_tiled() to send buses at the same time.
+ *
+ * @param[in,out] tiled Tiled canvas
+ *
+ * @return Mask of panels that were sent, bit N selects panel N
+ */
+uint8_t sh1106_tiled_flush(struct sh1106_tiled *tiled);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_TILED_H
@@ -0,0 +1,176 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_TIMING_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_TIMING_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_trace.h"
+
+/**
+ * @def SH1106_HISTOGRAM_BUCKETS
+ *
+ * Number of histogram buckets, bucket N counts durations of N significant bits, i.e. [2^(N-1), 2^N) ticks.
+ */
+#define SH1106_HISTOGRAM_BUCKETS 33
+
+enum sh1106_stage {
+  /** Drawing into the framebuffer */
+                     SH1106_STAGE_RENDER = 0,
+  /** Finding what changed, e.g. dirty sets or hashes */
+                     SH1106_STAGE_DIFF = 1,
+  /** Producing the bytes to be sent, e.g. compositing or decoding */
+                     SH1106_STAGE_ENCODE = 2,
+  /** Sending through the transports up to the last byte */
+                     SH1106_STAGE_TRANSFER = 3,
+  /** From sh1106_timing_begin() to sh1106_timing_end() */
+                     SH1106_STAGE_TOTAL = 4
+};
+
+/**
+ * @def SH1106_STAGES
+ *
+ * Number of stages.
+ */
+#define SH1106_STAGES 5
+
+/**
+ * @brief Log-bucket latency histogram.
+ */
+struct sh1106_histogram {
+  uint32_t buckets[SH1106_HISTOGRAM_BUCKETS];
+  /** Number of samples */
+  uint32_t count;
+  /** Largest sample in ticks */
+  uint32_t max;
+};
+
+/**
+ * @brief Stage latency report in ticks.
+ */
+struct sh1106_timing_report {
+  uint32_t count;
+  uint32_t p50;
+  uint32_t p99;
+  uint32_t max;
+};
+
+/**
+ * @brief Flush timing.
+ *
+ * Splits the latency from a value change to the last byte on the bus into stages. Every stage call reads the clock
+ * once and records the ticks since the previous call into the histogram of the stage.
+ */
+struct sh1106_timing {
+  /** Clock */
+  sh1106_clock_t clock;
+  /** Time of sh1106_timing_begin() */
+  uint32_t start;
+  /** Time of the last stage */
+  uint32_t mark;
+  /** Histogram of every stage */
+  struct sh1106_histogram stages[SH1106_STAGES];
+};
+
+/**
+ * @def SH1106_TIMING_BEGIN(timing)
+ * @def SH1106_TIMING_STAGE(timing, stage)
+ * @def SH1106_TIMING_END(timing)
+ *
+ * Instrumentation points, compiled in only if SH1106_TIMING is defined.
+ */
+#ifdef SH1106_TIMING
+#define SH1106_TIMING_BEGIN(timing) sh1106_timing_begin(timing)
+#define SH1106_TIMING_STAGE(timing, stage) sh1106_timing_stage((timing), (stage))
+#define SH1106_TIMING_END(timing) sh1106_timing_end(timing)
+#else
+#define SH1106_TIMING_BEGIN(timing) ((void) 0)
+#define SH1106_TIMING_STAGE(timing, stage) ((void) 0)
+#define SH1106_TIMING_END(timing) ((void) 0)
+#endif
+
+/**
+ * @brief Clear histogram.
+ *
+ * @param[out] histogram Histogram
+ */
+void sh1106_histogram_reset(struct sh1106_histogram *histogram);
+
+/**
+ * @brief Add sample to histogram.
+ *
+ * @param[in,out] histogram Histogram
+ * @param[in] ticks Duration in ticks
+ */
+void sh1106_histogram_add(struct sh1106_histogram *histogram, uint32_t ticks);
+
+/**
+ * @brief Get percentile of histogram.
+ *
+ * @param[in] histogram Histogram
+ * @param[in] percent Percentile (0 - 100)
+ *
+ * @return Upper bound of the bucket that holds the percentile, at most the largest sample; 0 without samples
+ */
+uint32_t sh1106_histogram_percentile(const struct sh1106_histogram *histogram, uint8_t percent);
+
+/**
+ * @brief Initialize flush timing.
+ *
+ * @param[out] timing Flush timing with empty histograms
+ * @param[in] clock Clock
+ */
+void sh1106_timing_init(struct sh1106_timing *timing, sh1106_clock_t clock);
+
+/**
+ * @brief Start measuring, e.g. when a displayed value changed.
+ *
+ * @param[in,out] timing Flush timing
+ */
+void sh1106_timing_begin(struct sh1106_timing *timing);
+
+/**
+ * @brief Record the end of a stage.
+ *
+ * @param[in,out] timing Flush timing
+ * @param[in] stage Stage that just finished
+ */
+void sh1106_timing_stage(struct sh1106_timing *timing, enum sh1106_stage stage);
+
+/**
+ * @brief Stop measuring after the last byte was sent, records SH1106_STAGE_TOTAL.
+ *
+ * @param[in,out] timing Flush timing
+ */
+void sh1106_timing_end(struct sh1106_timing *timing);
+
+/**
+ * @brief Report stage latency.
+ *
+ * @param[in] timing Flush timing
+ * @param[in] stage Stage
+ * @param[out] report Sample count, p50, p99 and max in ticks
+ */
+void sh1106_timing_report(const struct sh1106_timing *timing,
+                          enum sh1106_stage stage,
+                          struct sh1106_timing_report *report);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_TIMING_H
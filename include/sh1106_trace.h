@@ -0,0 +1,172 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_TRACE_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_TRACE_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+
+/**
+ * Binary transport trace.
+ *
+ * +--------+--------------------------------------------------------------------------+
+ * | Header | "SHTR", ticks per second (uint32_t, little endian)                       |
+ * +--------+--------------------------------------------------------------------------+
+ * | Record | tag, time delta, payload                                                 |
+ * |        |   tag: bit 7 = A0 (1 data, 0 command), bits 6 - 0 = payload size - 1     |
+ * |        |   time delta: ticks since the previous record, unsigned LEB128           |
+ * |        |   payload: 1 - 128 bytes                                                 |
+ * +--------+--------------------------------------------------------------------------+
+ *
+ * Consecutive bytes of the same kind are merged into one record, the record carries the time of its first byte.
+ */
+
+/**
+ * @def SH1106_TRACE_HEADER_SIZE
+ *
+ * Size of the trace header in bytes.
+ */
+#define SH1106_TRACE_HEADER_SIZE 8
+
+/**
+ * @def SH1106_TRACE_RECORD_MAX
+ *
+ * Maximal number of payload bytes in a record.
+ */
+#define SH1106_TRACE_RECORD_MAX 128
+
+/**
+ * @brief Read the current time.
+ *
+ * @return Time in ticks of a monotonic clock
+ */
+typedef uint32_t (*sh1106_clock_t)(void);
+
+/**
+ * @brief Trace recorder.
+ */
+struct sh1106_trace {
+  /** Trace buffer */
+  uint8_t *buffer;
+  /** Size of the trace buffer */
+  uint32_t size;
+  /** Number of bytes recorded */
+  uint32_t length;
+  /** Number of bytes that did not fit into the trace buffer */
+  uint32_t overflow;
+  /** Clock */
+  sh1106_clock_t clock;
+  /** Time of the last record */
+  uint32_t time;
+  /** Offset of the open record tag, 0 if none */
+  uint32_t record;
+  /** Wrapped command transport */
+  sh1106_send8_cmd_t send8_cmd;
+  /** Wrapped data transport */
+  sh1106_send8_data_t send8_data;
+};
+
+/**
+ * @brief Decoded trace record.
+ */
+struct sh1106_trace_record {
+  /** Non-zero for data bytes, 0 for command bytes */
+  uint8_t data;
+  /** Time of the first byte in ticks since the first record */
+  uint32_t time;
+  /** Number of payload bytes */
+  uint8_t size;
+  /** Payload */
+  const uint8_t *payload;
+};
+
+/**
+ * @brief Start tracing.
+ *
+ * Pass sh1106_trace_send8_cmd() and sh1106_trace_send8_data() to the driver instead of the real transport. They
+ * record every byte and forward it to the wrapped transport. Only one trace can be active at a time.
+ *
+ * @param[out] trace Trace recorder
+ * @param[in] buffer Trace buffer, at least SH1106_TRACE_HEADER_SIZE bytes
+ * @param[in] size Size of the trace buffer
+ * @param[in] ticks_per_second Resolution of the clock, stored in the header
+ * @param[in] clock Clock
+ * @param[in] send8_cmd Command transport to be wrapped
+ * @param[in] send8_data Data transport to be wrapped
+ */
+void sh1106_trace_start(struct sh1106_trace *trace,
+                        uint8_t *buffer,
+                        uint32_t size,
+                        uint32_t ticks_per_second,
+                        sh1106_clock_t clock,
+                        const sh1106_send8_cmd_t send8_cmd,
+                        const sh1106_send8_data_t send8_data);
+
+/**
+ * @brief Stop tracing.
+ *
+ * The tracing transports keep forwarding to the wrapped transport without recording. The first `length` bytes of the
+ * buffer hold the trace.
+ */
+void sh1106_trace_stop(void);
+
+/**
+ * @brief Tracing command transport.
+ *
+ * Bytes sent before the first sh1106_trace_start() are dropped.
+ *
+ * @param[in] cmd 8 bit command to be sent
+ */
+void sh1106_trace_send8_cmd(uint8_t cmd);
+
+/**
+ * @brief Tracing data transport.
+ *
+ * Bytes sent before the first sh1106_trace_start() are dropped.
+ *
+ * @param[in] data 8 bit data to be sent
+ */
+void sh1106_trace_send8_data(uint8_t data);
+
+/**
+ * @brief Read trace header.
+ *
+ * @param[in] trace Trace
+ * @param[in] size Size of the trace
+ * @param[out] ticks_per_second Resolution of the clock
+ *
+ * @return Offset of the first record, 0 if the header is malformed
+ */
+uint32_t sh1106_trace_read_header(const uint8_t *trace, uint32_t size, uint32_t *ticks_per_second);
+
+/**
+ * @brief Read next trace record.
+ *
+ * @param[in] trace Trace
+ * @param[in] size Size of the trace
+ * @param[in,out] offset Offset of the record, advanced to the next one
+ * @param[in,out] record Decoded record, its time accumulates the deltas and must start at 0
+ *
+ * @return 1 if a record was read, 0 at the end of the trace and -1 if the record is truncated
+ */
+int sh1106_trace_read(const uint8_t *trace, uint32_t size, uint32_t *offset, struct sh1106_trace_record *record);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_TRACE_H
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_TRANSFER_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_TRANSFER_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @def SH1106_TRANSFER_MAX
+ *
+ * Maximum number of transfers of a flush, a command and a data transfer per page.
+ */
+#define SH1106_TRANSFER_MAX (2 * SH1106_PAGES)
+
+/**
+ * @def SH1106_TRANSFER_COMMAND_SIZE
+ *
+ * Size of the command transfer of a page: page address and the two column address bytes.
+ */
+#define SH1106_TRANSFER_COMMAND_SIZE 3
+
+/**
+ * @brief Transfer descriptor.
+ *
+ * A contiguous run of bytes sent with one D/C level, e.g. one entry of a DMA chain or of a SPI_IOC_MESSAGE array.
+ */
+struct sh1106_transfer {
+  /** Bytes to be sent */
+  const uint8_t *data;
+  /** Number of bytes */
+  uint16_t length;
+  /** D/C level, 0 for commands, 1 for display data */
+  uint8_t dc;
+};
+
+/**
+ * @brief Transfer list of a flush.
+ *
+ * Alternating command and data transfers, the data transfers point into the framebuffer and the command transfers
+ * into the list itself, nothing is copied. The list stays valid while neither of them moves.
+ */
+struct sh1106_transfer_list {
+  /** Transfers in send order */
+  struct sh1106_transfer transfers[SH1106_TRANSFER_MAX];
+  /** Number of transfers */
+  uint8_t count;
+  /** Command bytes of every page */
+  uint8_t commands[SH1106_PAGES][SH1106_TRANSFER_COMMAND_SIZE];
+  /** Pixels, number of pages, page offset and dirty set the list was compiled for */
+  const uint8_t *pixels;
+  uint8_t pages;
+  uint8_t page_offset;
+  struct sh1106_dirty dirty;
+};
+
+/**
+ * @brief Clear transfer list.
+ *
+ * The next sh1106_transfer_compile() rebuilds the list.
+ *
+ * @param[out] list Transfer list
+ */
+void sh1106_transfer_reset(struct sh1106_transfer_list *list);
+
+/**
+ * @brief Compile flush into transfer list.
+ *
+ * Describes what sh1106_framebuffer_flush() would send: every dirty page becomes a command transfer with
+ * sh1106_set_page_address() and sh1106_set_column_address() followed by a data transfer of its dirty span. A list
+ * compiled for the same pixels and an equal dirty set is reused as is, so the list of a full frame is built once.
+ * The dirty set of the framebuffer is not cleared, clear it with sh1106_dirty_reset() once the transfers are done.
+ *
+ * @param[in,out] list Transfer list
+ * @param[in] framebuffer Framebuffer or window
+ *
+ * @return Number of transfers
+ */
+uint8_t sh1106_transfer_compile(struct sh1106_transfer_list *list, const struct sh1106_framebuffer *framebuffer);
+
+/**
+ * @brief Compile flush to display RAM pages from an offset into transfer list.
+ *
+ * Like sh1106_transfer_compile(), describes what sh1106_framebuffer_flush_at() would send. A list is reused only for
+ * the same pixels, number of pages, page offset and an equal dirty set.
+ *
+ * @param[in,out] list Transfer list
+ * @param[in] framebuffer Framebuffer or window
+ * @param[in] page_offset Display RAM page of framebuffer page 0
+ *
+ * @return Number of transfers
+ */
+uint8_t sh1106_transfer_compile_at(struct sh1106_transfer_list *list,
+                                   const struct sh1106_framebuffer *framebuffer,
+                                   uint8_t page_offset);
+
+/**
+ * @brief Send transfer list through the byte transports.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] list Transfer list
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_transfer_run(const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             const struct sh1106_transfer_list *list);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_TRANSFER_H
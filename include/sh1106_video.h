@@ -0,0 +1,200 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_VIDEO_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_VIDEO_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_bus.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @def SH1106_VIDEO_RING_SIZE
+ *
+ * Number of frames decoded ahead.
+ */
+#ifndef SH1106_VIDEO_RING_SIZE
+#define SH1106_VIDEO_RING_SIZE 4
+#endif
+
+/**
+ * @def SH1106_VIDEO_MAX_RUNS
+ *
+ * Maximal number of runs of a decoded frame, a frame with more runs is sent whole.
+ */
+#ifndef SH1106_VIDEO_MAX_RUNS
+#define SH1106_VIDEO_MAX_RUNS 128
+#endif
+
+/**
+ * @def SH1106_VIDEO_FULL_FRAME
+ *
+ * Run count of a frame that is sent whole.
+ */
+#define SH1106_VIDEO_FULL_FRAME UINT16_MAX
+
+/**
+ * @brief Decoded frame, ready to be sent.
+ */
+struct sh1106_video_frame {
+  /** Frame, width * pages bytes */
+  uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  /** Changed runs, never crossing a page */
+  struct sh1106_video_run {
+    /** Offset into the frame */
+    uint16_t offset;
+    /** Length in bytes */
+    uint16_t length;
+  } runs[SH1106_VIDEO_MAX_RUNS];
+  /** Number of runs, SH1106_VIDEO_FULL_FRAME to send the frame whole */
+  uint16_t count;
+};
+
+/**
+ * @brief Video metrics.
+ */
+struct sh1106_video_metrics {
+  /** Number of frames sent */
+  uint32_t presented;
+  /** Number of frames skipped because a later frame was already due */
+  uint32_t dropped;
+  /** Number of frames that were not decoded yet when they were due */
+  uint32_t late;
+  /** Ticks from the first frame to the last poll */
+  uint32_t elapsed;
+  /** Wire-time estimate of everything sent, if a bus model is given */
+  struct sh1106_bus_stats bus;
+};
+
+/**
+ * @brief Video player.
+ *
+ * Plays an XOR-delta animation file (see sh1106_animation.h, built by the sh1106_animation tool) once. The file is
+ * memory-mapped, a worker thread decodes the frames ahead into a ring of frames with their changed runs, and the
+ * calling thread only sends them. Frames are due at fixed times from the first poll; when a poll comes late, the
+ * frames due before the newest decoded one are dropped and only their changed runs are sent, from the newest frame.
+ *
+ * Requires POSIX threads and mmap(), the module is built with the SH1106_VIDEO CMake option.
+ */
+struct sh1106_video {
+  /** Mapped file */
+  const uint8_t *data;
+  /** Size of the mapped file */
+  size_t size;
+  /** Bus model for the wire-time estimate, may be NULL */
+  const struct sh1106_bus_model *model;
+  /** Width in columns */
+  uint8_t width;
+  /** Height in pages */
+  uint8_t pages;
+  /** Left column of the region */
+  uint8_t column;
+  /** Top page of the region */
+  uint8_t page_addr;
+  /** Number of frames */
+  uint16_t frames;
+  /** Ticks per frame */
+  uint32_t period;
+  /** Time of the first poll in ticks */
+  uint32_t start;
+  /** Non-zero after the first poll */
+  uint8_t started;
+  /** Frame last counted as late plus one, 0 if none */
+  uint32_t underrun;
+  /** Worker thread */
+  pthread_t thread;
+  /** Guards head, tail and stop */
+  pthread_mutex_t mutex;
+  /** Signalled when a frame is decoded */
+  pthread_cond_t ready;
+  /** Signalled when a frame is sent or the player is closed */
+  pthread_cond_t space;
+  /** Number of frames decoded */
+  uint32_t head;
+  /** Number of frames sent or dropped */
+  uint32_t tail;
+  /** Non-zero when the player is being closed */
+  uint8_t stop;
+  /** Decoded frames */
+  struct sh1106_video_frame ring[SH1106_VIDEO_RING_SIZE];
+  /** Frame being decoded, owned by the worker thread */
+  uint8_t current[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  /** Video metrics */
+  struct sh1106_video_metrics metrics;
+};
+
+/**
+ * @brief Open video and start decoding.
+ *
+ * @param[out] video Video player
+ * @param[in] path Animation file
+ * @param[in] model Bus model for the wire-time estimate, may be NULL
+ * @param[in] column Left column of the region
+ * @param[in] page_addr Top page of the region
+ * @param[in] period Ticks per frame
+ *
+ * @return 0 on success, -1 if the file can not be mapped, is malformed or does not fit the display at the region
+ */
+int sh1106_video_open(struct sh1106_video *video,
+                      const char *path,
+                      const struct sh1106_bus_model *model,
+                      uint8_t column,
+                      uint8_t page_addr,
+                      uint32_t period);
+
+/**
+ * @brief Stop decoding and unmap video.
+ *
+ * @param[in,out] video Video player
+ */
+void sh1106_video_close(struct sh1106_video *video);
+
+/**
+ * @brief Send the frame due at the given time.
+ *
+ * Never waits for the worker thread: if the due frame is not decoded yet, it is counted as late and sent by a later
+ * poll.
+ *
+ * @param[in,out] video Video player
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in] now Current time in ticks
+ *
+ * @return 1 once the last frame has been sent, 0 otherwise
+ */
+int sh1106_video_poll(struct sh1106_video *video,
+                      const sh1106_send8_cmd_t send8_cmd,
+                      const sh1106_send8_data_t send8_data,
+                      uint32_t now);
+
+/**
+ * @brief Bus utilization.
+ *
+ * @param[in] video Video player opened with a bus model
+ * @param[in] ticks_per_second Ticks of the clock passed to sh1106_video_poll() per second
+ *
+ * @return Share of the elapsed time the bus was busy, in 1/100 percent
+ */
+uint32_t sh1106_video_bus_utilization(const struct sh1106_video *video, uint32_t ticks_per_second);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_VIDEO_H
@@ -0,0 +1,323 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__SH1106_WIDGET_H
+#define YET_ANOTHER_GAUGE__SH1106__SH1106_WIDGET_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_asset.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @brief Widget kind.
+ */
+enum sh1106_widget_kind {
+  /** Container of other widgets, draws nothing itself */
+                          SH1106_WIDGET_GROUP = 0,
+  /** Text in a font */
+                          SH1106_WIDGET_LABEL = 1,
+  /** Decimal number in a font, right aligned */
+                          SH1106_WIDGET_VALUE = 2,
+  /** Horizontal bar filled in proportion to its value */
+                          SH1106_WIDGET_BAR = 3,
+  /** Frame of an image or sprite */
+                          SH1106_WIDGET_ICON = 4,
+  /** Half dial with a needle pointing at its value */
+                          SH1106_WIDGET_GAUGE = 5
+};
+
+/**
+ * @brief Widget.
+ *
+ * A node of a retained widget tree. Widgets are owned by the caller and linked into the tree, so nothing is allocated.
+ * The rectangle is relative to the parent, and a widget is drawn clipped to the rectangles of all of its ancestors.
+ * Properties are changed through the setters, which invalidate the rectangle of the widget only.
+ */
+struct sh1106_widget {
+  /** Widget kind, see enum sh1106_widget_kind */
+  uint8_t kind;
+  /** Parent, NULL until the widget is added to a tree */
+  struct sh1106_widget *parent;
+  /** First child */
+  struct sh1106_widget *child;
+  /** Next sibling, drawn above this widget */
+  struct sh1106_widget *next;
+  /** Left column relative to the parent */
+  int16_t x;
+  /** Top line relative to the parent */
+  int16_t y;
+  /** Width in columns */
+  int16_t width;
+  /** Height in lines */
+  int16_t height;
+  /** Font of a label or value, image or sprite of an icon */
+  const struct sh1106_asset *asset;
+  /** Text of a label, NUL terminated */
+  const char *text;
+  /** Value of a value, bar or gauge, frame index of an icon */
+  int32_t value;
+  /** Value of an empty bar or a gauge pointing left */
+  int32_t min;
+  /** Value of a full bar or a gauge pointing right */
+  int32_t max;
+};
+
+/**
+ * @brief Widget tree metrics.
+ */
+struct sh1106_widget_metrics {
+  /** Number of invalidated widget rectangles */
+  uint32_t invalidations;
+  /** Number of damage rectangles rendered */
+  uint32_t rectangles;
+  /** Number of widgets drawn */
+  uint32_t draws;
+};
+
+/**
+ * @brief Retained widget tree.
+ *
+ * Damage is kept as one column span per page, so rectangles invalidated on the same page are merged into their
+ * bounding span. Rendering walks the damage a band of pages with equal spans at a time, clears the band and redraws
+ * only the widgets that intersect it, clipped to it. The rendered damage is added to the dirty set of the screen, so a
+ * flush sends the merged rectangles and nothing else.
+ */
+struct sh1106_widgets {
+  /** Screen framebuffer */
+  struct sh1106_framebuffer *screen;
+  /** Root group covering the screen */
+  struct sh1106_widget root;
+  /** Damage not rendered yet */
+  struct sh1106_dirty damage;
+  /** Widget tree metrics */
+  struct sh1106_widget_metrics metrics;
+};
+
+/**
+ * @brief Initialize widget tree.
+ *
+ * The tree is empty and the whole screen is damaged, so the first render clears it.
+ *
+ * @param[out] widgets Widget tree
+ * @param[in,out] screen Screen framebuffer
+ */
+void sh1106_widgets_init(struct sh1106_widgets *widgets, struct sh1106_framebuffer *screen);
+
+/**
+ * @brief Initialize group.
+ *
+ * @param[out] widget Widget
+ * @param[in] x Left column relative to the parent
+ * @param[in] y Top line relative to the parent
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ */
+void sh1106_group_init(struct sh1106_widget *widget, int16_t x, int16_t y, int16_t width, int16_t height);
+
+/**
+ * @brief Initialize label.
+ *
+ * @param[out] widget Widget
+ * @param[in] x Left column relative to the parent
+ * @param[in] y Top line relative to the parent
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] font Font asset
+ * @param[in] text Text, NUL terminated, must outlive the widget
+ */
+void sh1106_label_init(struct sh1106_widget *widget,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       const struct sh1106_asset *font,
+                       const char *text);
+
+/**
+ * @brief Initialize value.
+ *
+ * @param[out] widget Widget
+ * @param[in] x Left column relative to the parent
+ * @param[in] y Top line relative to the parent
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] font Font asset with the glyphs '-' and '0' - '9'
+ * @param[in] value Value
+ */
+void sh1106_value_init(struct sh1106_widget *widget,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       const struct sh1106_asset *font,
+                       int32_t value);
+
+/**
+ * @brief Initialize bar.
+ *
+ * @param[out] widget Widget
+ * @param[in] x Left column relative to the parent
+ * @param[in] y Top line relative to the parent
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] min Value of an empty bar
+ * @param[in] max Value of a full bar
+ * @param[in] value Value
+ */
+void sh1106_bar_init(struct sh1106_widget *widget,
+                     int16_t x,
+                     int16_t y,
+                     int16_t width,
+                     int16_t height,
+                     int32_t min,
+                     int32_t max,
+                     int32_t value);
+
+/**
+ * @brief Initialize icon.
+ *
+ * The size of the icon is the size of the asset.
+ *
+ * @param[out] widget Widget
+ * @param[in] x Left column relative to the parent
+ * @param[in] y Top line relative to the parent
+ * @param[in] asset Image or sprite asset
+ * @param[in] frame Frame index
+ */
+void sh1106_icon_init(struct sh1106_widget *widget,
+                      int16_t x,
+                      int16_t y,
+                      const struct sh1106_asset *asset,
+                      uint16_t frame);
+
+/**
+ * @brief Initialize gauge.
+ *
+ * The dial is a half circle standing on the bottom line of the rectangle, the needle turns from left (min) to right
+ * (max).
+ *
+ * @param[out] widget Widget
+ * @param[in] x Left column relative to the parent
+ * @param[in] y Top line relative to the parent
+ * @param[in] width Width in columns
+ * @param[in] height Height in lines
+ * @param[in] min Value of the needle pointing left
+ * @param[in] max Value of the needle pointing right
+ * @param[in] value Value
+ */
+void sh1106_gauge_init(struct sh1106_widget *widget,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       int32_t min,
+                       int32_t max,
+                       int32_t value);
+
+/**
+ * @brief Add widget to tree.
+ *
+ * The widget becomes the last child of the parent, drawn above its siblings, and its rectangle is invalidated.
+ *
+ * @param[in,out] widgets Widget tree
+ * @param[in,out] parent Parent, NULL for the root group
+ * @param[in,out] widget Widget, not part of a tree
+ */
+void sh1106_widget_add(struct sh1106_widgets *widgets, struct sh1106_widget *parent, struct sh1106_widget *widget);
+
+/**
+ * @brief Remove widget from tree.
+ *
+ * The rectangle of the widget is invalidated, its children stay attached to it.
+ *
+ * @param[in,out] widgets Widget tree
+ * @param[in,out] widget Widget
+ */
+void sh1106_widget_remove(struct sh1106_widgets *widgets, struct sh1106_widget *widget);
+
+/**
+ * @brief Move widget.
+ *
+ * Invalidates the old and the new rectangle.
+ *
+ * @param[in,out] widgets Widget tree
+ * @param[in,out] widget Widget
+ * @param[in] x Left column relative to the parent
+ * @param[in] y Top line relative to the parent
+ */
+void sh1106_widget_move(struct sh1106_widgets *widgets, struct sh1106_widget *widget, int16_t x, int16_t y);
+
+/**
+ * @brief Set text of label.
+ *
+ * Always invalidates the widget, so a text changed in place is redrawn by setting the same pointer again.
+ *
+ * @param[in,out] widgets Widget tree
+ * @param[in,out] widget Label
+ * @param[in] text Text, NUL terminated, must outlive the widget
+ */
+void sh1106_widget_set_text(struct sh1106_widgets *widgets, struct sh1106_widget *widget, const char *text);
+
+/**
+ * @brief Set value of value, bar or gauge, or frame index of icon.
+ *
+ * Invalidates the widget only if the value changes.
+ *
+ * @param[in,out] widgets Widget tree
+ * @param[in,out] widget Widget
+ * @param[in] value Value
+ */
+void sh1106_widget_set_value(struct sh1106_widgets *widgets, struct sh1106_widget *widget, int32_t value);
+
+/**
+ * @brief Invalidate widget.
+ *
+ * Damages the rectangle of the widget, clipped to its ancestors. Widgets that are not part of a tree are ignored.
+ *
+ * @param[in,out] widgets Widget tree
+ * @param[in] widget Widget
+ */
+void sh1106_widget_invalidate(struct sh1106_widgets *widgets, const struct sh1106_widget *widget);
+
+/**
+ * @brief Render damage.
+ *
+ * Redraws the widgets intersecting the damage into the screen framebuffer and moves the damage into the dirty set of
+ * the screen.
+ *
+ * @param[in,out] widgets Widget tree
+ */
+void sh1106_widgets_render(struct sh1106_widgets *widgets);
+
+/**
+ * @brief Render damage and flush it.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] widgets Widget tree
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t sh1106_widgets_flush(const sh1106_send8_cmd_t send8_cmd,
+                              const sh1106_send8_data_t send8_data,
+                              struct sh1106_widgets *widgets);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__SH1106_WIDGET_H
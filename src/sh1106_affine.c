@@ -0,0 +1,194 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+#include "sh1106_affine.h"
+
+/* sin(0 - 89 degrees) * 65536 */
+static const uint16_t sh1106_sin_table[90] = {
+    0, 1144, 2287, 3430, 4572, 5712, 6850, 7987, 9121, 10252,
+    11380, 12505, 13626, 14742, 15855, 16962, 18064, 19161, 20252, 21336,
+    22415, 23486, 24550, 25607, 26656, 27697, 28729, 29753, 30767, 31772,
+    32768, 33754, 34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+    42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930, 48703, 49461,
+    50203, 50931, 51643, 52339, 53020, 53684, 54332, 54963, 55578, 56175,
+    56756, 57319, 57865, 58393, 58903, 59396, 59870, 60326, 60764, 61183,
+    61584, 61966, 62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+    64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446, 65496, 65526,
+};
+
+int32_t sh1106_sin(int16_t degrees) {
+  int16_t angle = (int16_t) (degrees % 360);
+  int32_t sign = 1;
+
+  if (angle < 0) {
+    angle = (int16_t) (angle + 360);
+  }
+  if (angle >= 180) {
+    angle = (int16_t) (angle - 180);
+    sign = -1;
+  }
+  if (angle > 90) {
+    angle = (int16_t) (180 - angle);
+  }
+
+  return sign * (angle == 90 ? 0x10000 : sh1106_sin_table[angle]);
+}
+
+int32_t sh1106_cos(int16_t degrees) {
+  return sh1106_sin((int16_t) (degrees % 360 + 90));
+}
+
+void sh1106_affine_rotation(struct sh1106_affine *affine,
+                            int16_t degrees,
+                            uint16_t scale,
+                            int16_t source_x,
+                            int16_t source_y,
+                            int16_t x,
+                            int16_t y) {
+  int32_t sin = sh1106_sin(degrees) * 256 / (scale ? scale : 256);
+  int32_t cos = sh1106_cos(degrees) * 256 / (scale ? scale : 256);
+
+  /* inverse of the clockwise rotation, the pivot centre maps to the pivot centre */
+  affine->dudx = cos;
+  affine->dudy = sin;
+  affine->dvdx = -sin;
+  affine->dvdy = cos;
+  affine->u0 = ((int64_t) source_x << 16) + 0x8000 - (int64_t) cos * x - (int64_t) sin * y;
+  affine->v0 = ((int64_t) source_y << 16) + 0x8000 + (int64_t) sin * x - (int64_t) cos * y;
+}
+
+static void sh1106_affine_bounds(const struct sh1106_affine *affine,
+                                 const struct sh1106_asset *asset,
+                                 int32_t *x0,
+                                 int32_t *y0,
+                                 int32_t *x1,
+                                 int32_t *y1) {
+  /* forward mapping of the frame corners, the inverse of the 2x2 matrix in 32.32 */
+  int64_t det = (int64_t) affine->dudx * affine->dvdy - (int64_t) affine->dudy * affine->dvdx;
+  uint8_t corner;
+
+  *x0 = INT16_MAX;
+  *y0 = INT16_MAX;
+  *x1 = INT16_MIN;
+  *y1 = INT16_MIN;
+  if (det == 0) {
+    return;
+  }
+
+  for (corner = 0; corner < 4; corner++) {
+    int64_t u = ((int64_t) (corner & 1 ? asset->width : 0) << 16) - affine->u0;
+    int64_t v = ((int64_t) (corner & 2 ? asset->pages * 8 : 0) << 16) - affine->v0;
+    int32_t x = (int32_t) (((int64_t) affine->dvdy * u - (int64_t) affine->dudy * v) / det);
+    int32_t y = (int32_t) (((int64_t) affine->dudx * v - (int64_t) affine->dvdx * u) / det);
+
+    if (x < *x0) {
+      *x0 = x;
+    }
+    if (x > *x1) {
+      *x1 = x;
+    }
+    if (y < *y0) {
+      *y0 = y;
+    }
+    if (y > *y1) {
+      *y1 = y;
+    }
+  }
+
+  /* one pixel of slack for the truncated divisions, the per pixel test is exact */
+  *x0 -= 1;
+  *y0 -= 1;
+  *x1 += 1;
+  *y1 += 1;
+}
+
+void sh1106_framebuffer_draw_affine(struct sh1106_framebuffer *framebuffer,
+                                    const struct sh1106_asset *asset,
+                                    uint16_t frame,
+                                    const struct sh1106_affine *affine) {
+  const uint8_t *pixels = sh1106_asset_frame(asset, frame);
+  const uint8_t *mask = NULL;
+  uint32_t width = (uint32_t) asset->width << 16;
+  uint32_t height = (uint32_t) asset->pages << 19;
+  int32_t x0;
+  int32_t y0;
+  int32_t x1;
+  int32_t y1;
+  int32_t page_addr;
+
+  if (pixels == NULL) {
+    return;
+  }
+  if (asset->kind == SH1106_ASSET_SPRITE) {
+    mask = pixels + asset->width * asset->pages;
+  }
+
+  /* bounding box in screen coordinates, clipped */
+  sh1106_affine_bounds(affine, asset, &x0, &y0, &x1, &y1);
+  x0 = x0 + framebuffer->origin_x < framebuffer->clip_x0 ? framebuffer->clip_x0 : x0 + framebuffer->origin_x;
+  y0 = y0 + framebuffer->origin_y < framebuffer->clip_y0 ? framebuffer->clip_y0 : y0 + framebuffer->origin_y;
+  x1 = x1 + framebuffer->origin_x >= framebuffer->clip_x1 ? framebuffer->clip_x1 - 1 : x1 + framebuffer->origin_x;
+  y1 = y1 + framebuffer->origin_y >= framebuffer->clip_y1 ? framebuffer->clip_y1 - 1 : y1 + framebuffer->origin_y;
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  for (page_addr = y0 / 8; page_addr <= y1 / 8; page_addr++) {
+    int32_t top = page_addr * 8;
+    uint8_t rows = 0xFF;
+    uint8_t *pixel = &framebuffer->pixels[page_addr * SH1106_COLUMNS + x0];
+    int32_t local_x = x0 - framebuffer->origin_x;
+    int32_t local_y = top - framebuffer->origin_y;
+    int64_t u = affine->u0 + (int64_t) local_x * affine->dudx + (int64_t) local_y * affine->dudy;
+    int64_t v = affine->v0 + (int64_t) local_x * affine->dvdx + (int64_t) local_y * affine->dvdy;
+    int32_t x;
+
+    if (y0 > top) {
+      rows &= (uint8_t) (0xFF << (y0 - top));
+    }
+    if (y1 < top + 7) {
+      rows &= (uint8_t) (0xFF >> (top + 7 - y1));
+    }
+
+    for (x = x0; x <= x1; x++, pixel++, u += affine->dudx, v += affine->dvdx) {
+      int64_t row_u = u;
+      int64_t row_v = v;
+      uint8_t bits = 0;
+      uint8_t value = 0;
+      uint8_t line;
+
+      /* the 8 lines of the page column, samples outside of the frame read its first byte and are masked off */
+      for (line = 0; line < 8; line++, row_u += affine->dudy, row_v += affine->dvdy) {
+        uint8_t inside = (uint8_t) (((uint64_t) row_u < width) & ((uint64_t) row_v < height));
+        uint32_t index = inside ? ((uint32_t) row_v >> 19) * asset->width + ((uint32_t) row_u >> 16) : 0;
+        uint8_t shift = (uint8_t) (((uint32_t) row_v >> 16) & 0x07);
+
+        value |= (uint8_t) (((pixels[index] >> shift) & inside) << line);
+        bits |= (uint8_t) (((mask != NULL ? mask[index] >> shift : 0x01) & inside) << line);
+      }
+
+      bits &= rows;
+      *pixel = (uint8_t) ((*pixel & ~bits) | (value & bits));
+    }
+
+    sh1106_dirty_mark(&framebuffer->dirty, (uint8_t) page_addr, (uint8_t) x0, (uint8_t) x1);
+  }
+}
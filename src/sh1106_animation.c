@@ -0,0 +1,231 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "sh1106_animation.h"
+
+static uint16_t sh1106_animation_get16(const uint8_t *buffer) {
+  return (uint16_t) (buffer[0] | (buffer[1] << 8));
+}
+
+static const uint8_t *sh1106_animation_deltas(const struct sh1106_animation *animation) {
+  return &animation->data[SH1106_ANIMATION_HEADER_SIZE + animation->width * animation->pages];
+}
+
+int32_t sh1106_animation_check(const uint8_t *data, uint32_t size) {
+  uint32_t frame_size;
+  uint32_t offset;
+  uint16_t frames;
+  uint16_t frame;
+
+  if (size < SH1106_ANIMATION_HEADER_SIZE || data[0] != 'S' || data[1] != 'H' || data[2] != 'A' || data[3] != 'N') {
+    return -1;
+  }
+
+  frame_size = (uint32_t) data[4] * data[5];
+  frames = sh1106_animation_get16(&data[6]);
+  if (frame_size == 0 || frames == 0 || size - SH1106_ANIMATION_HEADER_SIZE < frame_size) {
+    return -1;
+  }
+
+  offset = SH1106_ANIMATION_HEADER_SIZE + frame_size;
+  for (frame = 0; frame < frames; frame++) {
+    uint32_t position = 0;
+
+    for (;;) {
+      uint8_t skip;
+      uint8_t count;
+
+      if (size - offset < 2) {
+        return -1;
+      }
+      skip = data[offset];
+      count = data[offset + 1];
+      offset += 2;
+      if (skip == 0 && count == 0) {
+        break;
+      }
+
+      position += skip;
+      if (count == 0) {
+        continue;
+      }
+      if (position + count > frame_size || position / data[4] != (position + count - 1) / data[4]
+          || size - offset < count) {
+        return -1;
+      }
+      position += count;
+      offset += count;
+    }
+  }
+
+  return frames;
+}
+
+void sh1106_animation_init(struct sh1106_animation *animation,
+                           const uint8_t *data,
+                           uint8_t *pixels,
+                           uint8_t column,
+                           uint8_t page_addr) {
+  animation->data = data;
+  animation->pixels = pixels;
+  animation->width = data[4];
+  animation->pages = data[5];
+  animation->frames = sh1106_animation_get16(&data[6]);
+  animation->column = column;
+  animation->page_addr = page_addr;
+  animation->delta = sh1106_animation_deltas(animation);
+  animation->frame = UINT16_MAX;
+  animation->loops = 0;
+  animation->speed = SH1106_ANIMATION_SPEED_NORMAL;
+  animation->playing = 0;
+  animation->period = 1;
+  animation->next = 0;
+}
+
+void sh1106_animation_play(struct sh1106_animation *animation, uint32_t now, uint32_t period, uint16_t loops) {
+  animation->delta = sh1106_animation_deltas(animation);
+  animation->frame = UINT16_MAX;
+  animation->loops = loops;
+  animation->speed = SH1106_ANIMATION_SPEED_NORMAL;
+  animation->playing = 1;
+  animation->period = period ? period : 1;
+  animation->next = now;
+}
+
+void sh1106_animation_set_speed(struct sh1106_animation *animation, uint16_t speed) {
+  animation->speed = speed;
+}
+
+void sh1106_animation_stop(struct sh1106_animation *animation) {
+  animation->playing = 0;
+}
+
+static uint16_t sh1106_animation_keyframe(struct sh1106_animation *animation,
+                                          const sh1106_send8_cmd_t send8_cmd,
+                                          const sh1106_send8_data_t send8_data) {
+  const uint8_t *keyframe = &animation->data[SH1106_ANIMATION_HEADER_SIZE];
+  uint16_t size = (uint16_t) (animation->width * animation->pages);
+  uint16_t position;
+
+  memcpy(animation->pixels, keyframe, size);
+  for (position = 0; position < size; position++) {
+    if (position % animation->width == 0) {
+      sh1106_set_page_address(send8_cmd, (uint8_t) (animation->page_addr + position / animation->width));
+      sh1106_set_column_address(send8_cmd, animation->column);
+    }
+    sh1106_write_display_data(send8_data, keyframe[position]);
+  }
+
+  return size;
+}
+
+static uint16_t sh1106_animation_delta(struct sh1106_animation *animation,
+                                       const sh1106_send8_cmd_t send8_cmd,
+                                       const sh1106_send8_data_t send8_data) {
+  const uint8_t *delta = animation->delta;
+  uint16_t position = 0;
+  uint16_t end = UINT16_MAX;
+  uint16_t sent = 0;
+  uint8_t page = UINT8_MAX;
+
+  for (;;) {
+    uint8_t skip = delta[0];
+    uint8_t count = delta[1];
+    uint8_t *pixel;
+
+    delta += 2;
+    if (skip == 0 && count == 0) {
+      break;
+    }
+
+    position = (uint16_t) (position + skip);
+    if (count == 0) {
+      continue;
+    }
+
+    /* Runs that continue where the previous one ended on the same page need no new address */
+    if (position != end || position % animation->width == 0) {
+      if (position / animation->width != page) {
+        page = (uint8_t) (position / animation->width);
+        sh1106_set_page_address(send8_cmd, (uint8_t) (animation->page_addr + page));
+      }
+      sh1106_set_column_address(send8_cmd, (uint8_t) (animation->column + position % animation->width));
+    }
+
+    pixel = &animation->pixels[position];
+    position = (uint16_t) (position + count);
+    end = position;
+    sent = (uint16_t) (sent + count);
+    for (; count; count--) {
+      *pixel = (uint8_t) (*pixel ^ *delta++);
+      sh1106_write_display_data(send8_data, *pixel++);
+    }
+  }
+
+  animation->delta = delta;
+  return sent;
+}
+
+uint16_t sh1106_animation_poll(struct sh1106_animation *animation,
+                               const sh1106_send8_cmd_t send8_cmd,
+                               const sh1106_send8_data_t send8_data,
+                               uint32_t now) {
+  uint32_t period;
+  uint16_t sent;
+
+  if (!animation->playing) {
+    return 0;
+  }
+
+  if (animation->frame == UINT16_MAX) {
+    sent = sh1106_animation_keyframe(animation, send8_cmd, send8_data);
+    animation->frame = 0;
+    animation->next = now;
+  } else {
+    if (animation->speed == 0 || (int32_t) (now - animation->next) < 0) {
+      return 0;
+    }
+
+    sent = sh1106_animation_delta(animation, send8_cmd, send8_data);
+    if (++animation->frame == animation->frames) {
+      animation->frame = 0;
+      animation->delta = sh1106_animation_deltas(animation);
+      if (animation->loops) {
+        animation->loops--;
+      }
+    }
+  }
+
+  if (animation->frame == animation->frames - 1 && animation->loops == 1) {
+    animation->playing = 0;
+  }
+
+  period = animation->period;
+  if (animation->speed) {
+    period = (uint32_t) (((uint64_t) period * SH1106_ANIMATION_SPEED_NORMAL) / animation->speed);
+  }
+  animation->next += period;
+  if ((int32_t) (now - animation->next) >= 0) {
+    animation->next = now + period;
+  }
+  return sent;
+}
@@ -0,0 +1,198 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+#include "sh1106_asset.h"
+
+static uint16_t sh1106_asset_get16(const uint8_t *buffer) {
+  return (uint16_t) (buffer[0] | (buffer[1] << 8));
+}
+
+static uint32_t sh1106_asset_get32(const uint8_t *buffer) {
+  return (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16)
+      | ((uint32_t) buffer[3] << 24);
+}
+
+static uint32_t sh1106_asset_size(const struct sh1106_asset *asset) {
+  uint32_t size = (uint32_t) asset->width * asset->pages;
+
+  return asset->kind == SH1106_ASSET_SPRITE ? 2 * size : size;
+}
+
+int32_t sh1106_asset_bundle_check(const uint8_t *bundle, uint32_t size) {
+  struct sh1106_asset asset;
+  uint16_t count;
+  uint16_t id;
+
+  if (size < SH1106_ASSET_HEADER_SIZE
+      || bundle[0] != 'S' || bundle[1] != 'H' || bundle[2] != 'A' || bundle[3] != 'B') {
+    return -1;
+  }
+
+  count = sh1106_asset_get16(&bundle[4]);
+  if (size < SH1106_ASSET_HEADER_SIZE + (uint32_t) count * SH1106_ASSET_ENTRY_SIZE) {
+    return -1;
+  }
+
+  for (id = 0; id < count; id++) {
+    const uint8_t *entry = &bundle[SH1106_ASSET_HEADER_SIZE + id * SH1106_ASSET_ENTRY_SIZE];
+    uint32_t offset = sh1106_asset_get32(entry);
+
+    if (offset > size) {
+      return -1;
+    }
+
+    /* Divide rather than multiply the frame size by the count, the product can wrap */
+    sh1106_asset_get(bundle, id, &asset);
+    if (asset.kind > SH1106_ASSET_FONT || asset.width == 0 || asset.pages == 0 || asset.pages > SH1106_PAGES
+        || asset.count == 0 || asset.count > (size - offset) / sh1106_asset_size(&asset)) {
+      return -1;
+    }
+  }
+
+  return count;
+}
+
+int sh1106_asset_get(const uint8_t *bundle, uint16_t id, struct sh1106_asset *asset) {
+  const uint8_t *entry;
+
+  if (id >= sh1106_asset_get16(&bundle[4])) {
+    return -1;
+  }
+
+  entry = &bundle[SH1106_ASSET_HEADER_SIZE + id * SH1106_ASSET_ENTRY_SIZE];
+  asset->frames = &bundle[sh1106_asset_get32(&entry[0])];
+  asset->count = sh1106_asset_get16(&entry[4]);
+  asset->kind = entry[6];
+  asset->width = entry[7];
+  asset->pages = entry[8];
+  asset->first = entry[9];
+  return 0;
+}
+
+const uint8_t *sh1106_asset_frame(const struct sh1106_asset *asset, uint16_t frame) {
+  if (frame >= asset->count) {
+    return NULL;
+  }
+
+  return &asset->frames[frame * sh1106_asset_size(asset)];
+}
+
+const uint8_t *sh1106_asset_glyph(const struct sh1106_asset *font, uint8_t code) {
+  if (code < font->first) {
+    return NULL;
+  }
+
+  return sh1106_asset_frame(font, (uint16_t) (code - font->first));
+}
+
+static void sh1106_asset_put(struct sh1106_framebuffer *framebuffer,
+                             int16_t page_addr,
+                             uint8_t x0,
+                             uint8_t x1,
+                             const uint8_t *pixels,
+                             const uint8_t *mask,
+                             uint8_t shift,
+                             uint8_t down) {
+  int16_t top = (int16_t) (page_addr * 8);
+  uint8_t rows = 0xFF;
+  uint8_t *pixel;
+  uint8_t *end;
+
+  if (page_addr < 0 || page_addr >= framebuffer->pages
+      || top + 8 <= framebuffer->clip_y0 || top >= framebuffer->clip_y1) {
+    return;
+  }
+
+  if (framebuffer->clip_y0 > top) {
+    rows &= (uint8_t) (0xFF << (framebuffer->clip_y0 - top));
+  }
+  if (framebuffer->clip_y1 < top + 8) {
+    rows &= (uint8_t) (0xFF >> (top + 8 - framebuffer->clip_y1));
+  }
+
+  pixel = &framebuffer->pixels[page_addr * SH1106_COLUMNS + x0];
+  end = pixel + (x1 - x0);
+  for (; pixel < end; pixel++, pixels++) {
+    uint8_t bits = mask != NULL ? *mask++ : 0xFF;
+    uint8_t byte = *pixels;
+
+    if (down) {
+      bits = (uint8_t) (bits >> (8 - shift));
+      byte = (uint8_t) (byte >> (8 - shift));
+    } else {
+      bits = (uint8_t) (bits << shift);
+      byte = (uint8_t) (byte << shift);
+    }
+    bits &= rows;
+    *pixel = (uint8_t) ((*pixel & ~bits) | (byte & bits));
+  }
+
+  sh1106_dirty_mark(&framebuffer->dirty, (uint8_t) page_addr, x0, (uint8_t) (x1 - 1));
+}
+
+void sh1106_framebuffer_draw_asset(struct sh1106_framebuffer *framebuffer,
+                                   const struct sh1106_asset *asset,
+                                   uint16_t frame,
+                                   int16_t x,
+                                   int16_t y) {
+  const uint8_t *pixels = sh1106_asset_frame(asset, frame);
+  const uint8_t *mask = NULL;
+  int16_t x0;
+  int16_t x1;
+  uint8_t page;
+
+  if (pixels == NULL) {
+    return;
+  }
+  if (asset->kind == SH1106_ASSET_SPRITE) {
+    mask = pixels + asset->width * asset->pages;
+  }
+
+  x = (int16_t) (x + framebuffer->origin_x);
+  y = (int16_t) (y + framebuffer->origin_y);
+  x0 = x < framebuffer->clip_x0 ? framebuffer->clip_x0 : x;
+  x1 = (int16_t) (x + asset->width) > framebuffer->clip_x1 ? framebuffer->clip_x1 : (int16_t) (x + asset->width);
+  if (x0 >= x1) {
+    return;
+  }
+
+  for (page = 0; page < asset->pages; page++) {
+    int16_t line = (int16_t) (y + page * 8);
+    const uint8_t *source = &pixels[page * asset->width + (x0 - x)];
+    const uint8_t *source_mask = mask != NULL ? &mask[page * asset->width + (x0 - x)] : NULL;
+    int16_t page_addr;
+    uint8_t shift;
+
+    if (line + 8 <= framebuffer->clip_y0 || line >= framebuffer->clip_y1) {
+      continue;
+    }
+
+    /* line > -8 here, keep the division on non-negative numbers */
+    page_addr = (int16_t) ((line + 8) / 8 - 1);
+    shift = (uint8_t) ((line + 8) & 0x07);
+
+    sh1106_asset_put(framebuffer, page_addr, (uint8_t) x0, (uint8_t) x1, source, source_mask, shift, 0);
+    if (shift != 0) {
+      page_addr = (int16_t) (page_addr + 1);
+      sh1106_asset_put(framebuffer, page_addr, (uint8_t) x0, (uint8_t) x1, source, source_mask, shift, 1);
+    }
+  }
+}
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_budget.h"
+
+static uint8_t sh1106_budget_clamp(int16_t value, uint8_t min, uint8_t max) {
+  if (value < min) {
+    return min;
+  }
+  if (value > max) {
+    return max;
+  }
+  return (uint8_t) value;
+}
+
+static uint8_t sh1106_budget_test(const uint8_t *pending, uint8_t column) {
+  return (uint8_t) ((pending[column >> 3] >> (column & 0x07)) & 0x01);
+}
+
+/* First pending column from column to last, last + 1 if there is none */
+static uint8_t sh1106_budget_next(const uint8_t *pending, uint8_t column, uint8_t last) {
+  while (column <= last) {
+    if (!(column & 0x07) && !pending[column >> 3]) {
+      column = (uint8_t) (column + 8);
+    } else if (sh1106_budget_test(pending, column)) {
+      return column;
+    } else {
+      column++;
+    }
+  }
+  return (uint8_t) (last + 1);
+}
+
+/* Moves the dirty set of the framebuffer into the pending columns */
+static void sh1106_budget_absorb(struct sh1106_budget *budget) {
+  struct sh1106_dirty *dirty = &budget->framebuffer->dirty;
+  uint8_t page_addr;
+
+  for (page_addr = 0; page_addr < budget->framebuffer->pages; page_addr++) {
+    uint8_t column;
+
+    if (!(dirty->pages & (1 << page_addr))) {
+      continue;
+    }
+    for (column = dirty->first[page_addr]; column <= dirty->last[page_addr]; column++) {
+      budget->pending[page_addr][column >> 3] |= (uint8_t) (1 << (column & 0x07));
+    }
+  }
+
+  sh1106_dirty_reset(dirty);
+}
+
+void sh1106_budget_init(struct sh1106_budget *budget, struct sh1106_framebuffer *framebuffer, sh1106_clock_t clock) {
+  budget->framebuffer = framebuffer;
+  budget->count = 0;
+  budget->clock = clock;
+  memset(budget->pending, 0x00, sizeof(budget->pending));
+  memset(&budget->metrics, 0x00, sizeof(budget->metrics));
+}
+
+int sh1106_budget_add_region(struct sh1106_budget *budget,
+                             int16_t x,
+                             int16_t y,
+                             int16_t width,
+                             int16_t height,
+                             uint8_t priority) {
+  uint8_t lines = (uint8_t) (budget->framebuffer->pages * 8);
+  uint8_t x0 = sh1106_budget_clamp(x, 0, SH1106_COLUMNS);
+  uint8_t x1 = sh1106_budget_clamp((int16_t) (x + width), x0, SH1106_COLUMNS);
+  uint8_t y0 = sh1106_budget_clamp(y, 0, lines);
+  uint8_t y1 = sh1106_budget_clamp((int16_t) (y + height), y0, lines);
+  uint8_t i;
+
+  if (budget->count == SH1106_BUDGET_MAX_REGIONS || x0 >= x1 || y0 >= y1) {
+    return -1;
+  }
+
+  /* Keep the regions by descending priority, equal priorities in the order they were added */
+  for (i = budget->count; i > 0 && budget->regions[i - 1].priority < priority; i--) {
+    budget->regions[i] = budget->regions[i - 1];
+  }
+  budget->regions[i].first_page = (uint8_t) (y0 / 8);
+  budget->regions[i].last_page = (uint8_t) ((y1 - 1) / 8);
+  budget->regions[i].first = x0;
+  budget->regions[i].last = (uint8_t) (x1 - 1);
+  budget->regions[i].priority = priority;
+  budget->count++;
+  return 0;
+}
+
+uint16_t sh1106_budget_flush(struct sh1106_budget *budget,
+                             const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             uint16_t bytes,
+                             uint32_t ticks) {
+  struct sh1106_budget_region everything;
+  uint32_t start = budget->clock != NULL ? budget->clock() : 0;
+  uint16_t sent = 0;
+  uint8_t page = UINT8_MAX;
+  uint8_t next = 0;
+  uint8_t stopped = 0;
+  uint8_t i;
+
+  sh1106_budget_absorb(budget);
+
+  /* Columns outside of every region come last */
+  everything.first_page = 0;
+  everything.last_page = (uint8_t) (budget->framebuffer->pages - 1);
+  everything.first = 0;
+  everything.last = SH1106_COLUMNS - 1;
+
+  for (i = 0; i <= budget->count && !stopped; i++) {
+    const struct sh1106_budget_region *region = i < budget->count ? &budget->regions[i] : &everything;
+    uint8_t page_addr;
+
+    for (page_addr = region->first_page; page_addr <= region->last_page && !stopped; page_addr++) {
+      uint8_t *pending = budget->pending[page_addr];
+      uint8_t column = sh1106_budget_next(pending, region->first, region->last);
+
+      while (column <= region->last) {
+        uint8_t continues = page_addr == page && column == next;
+        uint16_t cost = continues ? 0 : 3;
+        uint8_t count = 0;
+        const uint8_t *pixel;
+        const uint8_t *end;
+
+        /* The first chunk goes out whatever the clock says, so a flush always makes progress */
+        if (ticks && sent != 0 && budget->clock != NULL && budget->clock() - start >= ticks) {
+          stopped = 1;
+          break;
+        }
+
+        while (column + count <= region->last && count < SH1106_BUDGET_CHUNK
+               && sh1106_budget_test(pending, (uint8_t) (column + count))
+               && (!bytes || sent + cost + count < bytes)) {
+          count++;
+        }
+        if (count == 0) {
+          stopped = 1;
+          break;
+        }
+
+        if (!continues) {
+          sh1106_set_page_address(send8_cmd, page_addr);
+          sh1106_set_column_address(send8_cmd, column);
+        }
+        pixel = &budget->framebuffer->pixels[page_addr * SH1106_COLUMNS + column];
+        for (end = pixel + count; pixel < end; pixel++) {
+          pending[column >> 3] &= (uint8_t) ~(1 << (column & 0x07));
+          sh1106_write_display_data(send8_data, *pixel);
+          column++;
+        }
+
+        sent = (uint16_t) (sent + cost + count);
+        page = page_addr;
+        next = column;
+        column = sh1106_budget_next(pending, column, region->last);
+      }
+    }
+  }
+
+  budget->metrics.calls++;
+  budget->metrics.bytes += sent;
+  if (sent > budget->metrics.max_bytes) {
+    budget->metrics.max_bytes = sent;
+  }
+  if (budget->clock != NULL) {
+    uint32_t elapsed = budget->clock() - start;
+
+    if (elapsed > budget->metrics.max_ticks) {
+      budget->metrics.max_ticks = elapsed;
+    }
+  }
+  if (stopped && sh1106_budget_pending(budget)) {
+    budget->metrics.partial++;
+  }
+  return sent;
+}
+
+int sh1106_budget_pending(const struct sh1106_budget *budget) {
+  uint8_t page_addr;
+  uint8_t i;
+
+  if (budget->framebuffer->dirty.pages) {
+    return 1;
+  }
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    for (i = 0; i < SH1106_BUDGET_OCCUPANCY_SIZE; i++) {
+      if (budget->pending[page_addr][i]) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
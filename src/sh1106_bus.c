@@ -0,0 +1,152 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_bus.h"
+#include "sh1106_trace.h"
+
+/** I2C START, slave address with ACK and control byte with ACK */
+#define SH1106_BUS_I2C_HEADER_BITS (1 + 9 + 9)
+/** I2C STOP */
+#define SH1106_BUS_I2C_STOP_BITS 1
+
+void sh1106_bus_model_init(struct sh1106_bus_model *model, enum sh1106_bus bus, uint32_t clock) {
+  model->bus = bus;
+  model->clock = clock;
+
+  switch (bus) {
+    case SH1106_BUS_SPI_4_WIRE:
+    case SH1106_BUS_SPI_3_WIRE: {
+      model->transaction_overhead = 100;
+      model->dc_switch = 50;
+      model->transaction_max = 0;
+      break;
+    }
+    case SH1106_BUS_I2C: {
+      model->transaction_overhead = 1300;
+      model->dc_switch = 0;
+      model->transaction_max = 32;
+      break;
+    }
+  }
+}
+
+void sh1106_bus_reset(struct sh1106_bus_stats *stats) {
+  stats->commands = 0;
+  stats->data = 0;
+  stats->transactions = 0;
+  stats->dc_switches = 0;
+  stats->bits = 0;
+  stats->overhead = 0;
+  stats->time = 0;
+  stats->kind = 0;
+  stats->dc = 0;
+  stats->length = 0;
+}
+
+static void sh1106_bus_open(const struct sh1106_bus_model *model, struct sh1106_bus_stats *stats, uint8_t kind) {
+  if (model->bus == SH1106_BUS_SPI_4_WIRE && stats->dc != kind) {
+    stats->dc_switches++;
+    stats->overhead += model->dc_switch;
+    stats->dc = kind;
+  }
+
+  if (model->bus == SH1106_BUS_I2C) {
+    stats->bits += SH1106_BUS_I2C_HEADER_BITS + SH1106_BUS_I2C_STOP_BITS;
+  }
+
+  stats->transactions++;
+  stats->overhead += model->transaction_overhead;
+  stats->kind = kind;
+  stats->length = 0;
+}
+
+void sh1106_bus_account(const struct sh1106_bus_model *model,
+                        struct sh1106_bus_stats *stats,
+                        uint8_t data,
+                        uint32_t count) {
+  uint8_t kind = data ? 2 : 1;
+  uint8_t bits_per_byte = model->bus == SH1106_BUS_SPI_4_WIRE ? 8 : 9;
+
+  if (data) {
+    stats->data += count;
+  } else {
+    stats->commands += count;
+  }
+
+  while (count != 0) {
+    uint32_t n = count;
+
+    if (stats->kind != kind || (model->transaction_max != 0 && stats->length == model->transaction_max)) {
+      sh1106_bus_open(model, stats, kind);
+    }
+
+    if (model->transaction_max != 0 && n > (uint32_t) (model->transaction_max - stats->length)) {
+      n = model->transaction_max - stats->length;
+    }
+
+    stats->bits += (uint64_t) n * bits_per_byte;
+    stats->length = (uint16_t) (stats->length + n);
+    count -= n;
+  }
+
+  /* From the totals, so that accounting byte by byte does not round down every call */
+  stats->time = stats->overhead;
+  if (model->clock != 0) {
+    stats->time += stats->bits * 1000000000ULL / model->clock;
+  }
+}
+
+void sh1106_bus_end(struct sh1106_bus_stats *stats) {
+  stats->kind = 0;
+  stats->length = 0;
+}
+
+int sh1106_bus_account_trace(const struct sh1106_bus_model *model,
+                             struct sh1106_bus_stats *stats,
+                             const uint8_t *trace,
+                             uint32_t size) {
+  struct sh1106_trace_record record;
+  uint32_t ticks_per_second;
+  uint32_t offset = sh1106_trace_read_header(trace, size, &ticks_per_second);
+  int status;
+
+  if (offset == 0) {
+    return -1;
+  }
+
+  record.time = 0;
+  while ((status = sh1106_trace_read(trace, size, &offset, &record)) == 1) {
+    sh1106_bus_account(model, stats, record.data, record.size);
+  }
+  sh1106_bus_end(stats);
+
+  return status;
+}
+
+uint32_t sh1106_bus_max_fps(const struct sh1106_bus_stats *frame) {
+  if (frame->time == 0) {
+    return 0;
+  }
+
+  return (uint32_t) (100000000000ULL / frame->time);
+}
+
+uint32_t sh1106_bus_utilization(const struct sh1106_bus_stats *frame, uint16_t fps) {
+  return (uint32_t) (frame->time * fps / 100000ULL);
+}
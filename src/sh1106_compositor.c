@@ -0,0 +1,150 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_compositor.h"
+
+void sh1106_layer_init(struct sh1106_layer *layer, uint8_t *pixels, const uint8_t *mask) {
+  sh1106_framebuffer_init(&layer->framebuffer, pixels, SH1106_PAGES);
+  layer->mask = mask;
+}
+
+void sh1106_compositor_init(struct sh1106_compositor *compositor, uint8_t *pixels) {
+  compositor->count = 0;
+  compositor->timing = NULL;
+  sh1106_framebuffer_init(&compositor->output, pixels, SH1106_PAGES);
+}
+
+int sh1106_compositor_add(struct sh1106_compositor *compositor, struct sh1106_layer *layer) {
+  if (compositor->count >= SH1106_COMPOSITOR_MAX_LAYERS) {
+    return -1;
+  }
+
+  compositor->layers[compositor->count++] = layer;
+  sh1106_framebuffer_invalidate(&layer->framebuffer);
+  return 0;
+}
+
+static void sh1106_compositor_or(uint8_t *output, const uint8_t *pixels, uint8_t size) {
+  uint32_t word;
+  uint32_t pixel;
+
+  for (; size >= 4; size -= 4, output += 4, pixels += 4) {
+    memcpy(&word, output, sizeof(word));
+    memcpy(&pixel, pixels, sizeof(pixel));
+    word |= pixel;
+    memcpy(output, &word, sizeof(word));
+  }
+
+  for (; size != 0; size--, output++, pixels++) {
+    *output |= *pixels;
+  }
+}
+
+static void sh1106_compositor_blend(uint8_t *output, const uint8_t *pixels, const uint8_t *mask, uint8_t size) {
+  uint32_t word;
+  uint32_t pixel;
+  uint32_t bits;
+
+  for (; size >= 4; size -= 4, output += 4, pixels += 4, mask += 4) {
+    memcpy(&word, output, sizeof(word));
+    memcpy(&pixel, pixels, sizeof(pixel));
+    memcpy(&bits, mask, sizeof(bits));
+    word = (word & ~bits) | (pixel & bits);
+    memcpy(output, &word, sizeof(word));
+  }
+
+  for (; size != 0; size--, output++, pixels++, mask++) {
+    *output = (uint8_t) ((*output & ~*mask) | (*pixels & *mask));
+  }
+}
+
+void sh1106_compositor_compose(struct sh1106_compositor *compositor) {
+  struct sh1106_dirty damage;
+  uint8_t page_addr;
+  uint8_t index;
+
+  sh1106_dirty_reset(&damage);
+  for (index = 0; index < compositor->count; index++) {
+    struct sh1106_dirty *dirty = &compositor->layers[index]->framebuffer.dirty;
+
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      if (dirty->pages & (1 << page_addr)) {
+        sh1106_dirty_mark(&damage, page_addr, dirty->first[page_addr], dirty->last[page_addr]);
+      }
+    }
+    sh1106_dirty_reset(dirty);
+  }
+
+  if (compositor->timing != NULL) {
+    SH1106_TIMING_STAGE(compositor->timing, SH1106_STAGE_DIFF);
+  }
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    uint16_t offset;
+    uint8_t size;
+    uint8_t *output;
+
+    if (!(damage.pages & (1 << page_addr))) {
+      continue;
+    }
+
+    offset = (uint16_t) (page_addr * SH1106_COLUMNS + damage.first[page_addr]);
+    size = (uint8_t) (damage.last[page_addr] - damage.first[page_addr] + 1);
+    output = &compositor->output.pixels[offset];
+
+    memset(output, 0x00, size);
+    for (index = 0; index < compositor->count; index++) {
+      const struct sh1106_layer *layer = compositor->layers[index];
+
+      if (layer->mask == NULL) {
+        sh1106_compositor_or(output, &layer->framebuffer.pixels[offset], size);
+      } else {
+        sh1106_compositor_blend(output, &layer->framebuffer.pixels[offset], &layer->mask[offset], size);
+      }
+    }
+
+    sh1106_dirty_mark(&compositor->output.dirty, page_addr, damage.first[page_addr], damage.last[page_addr]);
+  }
+
+  if (compositor->timing != NULL) {
+    SH1106_TIMING_STAGE(compositor->timing, SH1106_STAGE_ENCODE);
+  }
+}
+
+uint16_t sh1106_compositor_flush(const sh1106_send8_cmd_t send8_cmd,
+                                 const sh1106_send8_data_t send8_data,
+                                 struct sh1106_compositor *compositor) {
+  uint16_t sent;
+
+  if (compositor->timing != NULL) {
+    SH1106_TIMING_STAGE(compositor->timing, SH1106_STAGE_RENDER);
+  }
+
+  sh1106_compositor_compose(compositor);
+  sent = sh1106_framebuffer_flush(send8_cmd, send8_data, &compositor->output);
+
+  if (compositor->timing != NULL) {
+    SH1106_TIMING_STAGE(compositor->timing, SH1106_STAGE_TRANSFER);
+    SH1106_TIMING_END(compositor->timing);
+  }
+
+  return sent;
+}
@@ -0,0 +1,237 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+#include "sh1106_effects.h"
+
+#define SH1106_EFFECTS_LINES (SH1106_PAGES * 8)
+
+void sh1106_effects_init(struct sh1106_effects *effects) {
+  uint8_t effect;
+
+  effects->registers.start_line = 0;
+  effects->registers.display_offset = 0;
+  effects->registers.display_direction = SH1106_DISPLAY_NORMAL_DIRECTION;
+  effects->effect = SH1106_EFFECT_NONE;
+  effects->framebuffer = NULL;
+  for (effect = 0; effect < SH1106_EFFECTS; effect++) {
+    effects->metrics.runs[effect] = 0;
+    effects->metrics.bytes[effect] = 0;
+  }
+}
+
+static int sh1106_effects_start(struct sh1106_effects *effects,
+                                enum sh1106_effect effect,
+                                uint32_t now,
+                                uint32_t period,
+                                uint16_t steps) {
+  if (effects->effect != SH1106_EFFECT_NONE) {
+    return -1;
+  }
+
+  effects->effect = effect;
+  effects->start = now;
+  effects->period = period ? period : 1;
+  effects->steps = steps;
+  effects->step = UINT16_MAX;
+  effects->metrics.runs[effect]++;
+  return 0;
+}
+
+int sh1106_effect_blink(struct sh1106_effects *effects, uint32_t now, uint32_t period, uint8_t count) {
+  return sh1106_effects_start(effects, SH1106_EFFECT_BLINK, now, period, (uint16_t) (2 * count));
+}
+
+int sh1106_effect_invert_pulse(struct sh1106_effects *effects, uint32_t now, uint32_t period, uint8_t count) {
+  return sh1106_effects_start(effects, SH1106_EFFECT_INVERT_PULSE, now, period, (uint16_t) (2 * count));
+}
+
+int sh1106_effect_shake(struct sh1106_effects *effects,
+                        uint32_t now,
+                        uint32_t period,
+                        uint8_t count,
+                        uint8_t amplitude) {
+  if (sh1106_effects_start(effects, SH1106_EFFECT_SHAKE, now, period, (uint16_t) (4 * count))) {
+    return -1;
+  }
+
+  effects->lines = amplitude < SH1106_EFFECTS_LINES ? amplitude : SH1106_EFFECTS_LINES - 1;
+  return 0;
+}
+
+int sh1106_effect_slide_in(struct sh1106_effects *effects,
+                           uint32_t now,
+                           uint32_t period,
+                           struct sh1106_framebuffer *framebuffer,
+                           uint8_t lines) {
+  if (lines == 0 || lines > SH1106_EFFECTS_LINES) {
+    lines = SH1106_EFFECTS_LINES;
+  }
+  /* a page of the new frame replaces the page of the old frame that has just scrolled out, never a visible one */
+  lines = (uint8_t) ((lines + 7) & ~7);
+
+  /* the last step, a full scroll, is the restored start line */
+  if (sh1106_effects_start(effects,
+                           SH1106_EFFECT_SLIDE_IN,
+                           now,
+                           period,
+                           (uint16_t) ((SH1106_EFFECTS_LINES + lines - 1) / lines - 1))) {
+    return -1;
+  }
+
+  effects->lines = lines;
+  effects->written = 0;
+  effects->framebuffer = framebuffer;
+  return 0;
+}
+
+static void sh1106_effects_write(struct sh1106_effects *effects,
+                                 const sh1106_send8_cmd_t send8_cmd,
+                                 const sh1106_send8_data_t send8_data,
+                                 uint8_t pages) {
+  const struct sh1106_framebuffer *framebuffer = effects->framebuffer;
+
+  for (; effects->written < pages; effects->written++) {
+    uint8_t page_addr = (uint8_t) ((effects->registers.start_line / 8 + effects->written) % SH1106_PAGES);
+
+    if (effects->written >= framebuffer->pages) {
+      continue;
+    }
+
+    sh1106_write_span(send8_cmd,
+                      send8_data,
+                      page_addr,
+                      0,
+                      &framebuffer->pixels[effects->written * SH1106_COLUMNS],
+                      SH1106_COLUMNS);
+    effects->metrics.bytes[SH1106_EFFECT_SLIDE_IN] += 3 + SH1106_COLUMNS;
+  }
+}
+
+static void sh1106_effects_apply(struct sh1106_effects *effects,
+                                 const sh1106_send8_cmd_t send8_cmd,
+                                 const sh1106_send8_data_t send8_data,
+                                 uint16_t step) {
+  const struct sh1106_effect_registers *registers = &effects->registers;
+  uint32_t *bytes = &effects->metrics.bytes[effects->effect];
+
+  switch (effects->effect) {
+    case SH1106_EFFECT_BLINK: {
+      sh1106_set_display_state(send8_cmd, step & 1 ? SH1106_OLED_ON : SH1106_OLED_OFF);
+      *bytes += 1;
+      break;
+    }
+    case SH1106_EFFECT_INVERT_PULSE: {
+      enum sh1106_display_direction inverted = registers->display_direction == SH1106_DISPLAY_NORMAL_DIRECTION
+                                               ? SH1106_DISPLAY_REVERSE_DIRECTION
+                                               : SH1106_DISPLAY_NORMAL_DIRECTION;
+
+      sh1106_set_display_direction(send8_cmd, step & 1 ? registers->display_direction : inverted);
+      *bytes += 1;
+      break;
+    }
+    case SH1106_EFFECT_SHAKE: {
+      /* up, center, down, center */
+      int16_t offset = registers->display_offset;
+
+      if (step % 4 == 0) {
+        offset = (int16_t) (offset + effects->lines);
+      } else if (step % 4 == 2) {
+        offset = (int16_t) (offset - effects->lines + SH1106_EFFECTS_LINES);
+      }
+      sh1106_set_display_offset(send8_cmd, (uint8_t) (offset % SH1106_EFFECTS_LINES));
+      *bytes += 2;
+      break;
+    }
+    case SH1106_EFFECT_SLIDE_IN: {
+      uint8_t shift = (uint8_t) ((step + 1) * effects->lines);
+
+      sh1106_effects_write(effects, send8_cmd, send8_data, (uint8_t) ((shift + 7) / 8));
+      sh1106_set_display_start_line(send8_cmd, (uint8_t) ((registers->start_line + shift) % SH1106_EFFECTS_LINES));
+      *bytes += 1;
+      break;
+    }
+    case SH1106_EFFECT_NONE: {
+      break;
+    }
+  }
+}
+
+void sh1106_effects_stop(struct sh1106_effects *effects,
+                         const sh1106_send8_cmd_t send8_cmd,
+                         const sh1106_send8_data_t send8_data) {
+  const struct sh1106_effect_registers *registers = &effects->registers;
+  uint32_t *bytes = &effects->metrics.bytes[effects->effect];
+
+  switch (effects->effect) {
+    case SH1106_EFFECT_BLINK: {
+      sh1106_set_display_state(send8_cmd, SH1106_OLED_ON);
+      *bytes += 1;
+      break;
+    }
+    case SH1106_EFFECT_INVERT_PULSE: {
+      sh1106_set_display_direction(send8_cmd, registers->display_direction);
+      *bytes += 1;
+      break;
+    }
+    case SH1106_EFFECT_SHAKE: {
+      sh1106_set_display_offset(send8_cmd, registers->display_offset);
+      *bytes += 2;
+      break;
+    }
+    case SH1106_EFFECT_SLIDE_IN: {
+      sh1106_effects_write(effects, send8_cmd, send8_data, SH1106_PAGES);
+      sh1106_set_display_start_line(send8_cmd, registers->start_line);
+      sh1106_dirty_reset(&effects->framebuffer->dirty);
+      effects->framebuffer = NULL;
+      *bytes += 1;
+      break;
+    }
+    case SH1106_EFFECT_NONE: {
+      break;
+    }
+  }
+
+  effects->effect = SH1106_EFFECT_NONE;
+}
+
+enum sh1106_effect sh1106_effects_poll(struct sh1106_effects *effects,
+                                       const sh1106_send8_cmd_t send8_cmd,
+                                       const sh1106_send8_data_t send8_data,
+                                       uint32_t now) {
+  uint32_t step;
+
+  if (effects->effect == SH1106_EFFECT_NONE) {
+    return SH1106_EFFECT_NONE;
+  }
+
+  step = (now - effects->start) / effects->period;
+  if (step >= effects->steps) {
+    sh1106_effects_stop(effects, send8_cmd, send8_data);
+    return SH1106_EFFECT_NONE;
+  }
+
+  if (step != effects->step) {
+    sh1106_effects_apply(effects, send8_cmd, send8_data, (uint16_t) step);
+    effects->step = (uint16_t) step;
+  }
+
+  return effects->effect;
+}
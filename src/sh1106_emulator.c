@@ -0,0 +1,171 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_emulator.h"
+#include "sh1106_syscfg.h"
+
+void sh1106_emulator_reset(struct sh1106_emulator *emulator) {
+  memset(emulator, 0x00, sizeof(*emulator));
+  emulator->contrast = 0x80;
+  emulator->multiplex_ratio = 0x3F;
+  emulator->dc_dc = 1;
+  emulator->clock = 0x50;
+  emulator->pre_charge = 0x22;
+  emulator->pads = SH1106_ALTERNATIVE_MODE_SET;
+  emulator->vcom = 0x35;
+}
+
+static void sh1106_emulator_parameter(struct sh1106_emulator *emulator, uint8_t cmd) {
+  switch (emulator->pending) {
+    case SH1106_CONTRAST_CONTROL_MODE_SET: {
+      emulator->contrast = cmd;
+      break;
+    }
+    case SH1106_MULTIPLE_RATION_MODE_SET: {
+      emulator->multiplex_ratio = SH1106_MULTIPLEX_RATION_DATA_SET(cmd);
+      break;
+    }
+    case SH1106_DC_DC_CONTROL_MODE_SET: {
+      emulator->dc_dc = cmd == SH1106_DC_DC_ON_MODE_SET;
+      break;
+    }
+    case SH1106_DISPLAY_OFFSET_MODE_SET: {
+      emulator->display_offset = SH1106_DISPLAY_OFFSET_DATA_SET(cmd);
+      break;
+    }
+    case SH1106_DIVIDE_RATIO_OSCILLATOR_FREQUENCY_MODE_SET: {
+      emulator->clock = cmd;
+      break;
+    }
+    case SH1106_PRE_CHARGE_PERIOD_MODE_SET: {
+      emulator->pre_charge = cmd;
+      break;
+    }
+    case SH1106_COMMON_PADS_HARDWARE_CONFIGURATION_MODE_SET: {
+      emulator->pads = cmd;
+      break;
+    }
+    case SH1106_VCOM_DESELECT_LEVEL_MODE_SET: {
+      emulator->vcom = cmd;
+      break;
+    }
+  }
+
+  emulator->pending = 0;
+}
+
+void sh1106_emulator_cmd(struct sh1106_emulator *emulator, uint8_t cmd) {
+  emulator->commands++;
+
+  if (emulator->pending) {
+    sh1106_emulator_parameter(emulator, cmd);
+    return;
+  }
+
+  switch (cmd & 0xF0) {
+    case 0x00: {
+      emulator->column_addr = (uint8_t) ((emulator->column_addr & 0xF0) | (cmd & 0x0F));
+      return;
+    }
+    case 0x10: {
+      emulator->column_addr = (uint8_t) ((emulator->column_addr & 0x0F) | ((cmd & 0x0F) << 4));
+      return;
+    }
+    case 0x30: {
+      emulator->pump = (uint8_t) (cmd & 0x03);
+      return;
+    }
+    case 0x40:
+    case 0x50:
+    case 0x60:
+    case 0x70: {
+      emulator->start_line = (uint8_t) (cmd & 0x3F);
+      return;
+    }
+    case 0xB0: {
+      emulator->page_addr = (uint8_t) (cmd & 0x0F);
+      return;
+    }
+    case 0xC0: {
+      emulator->scan_flipped = (cmd & 0x08) != 0;
+      return;
+    }
+  }
+
+  switch (cmd) {
+    case SH1106_SET_SEGMENT_RE_MAP_NORMAL_DIRECTION:
+    case SH1106_SET_SEGMENT_RE_MAP_REVERSE_DIRECTION: {
+      emulator->segment_re_map = cmd == SH1106_SET_SEGMENT_RE_MAP_REVERSE_DIRECTION;
+      break;
+    }
+    case SH1106_SET_ENTIRE_DISPLAY_OFF:
+    case SH1106_SET_ENTIRE_DISPLAY_ON: {
+      emulator->entire_display_on = cmd == SH1106_SET_ENTIRE_DISPLAY_ON;
+      break;
+    }
+    case SH1106_SET_NORMAL_DISPLAY_DIRECTION:
+    case SH1106_SET_REVERSE_DISPLAY_DIRECTION: {
+      emulator->reverse = cmd == SH1106_SET_REVERSE_DISPLAY_DIRECTION;
+      break;
+    }
+    case SH1106_DISPLAY_OFF_OLED:
+    case SH1106_DISPLAY_ON_OLED: {
+      emulator->display_on = cmd == SH1106_DISPLAY_ON_OLED;
+      break;
+    }
+    case SH1106_READ_MODIFY_WRITE: {
+      emulator->rmw = 1;
+      emulator->rmw_column_addr = emulator->column_addr;
+      break;
+    }
+    case SH1106_END: {
+      if (emulator->rmw) {
+        emulator->rmw = 0;
+        emulator->column_addr = emulator->rmw_column_addr;
+      }
+      break;
+    }
+    case SH1106_CONTRAST_CONTROL_MODE_SET:
+    case SH1106_MULTIPLE_RATION_MODE_SET:
+    case SH1106_DC_DC_CONTROL_MODE_SET:
+    case SH1106_DISPLAY_OFFSET_MODE_SET:
+    case SH1106_DIVIDE_RATIO_OSCILLATOR_FREQUENCY_MODE_SET:
+    case SH1106_PRE_CHARGE_PERIOD_MODE_SET:
+    case SH1106_COMMON_PADS_HARDWARE_CONFIGURATION_MODE_SET:
+    case SH1106_VCOM_DESELECT_LEVEL_MODE_SET: {
+      emulator->pending = cmd;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+void sh1106_emulator_data(struct sh1106_emulator *emulator, uint8_t data) {
+  emulator->data++;
+
+  if (emulator->page_addr >= SH1106_PAGES || emulator->column_addr >= SH1106_COLUMNS) {
+    return;
+  }
+
+  emulator->ram[emulator->page_addr][emulator->column_addr++] = SH1106_WRITE_DISPLAY_DATA(data);
+}
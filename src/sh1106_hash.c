@@ -0,0 +1,157 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_hash.h"
+
+#define SH1106_HASH_SEED 0x811C9DC5UL
+#define SH1106_HASH_PRIME 0x9E3779B1UL
+
+static uint32_t sh1106_hash_mix(uint32_t hash, uint32_t word) {
+  hash ^= word;
+  hash *= SH1106_HASH_PRIME;
+  return hash ^ (hash >> 15);
+}
+
+uint32_t sh1106_hash(const uint8_t *pixels, uint16_t size) {
+  uint32_t hash = SH1106_HASH_SEED ^ size;
+  uint32_t word;
+
+  for (; size >= 4; size -= 4, pixels += 4) {
+    memcpy(&word, pixels, sizeof(word));
+    hash = sh1106_hash_mix(hash, word);
+  }
+
+  if (size != 0) {
+    word = 0;
+    memcpy(&word, pixels, size);
+    hash = sh1106_hash_mix(hash, word);
+  }
+
+  return hash;
+}
+
+void sh1106_page_hashes_reset(struct sh1106_page_hashes *hashes) {
+  hashes->valid = 0;
+}
+
+void sh1106_chunk_hashes_reset(struct sh1106_chunk_hashes *hashes) {
+  hashes->valid = 0;
+}
+
+uint16_t sh1106_framebuffer_flush_hashed(const sh1106_send8_cmd_t send8_cmd,
+                                         const sh1106_send8_data_t send8_data,
+                                         struct sh1106_framebuffer *framebuffer,
+                                         struct sh1106_page_hashes *hashes) {
+  uint8_t x0 = framebuffer->clip_x0;
+  uint8_t size = (uint8_t) (framebuffer->clip_x1 - x0);
+  uint16_t sent = 0;
+  uint8_t page_addr;
+
+  if (framebuffer->clip_x0 >= framebuffer->clip_x1 || framebuffer->clip_y0 >= framebuffer->clip_y1) {
+    sh1106_dirty_reset(&framebuffer->dirty);
+    return 0;
+  }
+
+  /* Pages and columns of the clip rectangle */
+  for (page_addr = framebuffer->clip_y0 / 8;
+       page_addr <= (framebuffer->clip_y1 - 1) / 8 && page_addr < framebuffer->pages;
+       page_addr++) {
+    uint8_t bit = (uint8_t) (1 << page_addr);
+    const uint8_t *pixels = &framebuffer->pixels[page_addr * SH1106_COLUMNS + x0];
+    uint32_t hash = sh1106_hash(pixels, size);
+
+    if ((hashes->valid & bit) && hashes->pages[page_addr] == hash) {
+      continue;
+    }
+
+    sh1106_write_span(send8_cmd, send8_data, page_addr, x0, pixels, size);
+    hashes->pages[page_addr] = hash;
+    hashes->valid |= bit;
+    sent = (uint16_t) (sent + size);
+  }
+
+  sh1106_dirty_reset(&framebuffer->dirty);
+  return sent;
+}
+
+uint16_t sh1106_framebuffer_flush_hashed_chunks(const sh1106_send8_cmd_t send8_cmd,
+                                                const sh1106_send8_data_t send8_data,
+                                                struct sh1106_framebuffer *framebuffer,
+                                                struct sh1106_chunk_hashes *hashes) {
+  uint16_t sent = 0;
+  uint8_t page_addr;
+
+  if (framebuffer->clip_x0 >= framebuffer->clip_x1 || framebuffer->clip_y0 >= framebuffer->clip_y1) {
+    sh1106_dirty_reset(&framebuffer->dirty);
+    return 0;
+  }
+
+  for (page_addr = framebuffer->clip_y0 / 8;
+       page_addr <= (framebuffer->clip_y1 - 1) / 8 && page_addr < framebuffer->pages;
+       page_addr++) {
+    uint8_t bit = (uint8_t) (1 << page_addr);
+    uint8_t first = SH1106_COLUMNS;
+    uint8_t last = SH1106_COLUMNS;
+    uint8_t chunk;
+
+    /* One extra iteration past the last chunk closes a pending run */
+    for (chunk = 0; chunk <= SH1106_HASH_CHUNKS; chunk++) {
+      uint8_t x0 = 0;
+      uint8_t x1 = 0;
+      uint8_t changed = 0;
+
+      /* Columns of the chunk inside of the clip rectangle */
+      if (chunk < SH1106_HASH_CHUNKS) {
+        x0 = (uint8_t) (chunk * SH1106_HASH_CHUNK_COLUMNS);
+        x1 = (uint8_t) (SH1106_COLUMNS - x0 < SH1106_HASH_CHUNK_COLUMNS ? SH1106_COLUMNS
+                                                                         : x0 + SH1106_HASH_CHUNK_COLUMNS);
+        x0 = x0 < framebuffer->clip_x0 ? framebuffer->clip_x0 : x0;
+        x1 = x1 > framebuffer->clip_x1 ? framebuffer->clip_x1 : x1;
+      }
+
+      if (x0 < x1) {
+        uint32_t hash = sh1106_hash(&framebuffer->pixels[page_addr * SH1106_COLUMNS + x0], (uint16_t) (x1 - x0));
+
+        changed = !(hashes->valid & bit) || hashes->chunks[page_addr][chunk] != hash;
+        hashes->chunks[page_addr][chunk] = hash;
+      }
+
+      if (changed) {
+        first = first == SH1106_COLUMNS ? x0 : first;
+        last = x1;
+      } else if (first != SH1106_COLUMNS) {
+        sh1106_write_span(send8_cmd,
+                          send8_data,
+                          page_addr,
+                          first,
+                          &framebuffer->pixels[page_addr * SH1106_COLUMNS + first],
+                          (uint16_t) (last - first));
+        sent = (uint16_t) (sent + last - first);
+        first = SH1106_COLUMNS;
+      }
+    }
+
+    hashes->valid |= bit;
+  }
+
+  sh1106_dirty_reset(&framebuffer->dirty);
+  return sent;
+}
@@ -0,0 +1,225 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_image.h"
+
+struct sh1106_image_output {
+  sh1106_send8_cmd_t send8_cmd;
+  sh1106_send8_data_t send8_data;
+  uint8_t column_addr;
+  uint8_t page_addr;
+  uint8_t width;
+  uint8_t column;
+  uint16_t remaining;
+  uint8_t window[SH1106_IMAGE_WINDOW_SIZE];
+  uint8_t head;
+};
+
+static void sh1106_image_put(struct sh1106_image_output *output, uint8_t data) {
+  if (output->column == 0) {
+    sh1106_set_page_address(output->send8_cmd, output->page_addr++);
+    sh1106_set_column_address(output->send8_cmd, output->column_addr);
+  }
+
+  sh1106_write_display_data(output->send8_data, data);
+  output->window[output->head++] = data;
+  output->remaining--;
+
+  if (++output->column == output->width) {
+    output->column = 0;
+  }
+}
+
+int sh1106_draw_image(const sh1106_send8_cmd_t send8_cmd,
+                      const sh1106_send8_data_t send8_data,
+                      const uint8_t *image,
+                      size_t size,
+                      uint8_t column_addr,
+                      uint8_t page_addr) {
+  struct sh1106_image_output output;
+  const uint8_t *end = image + size;
+  uint16_t total;
+
+  if (size < SH1106_IMAGE_HEADER_SIZE) {
+    return -1;
+  }
+
+  if (image[0] == 0 || column_addr + image[0] > SH1106_COLUMNS ||
+      image[1] == 0 || page_addr + image[1] > SH1106_PAGES) {
+    return -1;
+  }
+
+  output.send8_cmd = send8_cmd;
+  output.send8_data = send8_data;
+  output.column_addr = column_addr;
+  output.page_addr = page_addr;
+  output.width = image[0];
+  output.column = 0;
+  output.remaining = total = (uint16_t) (image[0] * image[1]);
+  output.head = 0;
+  image += SH1106_IMAGE_HEADER_SIZE;
+
+  while (output.remaining != 0 && image < end) {
+    uint8_t token = *image++;
+    uint8_t n;
+
+    if (token < SH1106_IMAGE_ZERO) {
+      n = (uint8_t) (token - SH1106_IMAGE_LITERAL + 1);
+      if (n > output.remaining || n > end - image) {
+        return -1;
+      }
+      while (n--) {
+        sh1106_image_put(&output, *image++);
+      }
+    } else if (token < SH1106_IMAGE_FILL) {
+      n = (uint8_t) (token - SH1106_IMAGE_ZERO + 1);
+      if (n > output.remaining) {
+        return -1;
+      }
+      while (n--) {
+        sh1106_image_put(&output, 0x00);
+      }
+    } else if (token < SH1106_IMAGE_COPY) {
+      n = (uint8_t) (token - SH1106_IMAGE_FILL + SH1106_IMAGE_FILL_MIN);
+      if (n > output.remaining || image == end) {
+        return -1;
+      }
+      while (n--) {
+        sh1106_image_put(&output, *image);
+      }
+      image++;
+    } else {
+      uint8_t from;
+
+      n = (uint8_t) (token - SH1106_IMAGE_COPY + SH1106_IMAGE_COPY_MIN);
+      if (n > output.remaining || image == end || *image + 1 > total - output.remaining) {
+        return -1;
+      }
+      from = (uint8_t) (output.head - *image - 1);
+      image++;
+      while (n--) {
+        sh1106_image_put(&output, output.window[from++]);
+      }
+    }
+  }
+
+  return output.remaining == 0 && image == end ? 0 : -1;
+}
+
+static size_t sh1106_image_run(const uint8_t *pixels, size_t position, size_t total, uint8_t data, size_t max) {
+  size_t n = 0;
+
+  while (position + n < total && n < max && pixels[position + n] == data) {
+    n++;
+  }
+
+  return n;
+}
+
+static size_t sh1106_image_match(const uint8_t *pixels, size_t position, size_t total, uint8_t *distance) {
+  size_t best = 0;
+  size_t d;
+
+  for (d = 1; d <= SH1106_IMAGE_WINDOW_SIZE && d <= position; d++) {
+    size_t n = 0;
+
+    /* Overlapping matches are allowed, the decoder copies byte by byte */
+    while (position + n < total && n < SH1106_IMAGE_COPY_MAX && pixels[position + n] == pixels[position + n - d]) {
+      n++;
+    }
+
+    if (n > best) {
+      best = n;
+      *distance = (uint8_t) (d - 1);
+    }
+  }
+
+  return best;
+}
+
+size_t sh1106_encode_image(const uint8_t *pixels, uint8_t width, uint8_t pages, uint8_t *image, size_t size) {
+  size_t total = (size_t) width * pages;
+  size_t position = 0;
+  size_t length = SH1106_IMAGE_HEADER_SIZE;
+  size_t literal = 0;
+  size_t literal_length = 0;
+
+  if (width == 0 || width > SH1106_COLUMNS || pages == 0 || pages > SH1106_PAGES || size < length) {
+    return 0;
+  }
+
+  image[0] = width;
+  image[1] = pages;
+
+  while (position < total) {
+    size_t zero = pixels[position] == 0x00 ? sh1106_image_run(pixels, position, total, 0x00, SH1106_IMAGE_ZERO_MAX) : 0;
+    size_t fill = sh1106_image_run(pixels, position, total, pixels[position], SH1106_IMAGE_FILL_MAX);
+    uint8_t distance = 0;
+    size_t copy = sh1106_image_match(pixels, position, total, &distance);
+    size_t n = 0;
+    uint8_t token[2];
+    size_t token_length = 0;
+
+    /* Pick the token that saves the most bytes compared to extending the literal run */
+    if (copy >= SH1106_IMAGE_COPY_MIN && copy >= fill && copy > zero + 1) {
+      n = copy;
+      token[0] = (uint8_t) (SH1106_IMAGE_COPY + n - SH1106_IMAGE_COPY_MIN);
+      token[1] = distance;
+      token_length = 2;
+    } else if (zero >= 2 || (zero == 1 && literal_length == 0)) {
+      n = zero;
+      token[0] = (uint8_t) (SH1106_IMAGE_ZERO + n - 1);
+      token_length = 1;
+    } else if (fill >= 3) {
+      n = fill;
+      token[0] = (uint8_t) (SH1106_IMAGE_FILL + n - SH1106_IMAGE_FILL_MIN);
+      token[1] = pixels[position];
+      token_length = 2;
+    }
+
+    if (n == 0) {
+      if (literal_length == 0 || literal_length == SH1106_IMAGE_LITERAL_MAX) {
+        if (length == size) {
+          return 0;
+        }
+        literal = length++;
+        literal_length = 0;
+      }
+      if (length == size) {
+        return 0;
+      }
+      image[literal] = (uint8_t) (SH1106_IMAGE_LITERAL + literal_length);
+      image[length++] = pixels[position++];
+      literal_length++;
+      continue;
+    }
+
+    if (size - length < token_length) {
+      return 0;
+    }
+    image[length++] = token[0];
+    if (token_length == 2) {
+      image[length++] = token[1];
+    }
+    position += n;
+    literal_length = 0;
+  }
+
+  return length;
+}
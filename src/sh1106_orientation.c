@@ -0,0 +1,100 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_orientation.h"
+
+void sh1106_set_orientation(const sh1106_send8_cmd_t send8_cmd, enum sh1106_orientation orientation) {
+  switch (orientation) {
+    case SH1106_ORIENTATION_0: {
+      sh1106_set_segment_re_map(send8_cmd, SH1106_SEGMENT_RE_MAP_NORMAL_DIRECTION);
+      sh1106_set_common_output_scan_direction(send8_cmd, SH1106_COMMON_OUTPUT_SCAN_NORMAL_DIRECTION);
+      break;
+    }
+    case SH1106_ORIENTATION_270:
+    case SH1106_ORIENTATION_MIRROR_HORIZONTAL: {
+      sh1106_set_segment_re_map(send8_cmd, SH1106_SEGMENT_RE_MAP_REVERSE_DIRECTION);
+      sh1106_set_common_output_scan_direction(send8_cmd, SH1106_COMMON_OUTPUT_SCAN_NORMAL_DIRECTION);
+      break;
+    }
+    case SH1106_ORIENTATION_180: {
+      sh1106_set_segment_re_map(send8_cmd, SH1106_SEGMENT_RE_MAP_REVERSE_DIRECTION);
+      sh1106_set_common_output_scan_direction(send8_cmd, SH1106_COMMON_OUTPUT_SCAN_DIRECTION_VERTICALLY_FLIPPED);
+      break;
+    }
+    case SH1106_ORIENTATION_90:
+    case SH1106_ORIENTATION_MIRROR_VERTICAL: {
+      sh1106_set_segment_re_map(send8_cmd, SH1106_SEGMENT_RE_MAP_NORMAL_DIRECTION);
+      sh1106_set_common_output_scan_direction(send8_cmd, SH1106_COMMON_OUTPUT_SCAN_DIRECTION_VERTICALLY_FLIPPED);
+      break;
+    }
+  }
+}
+
+int sh1106_orientation_is_portrait(enum sh1106_orientation orientation) {
+  return orientation == SH1106_ORIENTATION_90 || orientation == SH1106_ORIENTATION_270;
+}
+
+void sh1106_transpose_block(const uint8_t *src, uint8_t *dst) {
+  uint64_t x = 0;
+  uint64_t t;
+  uint8_t i;
+
+  for (i = 0; i < 8; i++) {
+    x |= (uint64_t) src[i] << (8 * i);
+  }
+
+  /* Bit 8 * i + j (column i, line j) moves to bit 8 * j + i: swap 1x1, 2x2 and 4x4 sub-blocks */
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x = x ^ t ^ (t << 28);
+
+  for (i = 0; i < 8; i++) {
+    dst[i] = (uint8_t) (x >> (8 * i));
+  }
+}
+
+int sh1106_transpose_region(const uint8_t *src,
+                            uint16_t src_width,
+                            uint8_t *dst,
+                            uint16_t dst_width,
+                            uint16_t column,
+                            uint16_t page,
+                            uint16_t columns,
+                            uint16_t pages) {
+  uint16_t block;
+  uint16_t last_block = (uint16_t) ((column + columns + 7) / 8);
+  uint16_t p;
+
+  if (columns == 0 || pages == 0) {
+    return 0;
+  }
+  if (src_width > SH1106_PAGES * 8 || last_block * 8 > src_width || (uint32_t) (page + pages) * 8 > dst_width) {
+    return -1;
+  }
+
+  for (p = page; p < page + pages; p++) {
+    for (block = column / 8; block < last_block; block++) {
+      sh1106_transpose_block(&src[p * src_width + block * 8], &dst[block * dst_width + p * 8]);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_pacer.h"
+
+void sh1106_pacer_init(struct sh1106_pacer *pacer, uint32_t ticks_per_second, uint16_t target_fps) {
+  pacer->frame_period = target_fps ? ticks_per_second / target_fps : 0;
+  pacer->last_flush = 0;
+  pacer->dirty_pages = 0;
+  pacer->pending = 0;
+  pacer->idle = 1;
+  pacer->waiting = 0;
+  pacer->metrics.invalidations = 0;
+  pacer->metrics.flushes = 0;
+  pacer->metrics.merged = 0;
+  pacer->metrics.dropped = 0;
+}
+
+void sh1106_pacer_invalidate(struct sh1106_pacer *pacer, uint8_t page_mask) {
+  if (page_mask == 0) {
+    return;
+  }
+
+  pacer->dirty_pages |= page_mask;
+  pacer->pending++;
+  pacer->metrics.invalidations++;
+}
+
+uint32_t sh1106_pacer_time_until_due(const struct sh1106_pacer *pacer, uint32_t now) {
+  uint32_t elapsed;
+
+  if (pacer->dirty_pages == 0) {
+    return UINT32_MAX;
+  }
+
+  if (pacer->idle) {
+    return 0;
+  }
+
+  elapsed = now - pacer->last_flush;
+  return elapsed >= pacer->frame_period ? 0 : pacer->frame_period - elapsed;
+}
+
+uint8_t sh1106_pacer_poll(struct sh1106_pacer *pacer, uint32_t now) {
+  uint8_t page_mask;
+
+  if (sh1106_pacer_time_until_due(pacer, now) != 0) {
+    pacer->waiting = pacer->dirty_pages != 0;
+    return 0;
+  }
+
+  /*
+   * Keep a steady cadence while the pacer is saturated, but never schedule in the past: after an idle period longer
+   * than one frame the next frame period starts now, otherwise a burst would be flushed back-to-back. Invalidations
+   * that did not have to wait start the frame period now as well, so they are not followed by a flush within less
+   * than a period.
+   */
+  if (pacer->idle || !pacer->waiting || now - pacer->last_flush >= 2 * pacer->frame_period) {
+    pacer->last_flush = now;
+  } else {
+    pacer->last_flush += pacer->frame_period;
+  }
+  pacer->idle = 0;
+  pacer->waiting = 0;
+
+  if (pacer->pending > 1) {
+    pacer->metrics.merged++;
+    pacer->metrics.dropped += pacer->pending - 1;
+  }
+  pacer->metrics.flushes++;
+
+  page_mask = pacer->dirty_pages;
+  pacer->dirty_pages = 0;
+  pacer->pending = 0;
+
+  return page_mask;
+}
@@ -0,0 +1,240 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_parallel.h"
+
+/* Must be called with the mutex held, returns SH1106_PAGES if there is nothing left */
+static uint8_t sh1106_parallel_take(struct sh1106_parallel *parallel, uint8_t index) {
+  uint8_t victim = index;
+  uint8_t i;
+
+  if (parallel->next[index] == parallel->end[index]) {
+    for (i = 0; i < parallel->workers; i++) {
+      if (parallel->end[i] - parallel->next[i] > parallel->end[victim] - parallel->next[victim]) {
+        victim = i;
+      }
+    }
+
+    if (parallel->next[victim] == parallel->end[victim]) {
+      return SH1106_PAGES;
+    }
+
+    return parallel->pages[--parallel->end[victim]];
+  }
+
+  return parallel->pages[parallel->next[index]++];
+}
+
+static void *sh1106_parallel_worker(void *argument) {
+  struct sh1106_parallel_worker *worker = argument;
+  struct sh1106_parallel *parallel = worker->parallel;
+  uint32_t frame = 0;
+
+  pthread_mutex_lock(&parallel->mutex);
+  for (;;) {
+    uint8_t page_addr;
+
+    while (!parallel->stop && frame == parallel->frame) {
+      pthread_cond_wait(&parallel->work, &parallel->mutex);
+    }
+    if (parallel->stop) {
+      break;
+    }
+
+    while ((page_addr = sh1106_parallel_take(parallel, worker->index)) != SH1106_PAGES) {
+      uint8_t *strip = &parallel->pixels[page_addr * SH1106_COLUMNS];
+      int changed;
+
+      pthread_mutex_unlock(&parallel->mutex);
+      memset(strip, 0x00, SH1106_COLUMNS);
+      changed = (*parallel->draw)(parallel->context, page_addr, strip);
+      pthread_mutex_lock(&parallel->mutex);
+
+      parallel->rendered |= (uint8_t) (1 << page_addr);
+      if (changed) {
+        parallel->changed |= (uint8_t) (1 << page_addr);
+      }
+      pthread_cond_broadcast(&parallel->done);
+    }
+
+    frame = parallel->frame;
+  }
+  pthread_mutex_unlock(&parallel->mutex);
+
+  return NULL;
+}
+
+int sh1106_parallel_init(struct sh1106_parallel *parallel, uint8_t workers) {
+  uint8_t i;
+
+  if (workers == 0 || workers > SH1106_PARALLEL_MAX_WORKERS) {
+    return -1;
+  }
+
+  memset(parallel, 0x00, sizeof(*parallel));
+  pthread_mutex_init(&parallel->mutex, NULL);
+  pthread_cond_init(&parallel->work, NULL);
+  pthread_cond_init(&parallel->done, NULL);
+
+  for (i = 0; i < workers; i++) {
+    parallel->threads[i].parallel = parallel;
+    parallel->threads[i].index = i;
+    if (pthread_create(&parallel->threads[i].thread, NULL, sh1106_parallel_worker, &parallel->threads[i])) {
+      sh1106_parallel_destroy(parallel);
+      return -1;
+    }
+    parallel->workers++;
+  }
+
+  return 0;
+}
+
+void sh1106_parallel_destroy(struct sh1106_parallel *parallel) {
+  uint8_t i;
+
+  pthread_mutex_lock(&parallel->mutex);
+  parallel->stop = 1;
+  pthread_cond_broadcast(&parallel->work);
+  pthread_mutex_unlock(&parallel->mutex);
+
+  for (i = 0; i < parallel->workers; i++) {
+    pthread_join(parallel->threads[i].thread, NULL);
+  }
+  parallel->workers = 0;
+
+  pthread_cond_destroy(&parallel->done);
+  pthread_cond_destroy(&parallel->work);
+  pthread_mutex_destroy(&parallel->mutex);
+}
+
+uint8_t sh1106_parallel_render(struct sh1106_parallel *parallel,
+                               const sh1106_send8_cmd_t send8_cmd,
+                               const sh1106_send8_data_t send8_data,
+                               sh1106_strip_draw_t draw,
+                               void *context,
+                               uint8_t *pixels,
+                               uint8_t page_mask) {
+  uint8_t count = 0;
+  uint8_t sent = 0;
+  uint8_t page_addr;
+  uint8_t i;
+
+  pthread_mutex_lock(&parallel->mutex);
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    if (page_mask & (1 << page_addr)) {
+      parallel->pages[count++] = page_addr;
+    }
+  }
+  parallel->draw = draw;
+  parallel->context = context;
+  parallel->pixels = pixels;
+  parallel->rendered = (uint8_t) ~page_mask;
+  parallel->changed = 0;
+
+  /*
+   * Every worker gets a contiguous band of the selected pages. Worker 0 gets the first band, so the first page to be
+   * flushed is started right away.
+   */
+  for (i = 0; i < parallel->workers; i++) {
+    parallel->next[i] = (uint8_t) (count * i / parallel->workers);
+    parallel->end[i] = (uint8_t) (count * (i + 1) / parallel->workers);
+  }
+  parallel->frame++;
+  pthread_cond_broadcast(&parallel->work);
+  pthread_mutex_unlock(&parallel->mutex);
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    if (!(page_mask & (1 << page_addr))) {
+      continue;
+    }
+
+    pthread_mutex_lock(&parallel->mutex);
+    while (!(parallel->rendered & (1 << page_addr))) {
+      pthread_cond_wait(&parallel->done, &parallel->mutex);
+    }
+    if (!(parallel->changed & (1 << page_addr))) {
+      pthread_mutex_unlock(&parallel->mutex);
+      continue;
+    }
+    pthread_mutex_unlock(&parallel->mutex);
+
+    sh1106_write_span(send8_cmd, send8_data, page_addr, 0, &pixels[page_addr * SH1106_COLUMNS], SH1106_COLUMNS);
+    sent |= (uint8_t) (1 << page_addr);
+  }
+
+  return sent;
+}
+
+struct sh1106_parallel_bus {
+  struct sh1106_tiled *tiled;
+  pthread_t thread;
+  uint8_t bus;
+  uint8_t sent;
+};
+
+static void *sh1106_parallel_bus_worker(void *argument) {
+  struct sh1106_parallel_bus *bus = argument;
+
+  bus->sent = sh1106_tiled_flush_bus(bus->tiled, bus->bus);
+  return NULL;
+}
+
+uint8_t sh1106_parallel_flush_tiled(struct sh1106_tiled *tiled) {
+  struct sh1106_parallel_bus buses[SH1106_TILED_MAX_PANELS];
+  uint8_t started[SH1106_TILED_MAX_PANELS];
+  uint8_t count = 0;
+  uint8_t sent;
+  uint8_t i;
+  uint8_t j;
+
+  for (i = 0; i < tiled->count; i++) {
+    if (!tiled->panels[i].dirty.pages) {
+      continue;
+    }
+    j = 0;
+    while (j < count && buses[j].bus != tiled->panels[i].bus) {
+      j++;
+    }
+    if (j == count) {
+      buses[count].tiled = tiled;
+      buses[count].bus = tiled->panels[i].bus;
+      buses[count].sent = 0;
+      count++;
+    }
+  }
+
+  /* Panels of different buses share no state, every thread only writes the dirty sets of its own panels */
+  for (i = 1; i < count; i++) {
+    started[i] = pthread_create(&buses[i].thread, NULL, sh1106_parallel_bus_worker, &buses[i]) == 0;
+  }
+
+  sent = count ? sh1106_tiled_flush_bus(tiled, buses[0].bus) : 0;
+  for (i = 1; i < count; i++) {
+    if (started[i]) {
+      pthread_join(buses[i].thread, NULL);
+    } else {
+      sh1106_parallel_bus_worker(&buses[i]);
+    }
+    sent |= buses[i].sent;
+  }
+
+  return sent;
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_partial.h"
+
+void sh1106_partial_init(struct sh1106_partial *partial, uint8_t ram_page, uint8_t pages, uint8_t com_line) {
+  if (ram_page >= SH1106_PAGES) {
+    ram_page = SH1106_PAGES - 1;
+  }
+  if (pages == 0) {
+    pages = 1;
+  } else if (pages > SH1106_PAGES - ram_page) {
+    pages = (uint8_t) (SH1106_PAGES - ram_page);
+  }
+
+  partial->ram_page = ram_page;
+  partial->pages = pages;
+  partial->com_line = (uint8_t) (com_line & (SH1106_LINES - 1));
+}
+
+void sh1106_set_partial_display(const sh1106_send8_cmd_t send8_cmd, const struct sh1106_partial *partial) {
+  sh1106_set_multiplex_ration(send8_cmd, (uint8_t) (partial->pages * 8 - 1));
+  /* the offset moves COM lines up, moving the band down to com_line takes the complement */
+  sh1106_set_display_offset(send8_cmd, (uint8_t) ((SH1106_LINES - partial->com_line) & (SH1106_LINES - 1)));
+  sh1106_set_display_start_line(send8_cmd, (uint8_t) (partial->ram_page * 8));
+}
+
+void sh1106_set_full_display(const sh1106_send8_cmd_t send8_cmd) {
+  sh1106_set_multiplex_ration(send8_cmd, SH1106_LINES - 1);
+  sh1106_set_display_offset(send8_cmd, 0);
+  sh1106_set_display_start_line(send8_cmd, 0);
+}
+
+void sh1106_partial_framebuffer_init(const struct sh1106_partial *partial,
+                                     struct sh1106_framebuffer *framebuffer,
+                                     uint8_t *pixels) {
+  sh1106_framebuffer_init(framebuffer, pixels, partial->pages);
+}
+
+uint16_t sh1106_partial_flush(const sh1106_send8_cmd_t send8_cmd,
+                              const sh1106_send8_data_t send8_data,
+                              const struct sh1106_partial *partial,
+                              struct sh1106_framebuffer *framebuffer) {
+  return sh1106_framebuffer_flush_at(send8_cmd, send8_data, framebuffer, partial->ram_page);
+}
+
+uint32_t sh1106_frame_rate(uint32_t oscillator_frequency,
+                           uint8_t clock_divide_ratio,
+                           uint8_t clocks_per_row,
+                           uint8_t lines) {
+  uint32_t clocks_per_frame = (uint32_t) clock_divide_ratio * clocks_per_row * lines;
+
+  if (clocks_per_frame == 0) {
+    return 0;
+  }
+
+  return (uint32_t) ((uint64_t) oscillator_frequency * 100 / clocks_per_frame);
+}
+
+uint16_t sh1106_partial_frame_rate_gain(const struct sh1106_partial *partial) {
+  return (uint16_t) (SH1106_LINES * 100 / (partial->pages * 8));
+}
@@ -0,0 +1,169 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_scrub.h"
+
+/* Command bytes of every register */
+static const uint8_t sh1106_scrub_register_size[SH1106_SCRUB_REGISTERS] = {2, 1, 1, 2, 2};
+
+static void sh1106_scrub_register(const sh1106_send8_cmd_t send8_cmd,
+                                  const struct sh1106_registers *registers,
+                                  uint16_t index) {
+  switch (index) {
+    case 0: {
+      sh1106_set_contrast_control_register(send8_cmd, registers->contrast);
+      break;
+    }
+    case 1: {
+      sh1106_set_segment_re_map(send8_cmd, registers->segment_re_map);
+      break;
+    }
+    case 2: {
+      sh1106_set_common_output_scan_direction(send8_cmd, registers->common_output_scan_direction);
+      break;
+    }
+    case 3: {
+      sh1106_set_multiplex_ration(send8_cmd, registers->multiplex_ratio);
+      break;
+    }
+    default: {
+      sh1106_set_dc_dc_mode(send8_cmd, registers->dc_dc_mode);
+      break;
+    }
+  }
+}
+
+static uint16_t sh1106_scrub_total(const struct sh1106_scrub *scrub) {
+  return (uint16_t) (SH1106_SCRUB_REGISTERS + scrub->framebuffer->pages * SH1106_COLUMNS);
+}
+
+void sh1106_registers_init(struct sh1106_registers *registers) {
+  registers->contrast = 0x80;
+  registers->segment_re_map = SH1106_SEGMENT_RE_MAP_NORMAL_DIRECTION;
+  registers->common_output_scan_direction = SH1106_COMMON_OUTPUT_SCAN_NORMAL_DIRECTION;
+  registers->multiplex_ratio = SH1106_PAGES * 8 - 1;
+  registers->dc_dc_mode = SH1106_DC_DC_ENABLE;
+}
+
+void sh1106_registers_send(const sh1106_send8_cmd_t send8_cmd, const struct sh1106_registers *registers) {
+  uint16_t index;
+
+  for (index = 0; index < SH1106_SCRUB_REGISTERS; index++) {
+    sh1106_scrub_register(send8_cmd, registers, index);
+  }
+}
+
+void sh1106_scrub_init(struct sh1106_scrub *scrub,
+                       const struct sh1106_registers *registers,
+                       const struct sh1106_framebuffer *framebuffer,
+                       uint32_t now,
+                       uint32_t period,
+                       uint16_t budget) {
+  scrub->registers = registers;
+  scrub->framebuffer = framebuffer;
+  scrub->period = period ? period : 1;
+  scrub->budget = budget > SH1106_SCRUB_MIN_BUDGET ? budget : SH1106_SCRUB_MIN_BUDGET;
+  scrub->start = now;
+  scrub->position = 0;
+  scrub->late = 0;
+  scrub->metrics.cycles = 0;
+  scrub->metrics.overruns = 0;
+  scrub->metrics.last_cycle = 0;
+  scrub->metrics.bytes = 0;
+  scrub->metrics.max_poll = 0;
+}
+
+uint16_t sh1106_scrub_poll(struct sh1106_scrub *scrub,
+                           const sh1106_send8_cmd_t send8_cmd,
+                           const sh1106_send8_data_t send8_data,
+                           uint32_t now) {
+  uint16_t total = sh1106_scrub_total(scrub);
+  uint32_t elapsed = now - scrub->start;
+  uint16_t due = total;
+  uint16_t sent = 0;
+
+  if (elapsed < scrub->period) {
+    due = (uint16_t) ((uint64_t) total * elapsed / scrub->period);
+  }
+
+  while (scrub->position < total) {
+    uint16_t left = (uint16_t) (scrub->budget - sent);
+
+    if (scrub->position < SH1106_SCRUB_REGISTERS) {
+      uint8_t size = sh1106_scrub_register_size[scrub->position];
+
+      if (scrub->position >= due || size > left) {
+        break;
+      }
+      sh1106_scrub_register(send8_cmd, scrub->registers, scrub->position);
+      scrub->position++;
+      sent = (uint16_t) (sent + size);
+    } else {
+      uint16_t offset = (uint16_t) (scrub->position - SH1106_SCRUB_REGISTERS);
+      uint8_t page_addr = (uint8_t) (offset / SH1106_COLUMNS);
+      uint8_t column = (uint8_t) (offset % SH1106_COLUMNS);
+      uint16_t count = (uint16_t) (SH1106_COLUMNS - column);
+      const uint8_t *pixel = &scrub->framebuffer->pixels[offset];
+
+      /* Whole chunks only, so a frequent poll does not pay the addresses for a few bytes */
+      if (left < SH1106_SCRUB_MIN_BUDGET) {
+        break;
+      }
+      if (count > left - 3) {
+        count = (uint16_t) (left - 3);
+      }
+      if (scrub->position + count > due) {
+        break;
+      }
+
+      sh1106_write_span(send8_cmd, send8_data, page_addr, column, pixel, count);
+      scrub->position = (uint16_t) (scrub->position + count);
+      sent = (uint16_t) (sent + 3 + count);
+    }
+  }
+
+  /*
+   * The last chunk is due only at the end of the period, so a refresh finishes after it, by the first poll that finds
+   * it due or by the next one when that poll has more due than the budget. Only a later finish is an overrun.
+   */
+  if (scrub->position == total) {
+    scrub->metrics.cycles++;
+    scrub->metrics.last_cycle = elapsed;
+    scrub->metrics.overruns += scrub->late > 1;
+    scrub->position = 0;
+    scrub->late = 0;
+    if (elapsed - scrub->period > scrub->period) {
+      scrub->start = now;
+    } else {
+      scrub->start += scrub->period;
+    }
+  } else if (due == total && scrub->late < UINT8_MAX) {
+    scrub->late++;
+  }
+
+  scrub->metrics.bytes += sent;
+  if (sent > scrub->metrics.max_poll) {
+    scrub->metrics.max_poll = sent;
+  }
+  return sent;
+}
+
+uint16_t sh1106_scrub_coverage(const struct sh1106_scrub *scrub) {
+  return (uint16_t) ((uint32_t) scrub->position * 10000 / sh1106_scrub_total(scrub));
+}
@@ -0,0 +1,291 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_sparse.h"
+#include "sh1106_syscfg.h"
+
+/**
+ * @def SH1106_SPARSE_GAP
+ *
+ * Longest run of blank columns that is sent rather than skipped: a new column address costs 2 command bytes.
+ */
+#define SH1106_SPARSE_GAP 2
+
+static uint8_t sh1106_sparse_clamp(int16_t value, uint8_t min, uint8_t max) {
+  if (value < min) {
+    return min;
+  }
+  if (value > max) {
+    return max;
+  }
+  return (uint8_t) value;
+}
+
+static uint8_t sh1106_sparse_popcount(uint8_t byte) {
+  byte = (uint8_t) (byte - ((byte >> 1) & 0x55));
+  byte = (uint8_t) ((byte & 0x33) + ((byte >> 2) & 0x33));
+  return (uint8_t) ((byte + (byte >> 4)) & 0x0F);
+}
+
+static uint8_t sh1106_sparse_test(const uint8_t *bitmap, uint8_t column) {
+  return (uint8_t) ((bitmap[column >> 3] >> (column & 0x07)) & 0x01);
+}
+
+/* Position of the byte of a column in the pool, whether the column is occupied or not */
+static uint16_t sh1106_sparse_index(const struct sh1106_sparse *sparse, uint8_t page_addr, uint8_t column) {
+  const uint8_t *occupied = sparse->occupied[page_addr];
+  uint16_t index = 0;
+  uint8_t i;
+
+  for (i = 0; i < page_addr; i++) {
+    index = (uint16_t) (index + sparse->counts[i]);
+  }
+  for (i = 0; i < (column >> 3); i++) {
+    index = (uint16_t) (index + sh1106_sparse_popcount(occupied[i]));
+  }
+  return (uint16_t) (index + sh1106_sparse_popcount((uint8_t) (occupied[i] & ((1 << (column & 0x07)) - 1))));
+}
+
+void sh1106_sparse_init(struct sh1106_sparse *sparse, uint8_t *bytes, uint16_t capacity) {
+  uint8_t page_addr;
+
+  sparse->bytes = bytes;
+  sparse->capacity = capacity;
+  sparse->size = 0;
+  memset(sparse->counts, 0x00, sizeof(sparse->counts));
+  memset(sparse->occupied, 0x00, sizeof(sparse->occupied));
+  memset(sparse->shown, 0xFF, sizeof(sparse->shown));
+
+  sh1106_dirty_reset(&sparse->dirty);
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    sh1106_dirty_mark(&sparse->dirty, page_addr, 0, SH1106_COLUMNS - 1);
+  }
+}
+
+void sh1106_sparse_clear(struct sh1106_sparse *sparse) {
+  uint8_t page_addr;
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    uint8_t *occupied = sparse->occupied[page_addr];
+    uint8_t first = SH1106_COLUMNS;
+    uint8_t last = 0;
+    uint8_t i;
+
+    if (!sparse->counts[page_addr]) {
+      continue;
+    }
+
+    for (i = 0; i < SH1106_SPARSE_OCCUPANCY_SIZE; i++) {
+      if (!occupied[i]) {
+        continue;
+      }
+      if (first == SH1106_COLUMNS) {
+        first = (uint8_t) (i * 8);
+      }
+      last = (uint8_t) (i * 8 + 7);
+      occupied[i] = 0x00;
+    }
+
+    if (last >= SH1106_COLUMNS) {
+      last = SH1106_COLUMNS - 1;
+    }
+    sh1106_dirty_mark(&sparse->dirty, page_addr, first, last);
+    sparse->counts[page_addr] = 0;
+  }
+
+  sparse->size = 0;
+}
+
+uint8_t sh1106_sparse_get(const struct sh1106_sparse *sparse, uint8_t page_addr, uint8_t column) {
+  if (!sh1106_sparse_test(sparse->occupied[page_addr], column)) {
+    return 0x00;
+  }
+  return sparse->bytes[sh1106_sparse_index(sparse, page_addr, column)];
+}
+
+int sh1106_sparse_set(struct sh1106_sparse *sparse, uint8_t page_addr, uint8_t column, uint8_t byte) {
+  uint8_t *occupied = &sparse->occupied[page_addr][column >> 3];
+  uint8_t bit = (uint8_t) (1 << (column & 0x07));
+  uint16_t index = sh1106_sparse_index(sparse, page_addr, column);
+  uint8_t *pixel = &sparse->bytes[index];
+
+  if (*occupied & bit) {
+    if (*pixel == byte) {
+      return 0;
+    }
+    if (byte) {
+      *pixel = byte;
+    } else {
+      memmove(pixel, pixel + 1, (size_t) (sparse->size - index - 1));
+      sparse->size--;
+      sparse->counts[page_addr]--;
+      *occupied &= (uint8_t) ~bit;
+    }
+  } else {
+    if (!byte) {
+      return 0;
+    }
+    if (sparse->size == sparse->capacity) {
+      return -1;
+    }
+    memmove(pixel + 1, pixel, (size_t) (sparse->size - index));
+    *pixel = byte;
+    sparse->size++;
+    sparse->counts[page_addr]++;
+    *occupied |= bit;
+  }
+
+  sh1106_dirty_mark(&sparse->dirty, page_addr, column, column);
+  return 0;
+}
+
+int sh1106_sparse_set_pixel(struct sh1106_sparse *sparse, int16_t x, int16_t y, uint8_t on) {
+  uint8_t page_addr;
+  uint8_t byte;
+
+  if (x < 0 || x >= SH1106_COLUMNS || y < 0 || y >= SH1106_PAGES * 8) {
+    return 0;
+  }
+
+  page_addr = (uint8_t) (y >> 3);
+  byte = sh1106_sparse_get(sparse, page_addr, (uint8_t) x);
+  if (on) {
+    byte |= (uint8_t) (1 << (y & 0x07));
+  } else {
+    byte &= (uint8_t) ~(1 << (y & 0x07));
+  }
+  return sh1106_sparse_set(sparse, page_addr, (uint8_t) x, byte);
+}
+
+uint8_t sh1106_sparse_get_pixel(const struct sh1106_sparse *sparse, int16_t x, int16_t y) {
+  if (x < 0 || x >= SH1106_COLUMNS || y < 0 || y >= SH1106_PAGES * 8) {
+    return 0;
+  }
+
+  return (uint8_t) ((sh1106_sparse_get(sparse, (uint8_t) (y >> 3), (uint8_t) x) >> (y & 0x07)) & 0x01);
+}
+
+int sh1106_sparse_fill_rect(struct sh1106_sparse *sparse,
+                            int16_t x,
+                            int16_t y,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t on) {
+  uint8_t x0 = sh1106_sparse_clamp(x, 0, SH1106_COLUMNS);
+  uint8_t x1 = sh1106_sparse_clamp((int16_t) (x + width), x0, SH1106_COLUMNS);
+  uint8_t y0 = sh1106_sparse_clamp(y, 0, SH1106_PAGES * 8);
+  uint8_t y1 = sh1106_sparse_clamp((int16_t) (y + height), y0, SH1106_PAGES * 8);
+  uint8_t page_addr;
+
+  if (x0 >= x1 || y0 >= y1) {
+    return 0;
+  }
+
+  for (page_addr = y0 / 8; page_addr <= (y1 - 1) / 8; page_addr++) {
+    uint8_t top = (uint8_t) (page_addr * 8);
+    uint8_t mask = 0xFF;
+    uint8_t column;
+
+    if (y0 > top) {
+      mask &= (uint8_t) (0xFF << (y0 - top));
+    }
+    if (y1 < top + 8) {
+      mask &= (uint8_t) (0xFF >> (top + 8 - y1));
+    }
+
+    for (column = x0; column < x1; column++) {
+      uint8_t byte = sh1106_sparse_get(sparse, page_addr, column);
+
+      byte = on ? (uint8_t) (byte | mask) : (uint8_t) (byte & ~mask);
+      if (sh1106_sparse_set(sparse, page_addr, column, byte) != 0) {
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+uint16_t sh1106_sparse_flush(const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             struct sh1106_sparse *sparse) {
+  uint16_t sent = 0;
+  uint8_t page_addr;
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    const uint8_t *occupied = sparse->occupied[page_addr];
+    uint8_t *shown = sparse->shown[page_addr];
+    uint8_t last = sparse->dirty.last[page_addr];
+    uint8_t addressed = 0;
+    uint8_t column;
+    uint16_t pixel;
+
+    if (!(sparse->dirty.pages & (1 << page_addr))) {
+      continue;
+    }
+
+    column = sparse->dirty.first[page_addr];
+    pixel = sh1106_sparse_index(sparse, page_addr, column);
+
+    while (column <= last) {
+      uint8_t end;
+      uint8_t next;
+      uint8_t gap;
+
+      /* Skip columns that are blank in the framebuffer and in display RAM */
+      if (!sh1106_sparse_test(occupied, column) && !sh1106_sparse_test(shown, column)) {
+        column++;
+        continue;
+      }
+
+      /* Extend the run over short gaps of such columns */
+      end = column;
+      gap = 0;
+      for (next = (uint8_t) (column + 1); next <= last && gap <= SH1106_SPARSE_GAP; next++) {
+        if (sh1106_sparse_test(occupied, next) || sh1106_sparse_test(shown, next)) {
+          end = next;
+          gap = 0;
+        } else {
+          gap++;
+        }
+      }
+
+      if (!addressed) {
+        sh1106_set_page_address(send8_cmd, page_addr);
+        addressed = 1;
+      }
+      sh1106_set_column_address(send8_cmd, column);
+      for (; column <= end; column++) {
+        if (sh1106_sparse_test(occupied, column)) {
+          sh1106_write_display_data(send8_data, sparse->bytes[pixel++]);
+        } else {
+          sh1106_write_display_data(send8_data, 0x00);
+        }
+        sent++;
+      }
+    }
+
+    memcpy(shown, occupied, SH1106_SPARSE_OCCUPANCY_SIZE);
+  }
+
+  sh1106_dirty_reset(&sparse->dirty);
+  return sent;
+}
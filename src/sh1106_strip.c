@@ -0,0 +1,93 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_strip.h"
+
+uint8_t sh1106_render_strips(const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             sh1106_strip_draw_t draw,
+                             void *context,
+                             uint8_t page_mask) {
+  uint8_t strip[SH1106_COLUMNS];
+  uint8_t sent = 0;
+  uint8_t page_addr;
+  uint8_t column;
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    if (!(page_mask & (1 << page_addr))) {
+      continue;
+    }
+
+    memset(strip, 0x00, sizeof(strip));
+    if (!(*draw)(context, page_addr, strip)) {
+      continue;
+    }
+
+    sh1106_set_page_address(send8_cmd, page_addr);
+    sh1106_set_column_address(send8_cmd, 0);
+    for (column = 0; column < SH1106_COLUMNS; column++) {
+      sh1106_write_display_data(send8_data, strip[column]);
+    }
+    sent |= (uint8_t) (1 << page_addr);
+  }
+
+  return sent;
+}
+
+void sh1106_strip_set_pixel(uint8_t *strip, uint8_t page_addr, int16_t x, int16_t y, uint8_t on) {
+  if (x < 0 || x >= SH1106_COLUMNS || (y >> 3) != page_addr) {
+    return;
+  }
+
+  if (on) {
+    strip[x] |= (uint8_t) (1 << (y & 0x07));
+  } else {
+    strip[x] &= (uint8_t) ~(1 << (y & 0x07));
+  }
+}
+
+void sh1106_strip_fill_rect(uint8_t *strip,
+                            uint8_t page_addr,
+                            int16_t x,
+                            int16_t y,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t on) {
+  int16_t top = (int16_t) (page_addr * 8);
+  int16_t x0 = x < 0 ? 0 : x;
+  int16_t x1 = x + width > SH1106_COLUMNS ? SH1106_COLUMNS : (int16_t) (x + width);
+  int16_t y0 = y < top ? top : y;
+  int16_t y1 = y + height > top + 8 ? (int16_t) (top + 8) : (int16_t) (y + height);
+  uint8_t mask;
+
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+
+  mask = (uint8_t) ((0xFF << (y0 - top)) & (0xFF >> (top + 8 - y1)));
+  for (; x0 < x1; x0++) {
+    if (on) {
+      strip[x0] |= mask;
+    } else {
+      strip[x0] &= (uint8_t) ~mask;
+    }
+  }
+}
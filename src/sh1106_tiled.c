@@ -0,0 +1,271 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "sh1106_tiled.h"
+
+static uint16_t sh1106_tiled_clamp(int32_t value, uint16_t min, uint16_t max) {
+  if (value < min) {
+    return min;
+  }
+  if (value > max) {
+    return max;
+  }
+  return (uint16_t) value;
+}
+
+/* Canvas columns and lines shown by a panel */
+static uint16_t sh1106_tiled_columns(const struct sh1106_panel *panel) {
+  return sh1106_orientation_is_portrait(panel->orientation) ? (uint16_t) (panel->pages * 8) : panel->width;
+}
+
+static uint16_t sh1106_tiled_lines(const struct sh1106_panel *panel) {
+  return sh1106_orientation_is_portrait(panel->orientation) ? panel->width : (uint16_t) (panel->pages * 8);
+}
+
+/* Marks the display RAM of a panel that shows the canvas rectangle x0, y0 (inclusive) to x1, y1 (exclusive) */
+static void sh1106_tiled_mark(struct sh1106_panel *panel, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+  uint16_t columns = sh1106_tiled_columns(panel);
+  uint16_t lines = sh1106_tiled_lines(panel);
+  uint8_t page_addr;
+  uint8_t first;
+  uint8_t last;
+
+  if (x1 <= panel->x || x0 >= panel->x + columns || y1 <= panel->y || y0 >= panel->y + lines) {
+    return;
+  }
+
+  x0 = (uint16_t) (x0 > panel->x ? x0 - panel->x : 0);
+  x1 = (uint16_t) ((x1 < panel->x + columns ? x1 : panel->x + columns) - panel->x);
+  y0 = (uint16_t) (y0 > panel->y ? y0 - panel->y : 0);
+  y1 = (uint16_t) ((y1 < panel->y + lines ? y1 : panel->y + lines) - panel->y);
+
+  if (!sh1106_orientation_is_portrait(panel->orientation)) {
+    first = (uint8_t) (panel->column_offset + x0);
+    last = (uint8_t) (panel->column_offset + x1 - 1);
+    for (page_addr = (uint8_t) (y0 / 8); page_addr <= (y1 - 1) / 8; page_addr++) {
+      sh1106_dirty_mark(&panel->dirty, page_addr, first, last);
+    }
+  } else {
+    /* Lines become columns, sent as whole 8x8 blocks */
+    first = (uint8_t) (panel->column_offset + (y0 & ~0x07));
+    last = (uint8_t) (panel->column_offset + ((y1 - 1) | 0x07));
+    for (page_addr = (uint8_t) (x0 / 8); page_addr <= (x1 - 1) / 8; page_addr++) {
+      sh1106_dirty_mark(&panel->dirty, page_addr, first, last);
+    }
+  }
+}
+
+static void sh1106_tiled_mark_panels(struct sh1106_tiled *tiled, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+  uint8_t i;
+
+  for (i = 0; i < tiled->count; i++) {
+    sh1106_tiled_mark(&tiled->panels[i], x0, y0, x1, y1);
+  }
+}
+
+void sh1106_tiled_init(struct sh1106_tiled *tiled, uint8_t *pixels, uint16_t width, uint8_t pages) {
+  tiled->pixels = pixels;
+  tiled->width = width;
+  tiled->pages = pages;
+  tiled->count = 0;
+
+  memset(pixels, 0x00, (size_t) width * pages);
+}
+
+int sh1106_tiled_add_panel(struct sh1106_tiled *tiled, const struct sh1106_panel *panel) {
+  struct sh1106_panel *added = &tiled->panels[tiled->count];
+
+  if (tiled->count == SH1106_TILED_MAX_PANELS || panel->width == 0 || panel->pages == 0
+      || panel->pages > SH1106_PAGES || panel->column_offset + panel->width > SH1106_COLUMNS || panel->y % 8
+      || (sh1106_orientation_is_portrait(panel->orientation) && panel->width % 8)
+      || panel->x + sh1106_tiled_columns(panel) > tiled->width
+      || panel->y + sh1106_tiled_lines(panel) > tiled->pages * 8) {
+    return -1;
+  }
+
+  *added = *panel;
+  sh1106_dirty_reset(&added->dirty);
+  sh1106_tiled_mark(added, 0, 0, tiled->width, (uint16_t) (tiled->pages * 8));
+  return tiled->count++;
+}
+
+void sh1106_tiled_set_orientation(const struct sh1106_tiled *tiled) {
+  uint8_t i;
+
+  for (i = 0; i < tiled->count; i++) {
+    sh1106_set_orientation(tiled->panels[i].send8_cmd, tiled->panels[i].orientation);
+  }
+}
+
+void sh1106_tiled_invalidate(struct sh1106_tiled *tiled, int16_t x, int16_t y, int16_t width, int16_t height) {
+  uint16_t x0 = sh1106_tiled_clamp(x, 0, tiled->width);
+  uint16_t x1 = sh1106_tiled_clamp((int32_t) x + width, x0, tiled->width);
+  uint16_t y0 = sh1106_tiled_clamp(y, 0, (uint16_t) (tiled->pages * 8));
+  uint16_t y1 = sh1106_tiled_clamp((int32_t) y + height, y0, (uint16_t) (tiled->pages * 8));
+
+  if (x0 < x1 && y0 < y1) {
+    sh1106_tiled_mark_panels(tiled, x0, y0, x1, y1);
+  }
+}
+
+void sh1106_tiled_clear(struct sh1106_tiled *tiled) {
+  memset(tiled->pixels, 0x00, (size_t) tiled->width * tiled->pages);
+  sh1106_tiled_invalidate(tiled, 0, 0, (int16_t) tiled->width, (int16_t) (tiled->pages * 8));
+}
+
+void sh1106_tiled_set_pixel(struct sh1106_tiled *tiled, int16_t x, int16_t y, uint8_t on) {
+  uint8_t *pixel;
+
+  if (x < 0 || x >= tiled->width || y < 0 || y >= tiled->pages * 8) {
+    return;
+  }
+
+  pixel = &tiled->pixels[(y >> 3) * tiled->width + x];
+  if (on) {
+    *pixel |= (uint8_t) (1 << (y & 0x07));
+  } else {
+    *pixel &= (uint8_t) ~(1 << (y & 0x07));
+  }
+  sh1106_tiled_invalidate(tiled, x, y, 1, 1);
+}
+
+uint8_t sh1106_tiled_get_pixel(const struct sh1106_tiled *tiled, int16_t x, int16_t y) {
+  if (x < 0 || x >= tiled->width || y < 0 || y >= tiled->pages * 8) {
+    return 0;
+  }
+
+  return (uint8_t) ((tiled->pixels[(y >> 3) * tiled->width + x] >> (y & 0x07)) & 0x01);
+}
+
+void sh1106_tiled_fill_rect(struct sh1106_tiled *tiled,
+                            int16_t x,
+                            int16_t y,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t on) {
+  uint16_t x0 = sh1106_tiled_clamp(x, 0, tiled->width);
+  uint16_t x1 = sh1106_tiled_clamp((int32_t) x + width, x0, tiled->width);
+  uint16_t y0 = sh1106_tiled_clamp(y, 0, (uint16_t) (tiled->pages * 8));
+  uint16_t y1 = sh1106_tiled_clamp((int32_t) y + height, y0, (uint16_t) (tiled->pages * 8));
+  uint8_t page;
+
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+
+  for (page = (uint8_t) (y0 / 8); page <= (y1 - 1) / 8; page++) {
+    uint16_t top = (uint16_t) (page * 8);
+    uint8_t mask = 0xFF;
+    uint8_t *pixel = &tiled->pixels[page * tiled->width + x0];
+    uint8_t *end = pixel + (x1 - x0);
+
+    if (y0 > top) {
+      mask &= (uint8_t) (0xFF << (y0 - top));
+    }
+    if (y1 < top + 8) {
+      mask &= (uint8_t) (0xFF >> (top + 8 - y1));
+    }
+
+    if (on) {
+      for (; pixel < end; pixel++) {
+        *pixel |= mask;
+      }
+    } else {
+      for (; pixel < end; pixel++) {
+        *pixel &= (uint8_t) ~mask;
+      }
+    }
+  }
+
+  sh1106_tiled_mark_panels(tiled, x0, y0, x1, y1);
+}
+
+uint16_t sh1106_tiled_flush_panel(struct sh1106_tiled *tiled, uint8_t index) {
+  struct sh1106_panel *panel = &tiled->panels[index];
+  const uint8_t *origin = &tiled->pixels[(panel->y / 8) * tiled->width + panel->x];
+  uint16_t sent = 0;
+  uint8_t page_addr;
+
+  for (page_addr = 0; page_addr < panel->pages; page_addr++) {
+    uint8_t first = panel->dirty.first[page_addr];
+    uint8_t last = panel->dirty.last[page_addr];
+    uint8_t column;
+
+    if (!(panel->dirty.pages & (1 << page_addr))) {
+      continue;
+    }
+
+    sent = (uint16_t) (sent + last - first + 1);
+
+    if (!sh1106_orientation_is_portrait(panel->orientation)) {
+      sh1106_write_span(panel->send8_cmd,
+                        panel->send8_data,
+                        page_addr,
+                        first,
+                        &origin[page_addr * tiled->width + first - panel->column_offset],
+                        (uint16_t) (last - first + 1));
+    } else {
+      sh1106_set_page_address(panel->send8_cmd, page_addr);
+      sh1106_set_column_address(panel->send8_cmd, first);
+      /* Canvas columns 8 * page_addr to 8 * page_addr + 7 of canvas page N become display columns 8 * N to 8 * N + 7 */
+      for (column = first; column <= last; column = (uint8_t) (column + 8)) {
+        uint8_t block[8];
+        uint8_t i;
+
+        sh1106_transpose_block(&origin[((column - panel->column_offset) / 8) * tiled->width + page_addr * 8], block);
+        for (i = 0; i < 8; i++) {
+          sh1106_write_display_data(panel->send8_data, block[i]);
+        }
+      }
+    }
+  }
+
+  sh1106_dirty_reset(&panel->dirty);
+  return sent;
+}
+
+uint8_t sh1106_tiled_flush_bus(struct sh1106_tiled *tiled, uint8_t bus) {
+  uint8_t mask = 0;
+  uint8_t i;
+
+  for (i = 0; i < tiled->count; i++) {
+    if (tiled->panels[i].bus == bus && tiled->panels[i].dirty.pages) {
+      sh1106_tiled_flush_panel(tiled, i);
+      mask |= (uint8_t) (1 << i);
+    }
+  }
+
+  return mask;
+}
+
+uint8_t sh1106_tiled_flush(struct sh1106_tiled *tiled) {
+  uint8_t mask = 0;
+  uint8_t i;
+
+  for (i = 0; i < tiled->count; i++) {
+    if (tiled->panels[i].dirty.pages) {
+      sh1106_tiled_flush_panel(tiled, i);
+      mask |= (uint8_t) (1 << i);
+    }
+  }
+
+  return mask;
+}
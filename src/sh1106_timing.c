@@ -0,0 +1,117 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_timing.h"
+
+static uint8_t sh1106_histogram_bucket(uint32_t ticks) {
+#if defined(__GNUC__)
+  return (uint8_t) (ticks ? 32 - __builtin_clz(ticks) : 0);
+#else
+  uint8_t bucket = 0;
+
+  for (; ticks != 0; ticks >>= 1) {
+    bucket++;
+  }
+  return bucket;
+#endif
+}
+
+void sh1106_histogram_reset(struct sh1106_histogram *histogram) {
+  uint8_t bucket;
+
+  for (bucket = 0; bucket < SH1106_HISTOGRAM_BUCKETS; bucket++) {
+    histogram->buckets[bucket] = 0;
+  }
+  histogram->count = 0;
+  histogram->max = 0;
+}
+
+void sh1106_histogram_add(struct sh1106_histogram *histogram, uint32_t ticks) {
+  histogram->buckets[sh1106_histogram_bucket(ticks)]++;
+  histogram->count++;
+  if (ticks > histogram->max) {
+    histogram->max = ticks;
+  }
+}
+
+uint32_t sh1106_histogram_percentile(const struct sh1106_histogram *histogram, uint8_t percent) {
+  /* rank of the sample, rounded up so p100 is the last one */
+  uint32_t rank = (uint32_t) (((uint64_t) histogram->count * percent + 99) / 100);
+  uint32_t seen = 0;
+  uint8_t bucket;
+
+  if (histogram->count == 0) {
+    return 0;
+  }
+  if (rank == 0) {
+    rank = 1;
+  }
+
+  for (bucket = 0; bucket < SH1106_HISTOGRAM_BUCKETS; bucket++) {
+    seen += histogram->buckets[bucket];
+    if (seen >= rank) {
+      uint32_t bound = bucket == 0 ? 0 : (uint32_t) ((1ULL << bucket) - 1);
+
+      return bound < histogram->max ? bound : histogram->max;
+    }
+  }
+
+  return histogram->max;
+}
+
+void sh1106_timing_init(struct sh1106_timing *timing, sh1106_clock_t clock) {
+  uint8_t stage;
+
+  timing->clock = clock;
+  timing->start = 0;
+  timing->mark = 0;
+  for (stage = 0; stage < SH1106_STAGES; stage++) {
+    sh1106_histogram_reset(&timing->stages[stage]);
+  }
+}
+
+void sh1106_timing_begin(struct sh1106_timing *timing) {
+  timing->start = (*timing->clock)();
+  timing->mark = timing->start;
+}
+
+void sh1106_timing_stage(struct sh1106_timing *timing, enum sh1106_stage stage) {
+  uint32_t now = (*timing->clock)();
+
+  sh1106_histogram_add(&timing->stages[stage], now - timing->mark);
+  timing->mark = now;
+}
+
+void sh1106_timing_end(struct sh1106_timing *timing) {
+  uint32_t now = (*timing->clock)();
+
+  sh1106_histogram_add(&timing->stages[SH1106_STAGE_TOTAL], now - timing->start);
+  timing->mark = now;
+}
+
+void sh1106_timing_report(const struct sh1106_timing *timing,
+                          enum sh1106_stage stage,
+                          struct sh1106_timing_report *report) {
+  const struct sh1106_histogram *histogram = &timing->stages[stage];
+
+  report->count = histogram->count;
+  report->p50 = sh1106_histogram_percentile(histogram, 50);
+  report->p99 = sh1106_histogram_percentile(histogram, 99);
+  report->max = histogram->max;
+}
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sh1106_trace.h"
+
+#define SH1106_TRACE_DATA 0x80
+
+/* Transport of the tracing transports until the first sh1106_trace_start() */
+static void sh1106_trace_send8_none(uint8_t byte) {
+  (void) byte;
+}
+
+static struct sh1106_trace *sh1106_trace_active;
+static sh1106_send8_cmd_t sh1106_trace_send8_cmd_target = sh1106_trace_send8_none;
+static sh1106_send8_data_t sh1106_trace_send8_data_target = sh1106_trace_send8_none;
+
+static void sh1106_trace_put32(uint8_t *buffer, uint32_t value) {
+  buffer[0] = (uint8_t) value;
+  buffer[1] = (uint8_t) (value >> 8);
+  buffer[2] = (uint8_t) (value >> 16);
+  buffer[3] = (uint8_t) (value >> 24);
+}
+
+void sh1106_trace_start(struct sh1106_trace *trace,
+                        uint8_t *buffer,
+                        uint32_t size,
+                        uint32_t ticks_per_second,
+                        sh1106_clock_t clock,
+                        const sh1106_send8_cmd_t send8_cmd,
+                        const sh1106_send8_data_t send8_data) {
+  trace->buffer = buffer;
+  trace->size = size;
+  trace->length = SH1106_TRACE_HEADER_SIZE;
+  trace->overflow = 0;
+  trace->clock = clock;
+  trace->time = (*clock)();
+  trace->record = 0;
+  trace->send8_cmd = send8_cmd;
+  trace->send8_data = send8_data;
+
+  buffer[0] = 'S';
+  buffer[1] = 'H';
+  buffer[2] = 'T';
+  buffer[3] = 'R';
+  sh1106_trace_put32(&buffer[4], ticks_per_second);
+
+  sh1106_trace_send8_cmd_target = send8_cmd;
+  sh1106_trace_send8_data_target = send8_data;
+  sh1106_trace_active = trace;
+}
+
+void sh1106_trace_stop(void) {
+  sh1106_trace_active = 0;
+}
+
+static void sh1106_trace_record(struct sh1106_trace *trace, uint8_t kind, uint8_t byte) {
+  uint32_t now;
+  uint32_t delta;
+  uint32_t length;
+
+  if (trace->overflow) {
+    trace->overflow++;
+    return;
+  }
+
+  if (trace->record != 0 && (trace->buffer[trace->record] & SH1106_TRACE_DATA) == kind &&
+      (trace->buffer[trace->record] & ~SH1106_TRACE_DATA) < SH1106_TRACE_RECORD_MAX - 1) {
+    if (trace->length == trace->size) {
+      trace->overflow++;
+      return;
+    }
+    trace->buffer[trace->record]++;
+    trace->buffer[trace->length++] = byte;
+    return;
+  }
+
+  now = (*trace->clock)();
+  delta = now - trace->time;
+
+  /* Tag, up to 5 bytes of time delta and the first payload byte */
+  length = trace->length + 1;
+  do {
+    length++;
+    delta >>= 7;
+  } while (delta != 0);
+  if (length + 1 > trace->size) {
+    trace->overflow++;
+    return;
+  }
+
+  trace->record = trace->length;
+  trace->buffer[trace->length++] = kind;
+  delta = now - trace->time;
+  while (delta >= 0x80) {
+    trace->buffer[trace->length++] = (uint8_t) (0x80 | (delta & 0x7F));
+    delta >>= 7;
+  }
+  trace->buffer[trace->length++] = (uint8_t) delta;
+  trace->buffer[trace->length++] = byte;
+  trace->time = now;
+}
+
+void sh1106_trace_send8_cmd(uint8_t cmd) {
+  if (sh1106_trace_active) {
+    sh1106_trace_record(sh1106_trace_active, 0, cmd);
+  }
+  (*sh1106_trace_send8_cmd_target)(cmd);
+}
+
+void sh1106_trace_send8_data(uint8_t data) {
+  if (sh1106_trace_active) {
+    sh1106_trace_record(sh1106_trace_active, SH1106_TRACE_DATA, data);
+  }
+  (*sh1106_trace_send8_data_target)(data);
+}
+
+uint32_t sh1106_trace_read_header(const uint8_t *trace, uint32_t size, uint32_t *ticks_per_second) {
+  if (size < SH1106_TRACE_HEADER_SIZE || trace[0] != 'S' || trace[1] != 'H' || trace[2] != 'T' || trace[3] != 'R') {
+    return 0;
+  }
+
+  *ticks_per_second = (uint32_t) trace[4] | (uint32_t) trace[5] << 8 | (uint32_t) trace[6] << 16 |
+                      (uint32_t) trace[7] << 24;
+  return SH1106_TRACE_HEADER_SIZE;
+}
+
+int sh1106_trace_read(const uint8_t *trace, uint32_t size, uint32_t *offset, struct sh1106_trace_record *record) {
+  uint32_t position = *offset;
+  uint32_t delta = 0;
+  uint8_t shift = 0;
+  uint8_t tag;
+
+  if (position >= size) {
+    return 0;
+  }
+
+  tag = trace[position++];
+  do {
+    if (position == size || shift > 28) {
+      return -1;
+    }
+    delta |= (uint32_t) (trace[position] & 0x7F) << shift;
+    shift += 7;
+  } while (trace[position++] & 0x80);
+
+  record->data = (tag & SH1106_TRACE_DATA) != 0;
+  record->time += delta;
+  record->size = (uint8_t) ((tag & ~SH1106_TRACE_DATA) + 1);
+  record->payload = &trace[position];
+
+  if (size - position < record->size) {
+    return -1;
+  }
+
+  *offset = position + record->size;
+  return 1;
+}
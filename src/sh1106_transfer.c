@@ -0,0 +1,118 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+#include "sh1106_transfer.h"
+#include "sh1106_syscfg.h"
+
+void sh1106_transfer_reset(struct sh1106_transfer_list *list) {
+  list->count = 0;
+  list->pixels = NULL;
+  list->pages = 0;
+  list->page_offset = 0;
+  sh1106_dirty_reset(&list->dirty);
+}
+
+static int sh1106_transfer_same(const struct sh1106_dirty *a, const struct sh1106_dirty *b) {
+  uint8_t page_addr;
+
+  if (a->pages != b->pages) {
+    return 0;
+  }
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    if ((a->pages & (1 << page_addr))
+        && (a->first[page_addr] != b->first[page_addr] || a->last[page_addr] != b->last[page_addr])) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+uint8_t sh1106_transfer_compile(struct sh1106_transfer_list *list, const struct sh1106_framebuffer *framebuffer) {
+  return sh1106_transfer_compile_at(list, framebuffer, 0);
+}
+
+uint8_t sh1106_transfer_compile_at(struct sh1106_transfer_list *list,
+                                   const struct sh1106_framebuffer *framebuffer,
+                                   uint8_t page_offset) {
+  const struct sh1106_dirty *dirty = &framebuffer->dirty;
+  uint8_t page_addr;
+
+  if (list->pixels == framebuffer->pixels && list->pages == framebuffer->pages && list->page_offset == page_offset
+      && sh1106_transfer_same(&list->dirty, dirty)) {
+    return list->count;
+  }
+
+  list->count = 0;
+  for (page_addr = 0; page_addr < framebuffer->pages; page_addr++) {
+    struct sh1106_transfer *transfer = &list->transfers[list->count];
+    uint8_t *commands = list->commands[page_addr];
+    uint8_t first = dirty->first[page_addr];
+
+    if (!(dirty->pages & (1 << page_addr))) {
+      continue;
+    }
+
+    commands[0] = SH1106_SET_PAGE_ADDRESS(page_offset + page_addr);
+    commands[1] = SH1106_SET_LOWER_COLUMN_ADDRESS(first);
+    commands[2] = SH1106_SET_HIGHER_COLUMN_ADDRESS(first);
+    transfer[0].data = commands;
+    transfer[0].length = SH1106_TRANSFER_COMMAND_SIZE;
+    transfer[0].dc = 0;
+    transfer[1].data = &framebuffer->pixels[page_addr * SH1106_COLUMNS + first];
+    transfer[1].length = (uint16_t) (dirty->last[page_addr] - first + 1);
+    transfer[1].dc = 1;
+    list->count = (uint8_t) (list->count + 2);
+  }
+
+  list->pixels = framebuffer->pixels;
+  list->pages = framebuffer->pages;
+  list->page_offset = page_offset;
+  list->dirty = *dirty;
+  return list->count;
+}
+
+uint16_t sh1106_transfer_run(const sh1106_send8_cmd_t send8_cmd,
+                             const sh1106_send8_data_t send8_data,
+                             const struct sh1106_transfer_list *list) {
+  uint16_t sent = 0;
+  uint8_t index;
+
+  for (index = 0; index < list->count; index++) {
+    const struct sh1106_transfer *transfer = &list->transfers[index];
+    const uint8_t *byte = transfer->data;
+    const uint8_t *end = byte + transfer->length;
+
+    if (transfer->dc) {
+      sent = (uint16_t) (sent + transfer->length);
+      for (; byte < end; byte++) {
+        (*send8_data)(*byte);
+      }
+    } else {
+      for (; byte < end; byte++) {
+        (*send8_cmd)(*byte);
+      }
+    }
+  }
+
+  return sent;
+}
@@ -0,0 +1,304 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* posix_madvise() */
+#define _POSIX_C_SOURCE 200112L
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sh1106_animation.h"
+#include "sh1106_video.h"
+
+/* Decodes the next delta into the frame being decoded and records its runs, returns the delta after it */
+static const uint8_t *sh1106_video_decode(struct sh1106_video *video,
+                                          struct sh1106_video_frame *frame,
+                                          const uint8_t *delta) {
+  uint16_t position = 0;
+
+  frame->count = 0;
+  for (;;) {
+    struct sh1106_video_run *run;
+    uint8_t skip = delta[0];
+    uint8_t count = delta[1];
+
+    delta += 2;
+    if (skip == 0 && count == 0) {
+      break;
+    }
+
+    position = (uint16_t) (position + skip);
+    if (count == 0) {
+      continue;
+    }
+
+    if (frame->count != SH1106_VIDEO_FULL_FRAME) {
+      run = &frame->runs[frame->count ? frame->count - 1 : 0];
+      if (frame->count && run->offset + run->length == position
+          && run->offset / video->width == position / video->width) {
+        run->length = (uint16_t) (run->length + count);
+      } else if (frame->count < SH1106_VIDEO_MAX_RUNS) {
+        frame->runs[frame->count].offset = position;
+        frame->runs[frame->count].length = count;
+        frame->count++;
+      } else {
+        frame->count = SH1106_VIDEO_FULL_FRAME;
+      }
+    }
+
+    for (; count; count--) {
+      video->current[position++] ^= *delta++;
+    }
+  }
+
+  return delta;
+}
+
+static void *sh1106_video_worker(void *argument) {
+  struct sh1106_video *video = argument;
+  const uint8_t *delta = &video->data[SH1106_ANIMATION_HEADER_SIZE + video->width * video->pages];
+  uint16_t frame;
+
+  memcpy(video->current, &video->data[SH1106_ANIMATION_HEADER_SIZE], (size_t) (video->width * video->pages));
+  for (frame = 0; frame < video->frames; frame++) {
+    struct sh1106_video_frame *decoded;
+
+    pthread_mutex_lock(&video->mutex);
+    while (!video->stop && video->head - video->tail == SH1106_VIDEO_RING_SIZE) {
+      pthread_cond_wait(&video->space, &video->mutex);
+    }
+    if (video->stop) {
+      pthread_mutex_unlock(&video->mutex);
+      break;
+    }
+    pthread_mutex_unlock(&video->mutex);
+
+    /* The slot at head is not touched by the calling thread until head moves past it */
+    decoded = &video->ring[video->head % SH1106_VIDEO_RING_SIZE];
+    if (frame == 0) {
+      decoded->count = SH1106_VIDEO_FULL_FRAME;
+    } else {
+      delta = sh1106_video_decode(video, decoded, delta);
+    }
+    memcpy(decoded->pixels, video->current, (size_t) (video->width * video->pages));
+
+    pthread_mutex_lock(&video->mutex);
+    video->head++;
+    pthread_cond_signal(&video->ready);
+    pthread_mutex_unlock(&video->mutex);
+  }
+
+  return NULL;
+}
+
+int sh1106_video_open(struct sh1106_video *video,
+                      const char *path,
+                      const struct sh1106_bus_model *model,
+                      uint8_t column,
+                      uint8_t page_addr,
+                      uint32_t period) {
+  struct stat status;
+  void *data;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return -1;
+  }
+  if (fstat(fd, &status) != 0 || status.st_size <= 0 || (uint64_t) status.st_size > UINT32_MAX) {
+    close(fd);
+    return -1;
+  }
+
+  data = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return -1;
+  }
+  posix_madvise(data, (size_t) status.st_size, POSIX_MADV_SEQUENTIAL);
+
+  video->data = data;
+  video->size = (size_t) status.st_size;
+  if (sh1106_animation_check(video->data, (uint32_t) video->size) < 0
+      || column + video->data[4] > SH1106_COLUMNS || page_addr + video->data[5] > SH1106_PAGES) {
+    munmap(data, video->size);
+    return -1;
+  }
+
+  video->model = model;
+  video->width = video->data[4];
+  video->pages = video->data[5];
+  video->column = column;
+  video->page_addr = page_addr;
+  video->frames = (uint16_t) (video->data[6] | (video->data[7] << 8));
+  video->period = period ? period : 1;
+  video->started = 0;
+  video->underrun = 0;
+  video->head = 0;
+  video->tail = 0;
+  video->stop = 0;
+  memset(&video->metrics, 0x00, sizeof(video->metrics));
+  sh1106_bus_reset(&video->metrics.bus);
+
+  pthread_mutex_init(&video->mutex, NULL);
+  pthread_cond_init(&video->ready, NULL);
+  pthread_cond_init(&video->space, NULL);
+  if (pthread_create(&video->thread, NULL, sh1106_video_worker, video) != 0) {
+    pthread_cond_destroy(&video->space);
+    pthread_cond_destroy(&video->ready);
+    pthread_mutex_destroy(&video->mutex);
+    munmap(data, video->size);
+    return -1;
+  }
+
+  return 0;
+}
+
+void sh1106_video_close(struct sh1106_video *video) {
+  pthread_mutex_lock(&video->mutex);
+  video->stop = 1;
+  pthread_cond_broadcast(&video->space);
+  pthread_mutex_unlock(&video->mutex);
+  pthread_join(video->thread, NULL);
+
+  pthread_cond_destroy(&video->space);
+  pthread_cond_destroy(&video->ready);
+  pthread_mutex_destroy(&video->mutex);
+  munmap((void *) video->data, video->size);
+}
+
+static void sh1106_video_account(struct sh1106_video *video, uint8_t data, uint32_t count) {
+  if (video->model != NULL) {
+    sh1106_bus_account(video->model, &video->metrics.bus, data, count);
+  }
+}
+
+static void sh1106_video_send(struct sh1106_video *video,
+                              const sh1106_send8_cmd_t send8_cmd,
+                              const sh1106_send8_data_t send8_data,
+                              const uint8_t *pixels,
+                              uint16_t offset,
+                              uint16_t length,
+                              uint8_t *page) {
+  const uint8_t *pixel = &pixels[offset];
+  const uint8_t *end = pixel + length;
+
+  if (offset / video->width != *page) {
+    *page = (uint8_t) (offset / video->width);
+    sh1106_set_page_address(send8_cmd, (uint8_t) (video->page_addr + *page));
+    sh1106_video_account(video, 0, 1);
+  }
+  sh1106_set_column_address(send8_cmd, (uint8_t) (video->column + offset % video->width));
+  sh1106_video_account(video, 0, 2);
+
+  for (; pixel < end; pixel++) {
+    sh1106_write_display_data(send8_data, *pixel);
+  }
+  sh1106_video_account(video, 1, length);
+}
+
+int sh1106_video_poll(struct sh1106_video *video,
+                      const sh1106_send8_cmd_t send8_cmd,
+                      const sh1106_send8_data_t send8_data,
+                      uint32_t now) {
+  const struct sh1106_video_frame *newest;
+  uint32_t head;
+  uint32_t due;
+  uint32_t frame;
+  uint8_t full = 0;
+  uint8_t page = UINT8_MAX;
+
+  if (video->tail == video->frames) {
+    return 1;
+  }
+  if (!video->started) {
+    video->start = now;
+    video->started = 1;
+  }
+
+  video->metrics.elapsed = now - video->start;
+  due = video->metrics.elapsed / video->period;
+  if (due < video->tail) {
+    return 0;
+  }
+
+  pthread_mutex_lock(&video->mutex);
+  head = video->head;
+  pthread_mutex_unlock(&video->mutex);
+
+  if (head == video->tail) {
+    if (video->underrun != video->tail + 1) {
+      video->underrun = video->tail + 1;
+      video->metrics.late++;
+    }
+    return 0;
+  }
+
+  /* Frames from tail to head are decoded and stay untouched by the worker until tail moves */
+  if (due > head - 1) {
+    due = head - 1;
+  }
+  newest = &video->ring[due % SH1106_VIDEO_RING_SIZE];
+  for (frame = video->tail; frame <= due; frame++) {
+    if (video->ring[frame % SH1106_VIDEO_RING_SIZE].count == SH1106_VIDEO_FULL_FRAME) {
+      full = 1;
+    }
+  }
+
+  if (full) {
+    uint8_t i;
+
+    for (i = 0; i < video->pages; i++) {
+      sh1106_video_send(video, send8_cmd, send8_data, newest->pixels, (uint16_t) (i * video->width), video->width,
+                        &page);
+    }
+  } else {
+    for (frame = video->tail; frame <= due; frame++) {
+      const struct sh1106_video_frame *decoded = &video->ring[frame % SH1106_VIDEO_RING_SIZE];
+      uint16_t i;
+
+      for (i = 0; i < decoded->count; i++) {
+        sh1106_video_send(video, send8_cmd, send8_data, newest->pixels, decoded->runs[i].offset,
+                          decoded->runs[i].length, &page);
+      }
+    }
+  }
+  sh1106_bus_end(&video->metrics.bus);
+
+  video->metrics.presented++;
+  video->metrics.dropped += due - video->tail;
+
+  pthread_mutex_lock(&video->mutex);
+  video->tail = due + 1;
+  pthread_cond_signal(&video->space);
+  pthread_mutex_unlock(&video->mutex);
+
+  return video->tail == video->frames;
+}
+
+uint32_t sh1106_video_bus_utilization(const struct sh1106_video *video, uint32_t ticks_per_second) {
+  if (video->metrics.elapsed == 0) {
+    return 0;
+  }
+
+  return (uint32_t) (video->metrics.bus.time * ticks_per_second / ((uint64_t) video->metrics.elapsed * 100000ULL));
+}
@@ -0,0 +1,519 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+#include "sh1106_affine.h"
+#include "sh1106_widget.h"
+
+/* Rectangle in screen coordinates, the right and bottom edges are exclusive */
+struct sh1106_widget_rect {
+  int16_t x0;
+  int16_t y0;
+  int16_t x1;
+  int16_t y1;
+};
+
+static int16_t sh1106_widget_max(int16_t a, int16_t b) {
+  return a > b ? a : b;
+}
+
+static int16_t sh1106_widget_min(int16_t a, int16_t b) {
+  return a < b ? a : b;
+}
+
+static void sh1106_widget_intersect(struct sh1106_widget_rect *rect, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  rect->x0 = sh1106_widget_max(rect->x0, x0);
+  rect->y0 = sh1106_widget_max(rect->y0, y0);
+  rect->x1 = sh1106_widget_min(rect->x1, x1);
+  rect->y1 = sh1106_widget_min(rect->y1, y1);
+}
+
+static int sh1106_widget_empty(const struct sh1106_widget_rect *rect) {
+  return rect->x0 >= rect->x1 || rect->y0 >= rect->y1;
+}
+
+/*
+ * Screen position of the widget and its rectangle clipped to all of its ancestors and the screen, -1 if the widget is
+ * not part of the tree
+ */
+static int sh1106_widget_bounds(const struct sh1106_widgets *widgets,
+                                const struct sh1106_widget *widget,
+                                int16_t *x,
+                                int16_t *y,
+                                struct sh1106_widget_rect *clip) {
+  const struct sh1106_widget *node;
+  int16_t node_x = 0;
+  int16_t node_y = 0;
+
+  for (node = widget; node != &widgets->root; node = node->parent) {
+    if (node == NULL) {
+      return -1;
+    }
+    node_x = (int16_t) (node_x + node->x);
+    node_y = (int16_t) (node_y + node->y);
+  }
+  node_x = (int16_t) (node_x + widgets->root.x);
+  node_y = (int16_t) (node_y + widgets->root.y);
+  *x = node_x;
+  *y = node_y;
+
+  clip->x0 = widgets->screen->clip_x0;
+  clip->y0 = widgets->screen->clip_y0;
+  clip->x1 = widgets->screen->clip_x1;
+  clip->y1 = widgets->screen->clip_y1;
+  for (node = widget; node != NULL; node = node->parent) {
+    sh1106_widget_intersect(clip,
+                            node_x,
+                            node_y,
+                            (int16_t) (node_x + node->width),
+                            (int16_t) (node_y + node->height));
+    node_x = (int16_t) (node_x - node->x);
+    node_y = (int16_t) (node_y - node->y);
+  }
+  return 0;
+}
+
+/* Rounds the rectangle out to pages and merges it into the span of every page */
+static void sh1106_widget_damage(struct sh1106_dirty *damage, const struct sh1106_widget_rect *rect) {
+  uint8_t page_addr;
+
+  if (sh1106_widget_empty(rect)) {
+    return;
+  }
+
+  for (page_addr = (uint8_t) (rect->y0 / 8); page_addr <= (rect->y1 - 1) / 8; page_addr++) {
+    sh1106_dirty_mark(damage, page_addr, (uint8_t) rect->x0, (uint8_t) (rect->x1 - 1));
+  }
+}
+
+static void sh1106_widget_setup(struct sh1106_widget *widget,
+                                uint8_t kind,
+                                int16_t x,
+                                int16_t y,
+                                int16_t width,
+                                int16_t height) {
+  widget->kind = kind;
+  widget->parent = NULL;
+  widget->child = NULL;
+  widget->next = NULL;
+  widget->x = x;
+  widget->y = y;
+  widget->width = width;
+  widget->height = height;
+  widget->asset = NULL;
+  widget->text = NULL;
+  widget->value = 0;
+  widget->min = 0;
+  widget->max = 0;
+}
+
+/* Rounded product of a length and a 16.16 fraction */
+static int16_t sh1106_widget_scale(int16_t length, int32_t fraction) {
+  int32_t product = length * fraction;
+
+  return (int16_t) ((product + (product < 0 ? -0x8000 : 0x8000)) / 0x10000);
+}
+
+/* Value clamped to min - max, as a fraction of length */
+static int16_t sh1106_widget_fraction(const struct sh1106_widget *widget, int16_t length) {
+  int32_t value = widget->value;
+
+  if (widget->max <= widget->min || value <= widget->min) {
+    return 0;
+  }
+  if (value >= widget->max) {
+    return length;
+  }
+  return (int16_t) ((int64_t) length * ((int64_t) value - widget->min) / ((int64_t) widget->max - widget->min));
+}
+
+static void sh1106_widget_draw_line(struct sh1106_framebuffer *framebuffer,
+                                    int16_t x0,
+                                    int16_t y0,
+                                    int16_t x1,
+                                    int16_t y1) {
+  int16_t dx = (int16_t) (x1 > x0 ? x1 - x0 : x0 - x1);
+  int16_t dy = (int16_t) (y1 > y0 ? y0 - y1 : y1 - y0);
+  int16_t sx = (int16_t) (x1 > x0 ? 1 : -1);
+  int16_t sy = (int16_t) (y1 > y0 ? 1 : -1);
+  int16_t error = (int16_t) (dx + dy);
+
+  for (;;) {
+    int16_t error2 = (int16_t) (2 * error);
+
+    sh1106_framebuffer_set_pixel(framebuffer, x0, y0, 1);
+    if (x0 == x1 && y0 == y1) {
+      return;
+    }
+    if (error2 >= dy) {
+      error = (int16_t) (error + dy);
+      x0 = (int16_t) (x0 + sx);
+    }
+    if (error2 <= dx) {
+      error = (int16_t) (error + dx);
+      y0 = (int16_t) (y0 + sy);
+    }
+  }
+}
+
+static void sh1106_widget_draw_text(struct sh1106_framebuffer *framebuffer,
+                                    const struct sh1106_asset *font,
+                                    const char *text,
+                                    int16_t x) {
+  for (; *text != '\0'; text++, x = (int16_t) (x + font->width)) {
+    uint8_t code = (uint8_t) *text;
+
+    if (sh1106_asset_glyph(font, code) != NULL) {
+      sh1106_framebuffer_draw_asset(framebuffer, font, (uint16_t) (code - font->first), x, 0);
+    }
+  }
+}
+
+static void sh1106_widget_draw_value(struct sh1106_framebuffer *framebuffer, const struct sh1106_widget *widget) {
+  char text[12];
+  char *digit = &text[sizeof(text) - 1];
+  uint32_t value = widget->value < 0 ? 0u - (uint32_t) widget->value : (uint32_t) widget->value;
+
+  *digit = '\0';
+  do {
+    *--digit = (char) ('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  if (widget->value < 0) {
+    *--digit = '-';
+  }
+
+  sh1106_widget_draw_text(framebuffer,
+                          widget->asset,
+                          digit,
+                          (int16_t) (widget->width - (&text[sizeof(text) - 1] - digit) * widget->asset->width));
+}
+
+static void sh1106_widget_draw_bar(struct sh1106_framebuffer *framebuffer, const struct sh1106_widget *widget) {
+  int16_t width = widget->width;
+  int16_t height = widget->height;
+
+  sh1106_framebuffer_fill_rect(framebuffer, 0, 0, width, 1, 1);
+  sh1106_framebuffer_fill_rect(framebuffer, 0, (int16_t) (height - 1), width, 1, 1);
+  sh1106_framebuffer_fill_rect(framebuffer, 0, 0, 1, height, 1);
+  sh1106_framebuffer_fill_rect(framebuffer, (int16_t) (width - 1), 0, 1, height, 1);
+  if (width > 4 && height > 4) {
+    sh1106_framebuffer_fill_rect(framebuffer,
+                                 2,
+                                 2,
+                                 sh1106_widget_fraction(widget, (int16_t) (width - 4)),
+                                 (int16_t) (height - 4),
+                                 1);
+  }
+}
+
+static void sh1106_widget_draw_gauge(struct sh1106_framebuffer *framebuffer, const struct sh1106_widget *widget) {
+  int16_t center_x = (int16_t) ((widget->width - 1) / 2);
+  int16_t center_y = (int16_t) (widget->height - 1);
+  int16_t radius = sh1106_widget_min(center_x, center_y);
+  int16_t degrees;
+
+  for (degrees = 0; degrees <= 180; degrees = (int16_t) (degrees + 15)) {
+    sh1106_framebuffer_set_pixel(framebuffer,
+                                 (int16_t) (center_x + sh1106_widget_scale(radius, sh1106_cos(degrees))),
+                                 (int16_t) (center_y - sh1106_widget_scale(radius, sh1106_sin(degrees))),
+                                 1);
+  }
+
+  degrees = (int16_t) (180 - sh1106_widget_fraction(widget, 180));
+  radius = (int16_t) (radius - 2);
+  sh1106_widget_draw_line(framebuffer,
+                          center_x,
+                          center_y,
+                          (int16_t) (center_x + sh1106_widget_scale(radius, sh1106_cos(degrees))),
+                          (int16_t) (center_y - sh1106_widget_scale(radius, sh1106_sin(degrees))));
+}
+
+/* Draws the widget at (x, y) of the screen, clipped to clip */
+static void sh1106_widget_draw(struct sh1106_widgets *widgets,
+                               const struct sh1106_widget *widget,
+                               int16_t x,
+                               int16_t y,
+                               const struct sh1106_widget_rect *clip) {
+  struct sh1106_framebuffer window;
+
+  if (widget->kind == SH1106_WIDGET_GROUP) {
+    return;
+  }
+
+  sh1106_window_init(&window, widgets->screen, x, y, widget->width, widget->height);
+  window.clip_x0 = (uint8_t) clip->x0;
+  window.clip_y0 = (uint8_t) clip->y0;
+  window.clip_x1 = (uint8_t) clip->x1;
+  window.clip_y1 = (uint8_t) clip->y1;
+
+  switch (widget->kind) {
+    case SH1106_WIDGET_LABEL:
+      if (widget->text != NULL) {
+        sh1106_widget_draw_text(&window, widget->asset, widget->text, 0);
+      }
+      break;
+    case SH1106_WIDGET_VALUE:
+      sh1106_widget_draw_value(&window, widget);
+      break;
+    case SH1106_WIDGET_BAR:
+      sh1106_widget_draw_bar(&window, widget);
+      break;
+    case SH1106_WIDGET_ICON:
+      sh1106_framebuffer_draw_asset(&window, widget->asset, (uint16_t) widget->value, 0, 0);
+      break;
+    case SH1106_WIDGET_GAUGE:
+      sh1106_widget_draw_gauge(&window, widget);
+      break;
+    default:
+      break;
+  }
+  widgets->metrics.draws++;
+}
+
+/* Clears the band and redraws every widget intersecting it, in tree order */
+static void sh1106_widgets_render_band(struct sh1106_widgets *widgets, const struct sh1106_widget_rect *band) {
+  struct sh1106_framebuffer window;
+  struct sh1106_widget *widget = widgets->root.child;
+
+  sh1106_window_init(&window,
+                     widgets->screen,
+                     band->x0,
+                     band->y0,
+                     (int16_t) (band->x1 - band->x0),
+                     (int16_t) (band->y1 - band->y0));
+  sh1106_framebuffer_clear(&window);
+
+  while (widget != NULL) {
+    struct sh1106_widget_rect clip;
+    int16_t x;
+    int16_t y;
+
+    sh1106_widget_bounds(widgets, widget, &x, &y, &clip);
+    sh1106_widget_intersect(&clip, band->x0, band->y0, band->x1, band->y1);
+    if (!sh1106_widget_empty(&clip)) {
+      sh1106_widget_draw(widgets, widget, x, y, &clip);
+      if (widget->child != NULL) {
+        widget = widget->child;
+        continue;
+      }
+    }
+
+    while (widget != &widgets->root && widget->next == NULL) {
+      widget = widget->parent;
+    }
+    widget = widget == &widgets->root ? NULL : widget->next;
+  }
+}
+
+void sh1106_widgets_init(struct sh1106_widgets *widgets, struct sh1106_framebuffer *screen) {
+  widgets->screen = screen;
+  sh1106_widget_setup(&widgets->root,
+                      SH1106_WIDGET_GROUP,
+                      screen->origin_x,
+                      screen->origin_y,
+                      (int16_t) (screen->clip_x1 - screen->origin_x),
+                      (int16_t) (screen->clip_y1 - screen->origin_y));
+  sh1106_dirty_reset(&widgets->damage);
+  widgets->metrics.invalidations = 0;
+  widgets->metrics.rectangles = 0;
+  widgets->metrics.draws = 0;
+  sh1106_widget_invalidate(widgets, &widgets->root);
+}
+
+void sh1106_group_init(struct sh1106_widget *widget, int16_t x, int16_t y, int16_t width, int16_t height) {
+  sh1106_widget_setup(widget, SH1106_WIDGET_GROUP, x, y, width, height);
+}
+
+void sh1106_label_init(struct sh1106_widget *widget,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       const struct sh1106_asset *font,
+                       const char *text) {
+  sh1106_widget_setup(widget, SH1106_WIDGET_LABEL, x, y, width, height);
+  widget->asset = font;
+  widget->text = text;
+}
+
+void sh1106_value_init(struct sh1106_widget *widget,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       const struct sh1106_asset *font,
+                       int32_t value) {
+  sh1106_widget_setup(widget, SH1106_WIDGET_VALUE, x, y, width, height);
+  widget->asset = font;
+  widget->value = value;
+}
+
+void sh1106_bar_init(struct sh1106_widget *widget,
+                     int16_t x,
+                     int16_t y,
+                     int16_t width,
+                     int16_t height,
+                     int32_t min,
+                     int32_t max,
+                     int32_t value) {
+  sh1106_widget_setup(widget, SH1106_WIDGET_BAR, x, y, width, height);
+  widget->min = min;
+  widget->max = max;
+  widget->value = value;
+}
+
+void sh1106_icon_init(struct sh1106_widget *widget,
+                      int16_t x,
+                      int16_t y,
+                      const struct sh1106_asset *asset,
+                      uint16_t frame) {
+  sh1106_widget_setup(widget, SH1106_WIDGET_ICON, x, y, asset->width, (int16_t) (asset->pages * 8));
+  widget->asset = asset;
+  widget->value = frame;
+}
+
+void sh1106_gauge_init(struct sh1106_widget *widget,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       int32_t min,
+                       int32_t max,
+                       int32_t value) {
+  sh1106_widget_setup(widget, SH1106_WIDGET_GAUGE, x, y, width, height);
+  widget->min = min;
+  widget->max = max;
+  widget->value = value;
+}
+
+void sh1106_widget_add(struct sh1106_widgets *widgets, struct sh1106_widget *parent, struct sh1106_widget *widget) {
+  struct sh1106_widget **link;
+
+  if (parent == NULL) {
+    parent = &widgets->root;
+  }
+
+  for (link = &parent->child; *link != NULL; link = &(*link)->next) {
+  }
+  *link = widget;
+  widget->parent = parent;
+  widget->next = NULL;
+
+  sh1106_widget_invalidate(widgets, widget);
+}
+
+void sh1106_widget_remove(struct sh1106_widgets *widgets, struct sh1106_widget *widget) {
+  struct sh1106_widget **link;
+
+  if (widget->parent == NULL) {
+    return;
+  }
+
+  sh1106_widget_invalidate(widgets, widget);
+
+  for (link = &widget->parent->child; *link != widget; link = &(*link)->next) {
+  }
+  *link = widget->next;
+  widget->parent = NULL;
+  widget->next = NULL;
+}
+
+void sh1106_widget_move(struct sh1106_widgets *widgets, struct sh1106_widget *widget, int16_t x, int16_t y) {
+  if (widget->x == x && widget->y == y) {
+    return;
+  }
+
+  sh1106_widget_invalidate(widgets, widget);
+  widget->x = x;
+  widget->y = y;
+  sh1106_widget_invalidate(widgets, widget);
+}
+
+void sh1106_widget_set_text(struct sh1106_widgets *widgets, struct sh1106_widget *widget, const char *text) {
+  widget->text = text;
+  sh1106_widget_invalidate(widgets, widget);
+}
+
+void sh1106_widget_set_value(struct sh1106_widgets *widgets, struct sh1106_widget *widget, int32_t value) {
+  if (widget->value == value) {
+    return;
+  }
+
+  widget->value = value;
+  sh1106_widget_invalidate(widgets, widget);
+}
+
+void sh1106_widget_invalidate(struct sh1106_widgets *widgets, const struct sh1106_widget *widget) {
+  struct sh1106_widget_rect clip;
+  int16_t x;
+  int16_t y;
+
+  if (sh1106_widget_bounds(widgets, widget, &x, &y, &clip) < 0) {
+    return;
+  }
+
+  sh1106_widget_damage(&widgets->damage, &clip);
+  widgets->metrics.invalidations++;
+}
+
+void sh1106_widgets_render(struct sh1106_widgets *widgets) {
+  struct sh1106_dirty *damage = &widgets->damage;
+  uint8_t page_addr = 0;
+
+  while (page_addr < widgets->screen->pages) {
+    struct sh1106_widget_rect band;
+    uint8_t last_page = page_addr;
+    uint8_t page;
+
+    if (!(damage->pages & (1 << page_addr))) {
+      page_addr++;
+      continue;
+    }
+
+    /* Pages with equal spans are rendered as one band */
+    while (last_page + 1 < widgets->screen->pages && (damage->pages & (1 << (last_page + 1)))
+        && damage->first[last_page + 1] == damage->first[page_addr]
+        && damage->last[last_page + 1] == damage->last[page_addr]) {
+      last_page++;
+    }
+
+    band.x0 = damage->first[page_addr];
+    band.y0 = (int16_t) (page_addr * 8);
+    band.x1 = (int16_t) (damage->last[page_addr] + 1);
+    band.y1 = (int16_t) ((last_page + 1) * 8);
+    sh1106_widgets_render_band(widgets, &band);
+    widgets->metrics.rectangles++;
+
+    for (page = page_addr; page <= last_page; page++) {
+      sh1106_dirty_mark(&widgets->screen->dirty, page, damage->first[page], damage->last[page]);
+    }
+    page_addr = (uint8_t) (last_page + 1);
+  }
+
+  sh1106_dirty_reset(damage);
+}
+
+uint16_t sh1106_widgets_flush(const sh1106_send8_cmd_t send8_cmd,
+                              const sh1106_send8_data_t send8_data,
+                              struct sh1106_widgets *widgets) {
+  sh1106_widgets_render(widgets);
+  return sh1106_framebuffer_flush(send8_cmd, send8_data, widgets->screen);
+}
@@ -0,0 +1,45 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "file.h"
+
+uint8_t *file_load(const char *path, uint32_t *size) {
+  FILE *stream = fopen(path, "rb");
+  uint8_t *buffer = NULL;
+  long length;
+
+  if (stream == NULL) {
+    return NULL;
+  }
+
+  if (fseek(stream, 0, SEEK_END) == 0 && (length = ftell(stream)) > 0 && fseek(stream, 0, SEEK_SET) == 0) {
+    buffer = malloc((size_t) length);
+    if (buffer != NULL && fread(buffer, 1, (size_t) length, stream) != (size_t) length) {
+      free(buffer);
+      buffer = NULL;
+    }
+    *size = (uint32_t) length;
+  }
+
+  fclose(stream);
+  return buffer;
+}
@@ -0,0 +1,35 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__TOOLS__FILE_H
+#define YET_ANOTHER_GAUGE__SH1106__TOOLS__FILE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Read a whole file into memory.
+ *
+ * @param[in] path File name
+ * @param[out] size Size of the file
+ *
+ * @return File content to be released with free(), NULL on error or if the file is empty
+ */
+uint8_t *file_load(const char *path, uint32_t *size);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__TOOLS__FILE_H
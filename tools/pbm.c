@@ -0,0 +1,149 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include "pbm.h"
+
+static int pbm_skip(FILE *stream) {
+  int c;
+
+  for (;;) {
+    c = fgetc(stream);
+    if (c == '#') {
+      while (c != '\n' && c != EOF) {
+        c = fgetc(stream);
+      }
+    } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+      return c;
+    }
+  }
+}
+
+static int pbm_number(FILE *stream, unsigned *value) {
+  int c = pbm_skip(stream);
+
+  if (c < '0' || c > '9') {
+    return -1;
+  }
+
+  *value = 0;
+  while (c >= '0' && c <= '9') {
+    *value = *value * 10 + (unsigned) (c - '0');
+    c = fgetc(stream);
+  }
+
+  return 0;
+}
+
+int pbm_read(FILE *stream, struct pbm_bitmap *bitmap) {
+  int c = pbm_skip(stream);
+  int format;
+  unsigned x;
+  unsigned y;
+
+  if (c == EOF) {
+    return 1;
+  }
+
+  format = fgetc(stream);
+  if (c != 'P' || (format != '1' && format != '4')) {
+    return -1;
+  }
+
+  if (pbm_number(stream, &bitmap->width) || pbm_number(stream, &bitmap->height) ||
+      bitmap->width == 0 || bitmap->height == 0) {
+    return -1;
+  }
+
+  bitmap->pages = (bitmap->height + 7) / 8;
+  bitmap->pixels = calloc((size_t) bitmap->width * bitmap->pages, 1);
+  if (bitmap->pixels == NULL) {
+    return -1;
+  }
+
+  for (y = 0; y < bitmap->height; y++) {
+    int byte = 0;
+
+    for (x = 0; x < bitmap->width; x++) {
+      int ink;
+
+      if (format == '1') {
+        c = pbm_skip(stream);
+        if (c != '0' && c != '1') {
+          goto malformed;
+        }
+        ink = c == '1';
+      } else {
+        if (x % 8 == 0 && (byte = fgetc(stream)) == EOF) {
+          goto malformed;
+        }
+        ink = (byte >> (7 - x % 8)) & 1;
+      }
+
+      if (ink) {
+        bitmap->pixels[(y / 8) * bitmap->width + x] |= (uint8_t) (1 << (y % 8));
+      }
+    }
+  }
+
+  return 0;
+
+malformed:
+  free(bitmap->pixels);
+  bitmap->pixels = NULL;
+  return -1;
+}
+
+int pbm_load(const char *path, struct pbm_bitmap *bitmap) {
+  FILE *stream = fopen(path, "rb");
+  int status;
+
+  if (stream == NULL) {
+    return -1;
+  }
+
+  status = pbm_read(stream, bitmap);
+  fclose(stream);
+
+  return status == 0 ? 0 : -1;
+}
+
+int pbm_write(FILE *stream, const uint8_t *pixels, unsigned width, unsigned pages) {
+  unsigned x;
+  unsigned y;
+
+  fprintf(stream, "P4\n%u %u\n", width, pages * 8);
+
+  for (y = 0; y < pages * 8; y++) {
+    for (x = 0; x < width; x += 8) {
+      unsigned bit;
+      int byte = 0;
+
+      for (bit = 0; bit < 8 && x + bit < width; bit++) {
+        if (pixels[(y / 8) * width + x + bit] & (1 << (y % 8))) {
+          byte |= 0x80 >> bit;
+        }
+      }
+      fputc(byte, stream);
+    }
+  }
+
+  return ferror(stream) ? -1 : 0;
+}
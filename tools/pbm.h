@@ -0,0 +1,71 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__TOOLS__PBM_H
+#define YET_ANOTHER_GAUGE__SH1106__TOOLS__PBM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Page-major 1bpp bitmap.
+ *
+ * One byte holds 8 vertical pixels of a page, LSB is the top line. PBM "1" (ink) pixels are set bits, i.e. lit OLED
+ * pixels.
+ */
+struct pbm_bitmap {
+  unsigned width;
+  unsigned height;
+  unsigned pages;
+  uint8_t *pixels;
+};
+
+/**
+ * @brief Read next PBM (P1 or P4) image from a stream and convert it to page-major order.
+ *
+ * @param[in] stream Input stream
+ * @param[out] bitmap Bitmap, pixels must be released with free()
+ *
+ * @return 0 on success, 1 at the end of the stream, -1 on malformed input
+ */
+int pbm_read(FILE *stream, struct pbm_bitmap *bitmap);
+
+/**
+ * @brief Read a PBM file.
+ *
+ * @param[in] path File name
+ * @param[out] bitmap Bitmap, pixels must be released with free()
+ *
+ * @return 0 on success, -1 on error
+ */
+int pbm_load(const char *path, struct pbm_bitmap *bitmap);
+
+/**
+ * @brief Write a page-major bitmap as binary PBM (P4).
+ *
+ * @param[in] stream Output stream
+ * @param[in] pixels Page-major pixels
+ * @param[in] width Width in columns
+ * @param[in] pages Height in pages
+ *
+ * @return 0 on success, -1 on error
+ */
+int pbm_write(FILE *stream, const uint8_t *pixels, unsigned width, unsigned pages);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__TOOLS__PBM_H
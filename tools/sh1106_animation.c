@@ -0,0 +1,245 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Builds an XOR-delta animation (see sh1106_animation.h) from PBM images.
+ *
+ * Usage: sh1106_animation <name> <output> <frames.pbm>...
+ *
+ * Every image of the files is a frame, in order. Writes the animation to <output>.bin, a C array named <name> to
+ * <output>.c and its declaration to <output>.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sh1106_animation.h"
+#include "pbm.h"
+
+/* Longest run of unchanged bytes kept inside of a run, a new run costs 2 bytes and a column address */
+#define GAP 2
+
+struct animation {
+  uint8_t *data;
+  uint32_t size;
+  uint32_t capacity;
+};
+
+static int animation_append(struct animation *animation, const uint8_t *data, uint32_t size) {
+  if (animation->size + size > animation->capacity) {
+    uint32_t capacity = animation->capacity ? animation->capacity : 4096;
+    uint8_t *grown;
+
+    while (animation->size + size > capacity) {
+      capacity *= 2;
+    }
+    grown = realloc(animation->data, capacity);
+    if (grown == NULL) {
+      return -1;
+    }
+    animation->data = grown;
+    animation->capacity = capacity;
+  }
+
+  memcpy(&animation->data[animation->size], data, size);
+  animation->size += size;
+  return 0;
+}
+
+static int append_run(struct animation *animation,
+                      uint32_t skip,
+                      const uint8_t *from,
+                      const uint8_t *to,
+                      uint8_t count) {
+  uint8_t run[2 + 0xFF];
+  uint8_t i;
+
+  for (; skip > 0xFF; skip -= 0xFF) {
+    run[0] = 0xFF;
+    run[1] = 0;
+    if (animation_append(animation, run, 2)) {
+      return -1;
+    }
+  }
+
+  run[0] = (uint8_t) skip;
+  run[1] = count;
+  for (i = 0; i < count; i++) {
+    run[2 + i] = (uint8_t) (from[i] ^ to[i]);
+  }
+  return animation_append(animation, run, 2u + count);
+}
+
+static int append_delta(struct animation *animation,
+                        const uint8_t *from,
+                        const uint8_t *to,
+                        unsigned width,
+                        unsigned size) {
+  unsigned position = 0;
+  unsigned start = 0;
+
+  while (start < size) {
+    unsigned page_end = (start / width + 1) * width;
+    unsigned end;
+    unsigned next;
+
+    if (from[start] == to[start]) {
+      start++;
+      continue;
+    }
+
+    for (end = start + 1, next = end; next < page_end && next - start < 0xFF; next++) {
+      if (from[next] != to[next]) {
+        end = next + 1;
+      } else if (next - end >= GAP) {
+        break;
+      }
+    }
+
+    if (append_run(animation, start - position, &from[start], &to[start], (uint8_t) (end - start))) {
+      return -1;
+    }
+    position = end;
+    start = end;
+  }
+
+  return append_run(animation, 0, NULL, NULL, 0);
+}
+
+static int write_outputs(const char *name, const char *output, const struct animation *animation) {
+  char path[1024];
+  FILE *stream;
+  uint32_t i;
+
+  snprintf(path, sizeof(path), "%s.bin", output);
+  if ((stream = fopen(path, "wb")) == NULL || fwrite(animation->data, 1, animation->size, stream) != animation->size) {
+    fprintf(stderr, "%s: can not write\n", path);
+    return -1;
+  }
+  fclose(stream);
+
+  snprintf(path, sizeof(path), "%s.c", output);
+  if ((stream = fopen(path, "w")) == NULL) {
+    fprintf(stderr, "%s: can not write\n", path);
+    return -1;
+  }
+  fprintf(stream, "#include <stdint.h>\n\nconst uint8_t %s[%lu] = {", name, (unsigned long) animation->size);
+  for (i = 0; i < animation->size; i++) {
+    fprintf(stream, "%s0x%02X,", i % 16 ? " " : "\n    ", animation->data[i]);
+  }
+  fprintf(stream, "\n};\n");
+  fclose(stream);
+
+  snprintf(path, sizeof(path), "%s.h", output);
+  if ((stream = fopen(path, "w")) == NULL) {
+    fprintf(stderr, "%s: can not write\n", path);
+    return -1;
+  }
+  fprintf(stream, "#include <stdint.h>\n\nextern const uint8_t %s[%lu];\n", name, (unsigned long) animation->size);
+  fclose(stream);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  struct animation animation = {NULL, 0, 0};
+  struct pbm_bitmap *frames = NULL;
+  uint8_t header[SH1106_ANIMATION_HEADER_SIZE];
+  unsigned count = 0;
+  unsigned size;
+  unsigned frame;
+  uint32_t deltas;
+  int arg;
+
+  if (argc < 4) {
+    fprintf(stderr, "usage: %s <name> <output> <frames.pbm>...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  for (arg = 3; arg < argc; arg++) {
+    FILE *stream = fopen(argv[arg], "rb");
+    struct pbm_bitmap bitmap;
+    int status;
+
+    if (stream == NULL) {
+      fprintf(stderr, "%s: can not open\n", argv[arg]);
+      return EXIT_FAILURE;
+    }
+    while ((status = pbm_read(stream, &bitmap)) == 0) {
+      struct pbm_bitmap *grown = realloc(frames, (count + 1) * sizeof(*frames));
+
+      if (grown == NULL) {
+        return EXIT_FAILURE;
+      }
+      frames = grown;
+      if (count == 0 && (bitmap.width > SH1106_COLUMNS || bitmap.pages > SH1106_PAGES)) {
+        fprintf(stderr, "%s: animation is larger than the display\n", argv[arg]);
+        return EXIT_FAILURE;
+      }
+      if (count != 0 && (bitmap.width != frames[0].width || bitmap.pages != frames[0].pages)) {
+        fprintf(stderr, "%s: all frames must be %ux%u\n", argv[arg], frames[0].width, frames[0].pages * 8);
+        return EXIT_FAILURE;
+      }
+      frames[count++] = bitmap;
+    }
+    fclose(stream);
+    if (status < 0) {
+      fprintf(stderr, "%s: can not read PBM image\n", argv[arg]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (count == 0 || count > 0xFFFF) {
+    fprintf(stderr, "%s: expected 1 to 65535 frames\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  size = frames[0].width * frames[0].pages;
+  memcpy(header, "SHAN", 4);
+  header[4] = (uint8_t) frames[0].width;
+  header[5] = (uint8_t) frames[0].pages;
+  header[6] = (uint8_t) count;
+  header[7] = (uint8_t) (count >> 8);
+  if (animation_append(&animation, header, sizeof(header)) || animation_append(&animation, frames[0].pixels, size)) {
+    return EXIT_FAILURE;
+  }
+
+  /* deltas to the frames 1, 2, ... and from the last frame back to frame 0 */
+  for (frame = 0; frame < count; frame++) {
+    if (append_delta(&animation, frames[frame].pixels, frames[(frame + 1) % count].pixels, frames[0].width, size)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (sh1106_animation_check(animation.data, animation.size) != (int32_t) count
+      || write_outputs(argv[1], argv[2], &animation)) {
+    return EXIT_FAILURE;
+  }
+
+  deltas = animation.size - SH1106_ANIMATION_HEADER_SIZE - size;
+  fprintf(stderr, "%s: %u frames of %ux%u, %lu bytes (%lu as full frames), %lu delta bytes per frame\n",
+          argv[2], count, frames[0].width, frames[0].pages * 8, (unsigned long) animation.size,
+          (unsigned long) count * size, (unsigned long) (deltas / count));
+  for (frame = 0; frame < count; frame++) {
+    free(frames[frame].pixels);
+  }
+  free(frames);
+  free(animation.data);
+  return EXIT_SUCCESS;
+}
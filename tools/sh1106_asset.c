@@ -0,0 +1,316 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Builds an asset bundle (see sh1106_asset.h) from PBM images.
+ *
+ * Usage: sh1106_asset <name> <output> <asset>...
+ *
+ *   image:<id>:<image.pbm>                    every image of the file is a frame
+ *   sprite:<id>:<image.pbm>:<mask.pbm>        images and masks of the files are paired into frames
+ *   font:<id>:<glyphs.pbm>:<width>:<first>    glyphs of <width> columns side by side, the first is character <first>
+ *
+ * Writes the bundle to <output>.bin, a C array named <name> to <output>.c and the asset indexes (<NAME>_<ID>) to
+ * <output>.h.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sh1106_asset.h"
+#include "pbm.h"
+
+struct bundle {
+  uint8_t *data;
+  uint32_t size;
+  uint32_t capacity;
+};
+
+static int bundle_append(struct bundle *bundle, const uint8_t *data, uint32_t size) {
+  if (bundle->size + size > bundle->capacity) {
+    uint32_t capacity = bundle->capacity ? bundle->capacity : 4096;
+    uint8_t *grown;
+
+    while (bundle->size + size > capacity) {
+      capacity *= 2;
+    }
+    grown = realloc(bundle->data, capacity);
+    if (grown == NULL) {
+      return -1;
+    }
+    bundle->data = grown;
+    bundle->capacity = capacity;
+  }
+
+  memcpy(&bundle->data[bundle->size], data, size);
+  bundle->size += size;
+  return 0;
+}
+
+static void put16(uint8_t *buffer, unsigned value) {
+  buffer[0] = (uint8_t) value;
+  buffer[1] = (uint8_t) (value >> 8);
+}
+
+static void put32(uint8_t *buffer, uint32_t value) {
+  put16(&buffer[0], value & 0xFFFF);
+  put16(&buffer[2], value >> 16);
+}
+
+static int check_size(const char *path, const struct pbm_bitmap *bitmap, unsigned width, unsigned pages) {
+  if (bitmap->width != width || bitmap->pages != pages) {
+    fprintf(stderr, "%s: all frames must be %ux%u\n", path, width, pages * 8);
+    return -1;
+  }
+  return 0;
+}
+
+static int check_limits(const char *path, unsigned width, unsigned pages) {
+  if (width > 0xFF || pages > 0xFF / 8) {
+    fprintf(stderr, "%s: asset is larger than 255x248\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+static int add_frames(struct bundle *bundle, uint8_t *entry, const char *path, const char *mask_path) {
+  FILE *stream = fopen(path, "rb");
+  FILE *mask_stream = NULL;
+  struct pbm_bitmap bitmap;
+  struct pbm_bitmap mask;
+  unsigned count = 0;
+  int result = -1;
+  int status;
+
+  if (stream == NULL || (mask_path != NULL && (mask_stream = fopen(mask_path, "rb")) == NULL)) {
+    fprintf(stderr, "%s: can not open\n", stream == NULL ? path : mask_path);
+    goto done;
+  }
+
+  while ((status = pbm_read(stream, &bitmap)) == 0) {
+    if ((count == 0 && check_limits(path, bitmap.width, bitmap.pages))
+        || (count != 0 && check_size(path, &bitmap, entry[7], entry[8]))) {
+      free(bitmap.pixels);
+      goto done;
+    }
+    entry[7] = (uint8_t) bitmap.width;
+    entry[8] = (uint8_t) bitmap.pages;
+
+    status = bundle_append(bundle, bitmap.pixels, bitmap.width * bitmap.pages);
+    free(bitmap.pixels);
+    if (status) {
+      goto done;
+    }
+
+    if (mask_stream != NULL) {
+      if (pbm_read(mask_stream, &mask)) {
+        fprintf(stderr, "%s: can not read mask of frame %u\n", mask_path, count);
+        goto done;
+      }
+      status = check_size(mask_path, &mask, entry[7], entry[8])
+          || bundle_append(bundle, mask.pixels, mask.width * mask.pages);
+      free(mask.pixels);
+      if (status) {
+        goto done;
+      }
+    }
+    count++;
+  }
+
+  if (status < 0 || count == 0 || count > 0xFFFF) {
+    fprintf(stderr, "%s: can not read PBM image\n", path);
+    goto done;
+  }
+
+  put16(&entry[4], count);
+  result = 0;
+
+done:
+  if (stream != NULL) {
+    fclose(stream);
+  }
+  if (mask_stream != NULL) {
+    fclose(mask_stream);
+  }
+  return result;
+}
+
+static int add_font(struct bundle *bundle, uint8_t *entry, const char *path, unsigned width, unsigned first) {
+  struct pbm_bitmap bitmap;
+  unsigned count;
+  unsigned glyph;
+  unsigned page;
+
+  if (pbm_load(path, &bitmap)) {
+    fprintf(stderr, "%s: can not read PBM image\n", path);
+    return -1;
+  }
+
+  count = width ? bitmap.width / width : 0;
+  if (count == 0 || first + count > 0x100 || check_limits(path, width, bitmap.pages)) {
+    fprintf(stderr, "%s: can not split into glyphs of %u columns from character %u\n", path, width, first);
+    free(bitmap.pixels);
+    return -1;
+  }
+
+  for (glyph = 0; glyph < count; glyph++) {
+    for (page = 0; page < bitmap.pages; page++) {
+      if (bundle_append(bundle, &bitmap.pixels[page * bitmap.width + glyph * width], width)) {
+        free(bitmap.pixels);
+        return -1;
+      }
+    }
+  }
+
+  put16(&entry[4], count);
+  entry[7] = (uint8_t) width;
+  entry[8] = (uint8_t) bitmap.pages;
+  entry[9] = (uint8_t) first;
+  free(bitmap.pixels);
+  return 0;
+}
+
+static int write_outputs(const char *name, const char *output, const struct bundle *bundle, char **ids, int count) {
+  char path[1024];
+  FILE *stream;
+  uint32_t i;
+  int id;
+  const char *c;
+
+  snprintf(path, sizeof(path), "%s.bin", output);
+  if ((stream = fopen(path, "wb")) == NULL || fwrite(bundle->data, 1, bundle->size, stream) != bundle->size) {
+    fprintf(stderr, "%s: can not write\n", path);
+    return -1;
+  }
+  fclose(stream);
+
+  snprintf(path, sizeof(path), "%s.c", output);
+  if ((stream = fopen(path, "w")) == NULL) {
+    fprintf(stderr, "%s: can not write\n", path);
+    return -1;
+  }
+  fprintf(stream, "#include <stdint.h>\n\nconst uint8_t %s[%lu] = {", name, (unsigned long) bundle->size);
+  for (i = 0; i < bundle->size; i++) {
+    fprintf(stream, "%s0x%02X,", i % 16 ? " " : "\n    ", bundle->data[i]);
+  }
+  fprintf(stream, "\n};\n");
+  fclose(stream);
+
+  snprintf(path, sizeof(path), "%s.h", output);
+  if ((stream = fopen(path, "w")) == NULL) {
+    fprintf(stderr, "%s: can not write\n", path);
+    return -1;
+  }
+  fprintf(stream, "#include <stdint.h>\n\nextern const uint8_t %s[%lu];\n\n", name, (unsigned long) bundle->size);
+  for (id = 0; id < count; id++) {
+    fprintf(stream, "#define ");
+    for (c = name; *c; c++) {
+      fputc(toupper((unsigned char) *c), stream);
+    }
+    fputc('_', stream);
+    for (c = ids[id]; *c; c++) {
+      fputc(toupper((unsigned char) *c), stream);
+    }
+    fprintf(stream, " %d\n", id);
+  }
+  fclose(stream);
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  struct bundle bundle = {NULL, 0, 0};
+  uint8_t *header;
+  char **ids;
+  int count = argc - 3;
+  int id;
+
+  if (argc < 4 || count > 0xFFFF) {
+    fprintf(stderr, "usage: %s <name> <output> <image|sprite|font>:<id>:<image.pbm>[:<mask.pbm>|:<width>:<first>]...\n",
+            argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  /* header and index, the offsets are filled in once the frames are appended */
+  ids = calloc((size_t) count, sizeof(*ids));
+  header = calloc(SH1106_ASSET_HEADER_SIZE + (size_t) count * SH1106_ASSET_ENTRY_SIZE, 1);
+  if (ids == NULL || header == NULL) {
+    return EXIT_FAILURE;
+  }
+  memcpy(header, "SHAB", 4);
+  put16(&header[4], (unsigned) count);
+  if (bundle_append(&bundle, header, SH1106_ASSET_HEADER_SIZE + (uint32_t) count * SH1106_ASSET_ENTRY_SIZE)) {
+    return EXIT_FAILURE;
+  }
+  free(header);
+
+  for (id = 0; id < count; id++) {
+    char *spec = argv[id + 3];
+    char *kind = strtok(spec, ":");
+    char *path;
+    uint32_t offset = bundle.size;
+    uint8_t entry[SH1106_ASSET_ENTRY_SIZE] = {0};
+    int status;
+
+    ids[id] = strtok(NULL, ":");
+    path = strtok(NULL, ":");
+    if (kind == NULL || ids[id] == NULL || path == NULL) {
+      fprintf(stderr, "%s: expected <kind>:<id>:<file>\n", argv[id + 3]);
+      return EXIT_FAILURE;
+    }
+
+    if (strcmp(kind, "image") == 0) {
+      entry[6] = SH1106_ASSET_IMAGE;
+      status = add_frames(&bundle, entry, path, NULL);
+    } else if (strcmp(kind, "sprite") == 0) {
+      char *mask = strtok(NULL, ":");
+
+      entry[6] = SH1106_ASSET_SPRITE;
+      status = mask == NULL ? -1 : add_frames(&bundle, entry, path, mask);
+    } else if (strcmp(kind, "font") == 0) {
+      char *width = strtok(NULL, ":");
+      char *first = strtok(NULL, ":");
+
+      entry[6] = SH1106_ASSET_FONT;
+      status = width == NULL || first == NULL
+               ? -1 : add_font(&bundle, entry, path, (unsigned) atoi(width), (unsigned) atoi(first));
+    } else {
+      status = -1;
+    }
+
+    if (status) {
+      fprintf(stderr, "%s: can not add %s asset\n", ids[id], kind);
+      return EXIT_FAILURE;
+    }
+
+    put32(&entry[0], offset);
+    memcpy(&bundle.data[SH1106_ASSET_HEADER_SIZE + id * SH1106_ASSET_ENTRY_SIZE], entry, sizeof(entry));
+  }
+
+  if (sh1106_asset_bundle_check(bundle.data, bundle.size) != count
+      || write_outputs(argv[1], argv[2], &bundle, ids, count)) {
+    return EXIT_FAILURE;
+  }
+
+  fprintf(stderr, "%s: %d assets, %lu bytes\n", argv[2], count, (unsigned long) bundle.size);
+  free(bundle.data);
+  free(ids);
+  return EXIT_SUCCESS;
+}
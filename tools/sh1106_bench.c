@@ -0,0 +1,410 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmarks of the rendering and flush paths, run by the sh1106_report target.
+ *
+ * Usage: sh1106_bench
+ *
+ * Prints the host wall time per operation into null transports.
+ */
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sh1106.h"
+#include "sh1106_affine.h"
+#include "sh1106_asset.h"
+#include "sh1106_budget.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_hash.h"
+#include "sh1106_image.h"
+#include "sh1106_strip.h"
+
+#include "sh1106_bench.h"
+
+#ifdef SH1106_PARALLEL
+#include <unistd.h>
+
+#include "sh1106_parallel.h"
+#endif
+
+static volatile uint8_t sink;
+
+static void null_send8(uint8_t byte) {
+  sink = byte;
+}
+
+static double seconds(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static double measure(void (*run)(void)) {
+  unsigned long iterations = 0;
+  double start = seconds();
+  double elapsed;
+
+  do {
+    run();
+    iterations++;
+    elapsed = seconds() - start;
+  } while (elapsed < 0.2);
+
+  return elapsed / iterations * 1e9;
+}
+
+/* A dial face: frame, 8 bars and a needle band, the same scene for every path */
+static const int16_t scene[][4] = {
+    {0, 0, 128, 2},
+    {0, 62, 128, 2},
+    {0, 0, 2, 64},
+    {126, 0, 2, 64},
+    {8, 40, 10, 16},
+    {22, 34, 10, 22},
+    {36, 28, 10, 28},
+    {50, 22, 10, 34},
+    {64, 16, 10, 40},
+    {78, 10, 10, 46},
+    {92, 6, 10, 50},
+    {106, 4, 10, 52},
+    {60, 5, 8, 30},
+};
+
+#define SCENE_SIZE (sizeof(scene) / sizeof(scene[0]))
+
+static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+static struct sh1106_framebuffer framebuffer;
+
+static void run_framebuffer(void) {
+  uint8_t index;
+
+  sh1106_framebuffer_clear(&framebuffer);
+  for (index = 0; index < SCENE_SIZE; index++) {
+    sh1106_framebuffer_fill_rect(&framebuffer, scene[index][0], scene[index][1], scene[index][2], scene[index][3], 1);
+  }
+  sh1106_framebuffer_flush(null_send8, null_send8, &framebuffer);
+}
+
+static int draw_scene(void *context, uint8_t page_addr, uint8_t *strip) {
+  uint8_t index;
+
+  (void) context;
+  for (index = 0; index < SCENE_SIZE; index++) {
+    sh1106_strip_fill_rect(strip, page_addr, scene[index][0], scene[index][1], scene[index][2], scene[index][3], 1);
+  }
+  return 1;
+}
+
+static void run_strips(void) {
+  sh1106_render_strips(null_send8, null_send8, draw_scene, NULL, SH1106_PAGE_MASK_ALL);
+}
+
+/* Strip rendering against the framebuffer, both draw and send the whole scene every frame */
+static void bench_strip(void) {
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  printf("framebuffer: %.1f ns per frame, %u bytes of pixels\n",
+         measure(run_framebuffer),
+         (unsigned) sizeof(pixels));
+  printf("strips: %.1f ns per frame, %u bytes of pixels\n", measure(run_strips), (unsigned) SH1106_COLUMNS);
+}
+
+static volatile uint32_t hash;
+
+static void run_hash_page(void) {
+  hash = sh1106_hash(pixels, SH1106_COLUMNS);
+}
+
+static struct sh1106_page_hashes page_hashes;
+static struct sh1106_chunk_hashes chunk_hashes;
+static uint16_t sent;
+static uint8_t needle;
+
+/* Moves a 4 column needle one column per frame, the rest of the screen is unchanged */
+static void move_needle(void) {
+  sh1106_framebuffer_fill_rect(&framebuffer, needle, 16, 4, 32, 0);
+  needle = (uint8_t) ((needle + 1) % (SH1106_COLUMNS - 4));
+  sh1106_framebuffer_fill_rect(&framebuffer, needle, 16, 4, 32, 1);
+}
+
+static void run_full(void) {
+  move_needle();
+  sh1106_framebuffer_invalidate(&framebuffer);
+  sent = sh1106_framebuffer_flush(null_send8, null_send8, &framebuffer);
+}
+
+static void run_page_hashes(void) {
+  move_needle();
+  sent = sh1106_framebuffer_flush_hashed(null_send8, null_send8, &framebuffer, &page_hashes);
+}
+
+static void run_chunk_hashes(void) {
+  move_needle();
+  sent = sh1106_framebuffer_flush_hashed_chunks(null_send8, null_send8, &framebuffer, &chunk_hashes);
+}
+
+/* Hashing time against the bytes it saves over a full flush */
+static void bench_hash(void) {
+  double time;
+
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  run_framebuffer();
+  sh1106_page_hashes_reset(&page_hashes);
+  sh1106_chunk_hashes_reset(&chunk_hashes);
+
+  printf("hash: %.1f ns per page\n", measure(run_hash_page));
+  time = measure(run_full);
+  printf("full flush: %.1f ns per frame, %u bytes\n", time, sent);
+  time = measure(run_page_hashes);
+  printf("page hashes: %.1f ns per frame, %u bytes\n", time, sent);
+  time = measure(run_chunk_hashes);
+  printf("chunk hashes: %.1f ns per frame, %u bytes\n", time, sent);
+}
+
+static void run_c_flush(void) {
+  sh1106_framebuffer_invalidate(&framebuffer);
+  sent = sh1106_framebuffer_flush(null_send8, null_send8, &framebuffer);
+}
+
+static void run_device_flush(void) {
+  sh1106_framebuffer_invalidate(&framebuffer);
+  sent = bench_device_flush(&framebuffer);
+}
+
+/* Full screen flush through the transport pointers of the C API against the inlined transport of sh1106::device */
+static void bench_device(void) {
+  double time;
+
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  run_framebuffer();
+
+  time = measure(run_c_flush);
+  printf("C flush: %.1f ns per frame, %.2f ns per byte\n", time, time / sent);
+  time = measure(run_device_flush);
+  printf("device flush: %.1f ns per frame, %.2f ns per byte\n", time, time / sent);
+}
+
+static struct sh1106_budget budget;
+static uint16_t budget_bytes;
+static uint32_t budget_ticks;
+static unsigned long budget_frames;
+
+static uint32_t nanoseconds(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t) (now.tv_sec * 1000000000UL + now.tv_nsec);
+}
+
+static void run_budget(void) {
+  budget_frames++;
+  sh1106_framebuffer_invalidate(&framebuffer);
+  while (sh1106_budget_pending(&budget)) {
+    sh1106_budget_flush(&budget, null_send8, null_send8, budget_bytes, budget_ticks);
+  }
+}
+
+/*
+ * Budgeted flush of a full screen dirty frame, under byte budgets and time budgets of the host clock in ns. The most
+ * ticks of a call include preemption of the host, the mean is the time per frame over the calls per frame.
+ */
+static void bench_budget(void) {
+  static const struct {
+    uint16_t bytes;
+    uint32_t ticks;
+  } budgets[] = {{64, 0}, {256, 0}, {0, 1000}, {0, 4000}};
+  uint8_t index;
+
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  run_framebuffer();
+
+  for (index = 0; index < sizeof(budgets) / sizeof(budgets[0]); index++) {
+    double time;
+    double calls;
+
+    sh1106_budget_init(&budget, &framebuffer, nanoseconds);
+    sh1106_budget_add_region(&budget, 100, 40, 32, 24, 9);
+    sh1106_budget_add_region(&budget, 50, 20, 10, 10, 5);
+    budget_bytes = budgets[index].bytes;
+    budget_ticks = budgets[index].ticks;
+    budget_frames = 0;
+
+    time = measure(run_budget);
+    calls = (double) budget.metrics.calls / budget_frames;
+    printf("budget %u bytes, %lu ns: %.1f ns per frame, %.1f calls per frame, max %u bytes, mean %.1f ns and max %lu ns"
+           " per call\n",
+           budget_bytes,
+           (unsigned long) budget_ticks,
+           time,
+           calls,
+           budget.metrics.max_bytes,
+           time / calls,
+           (unsigned long) budget.metrics.max_ticks);
+  }
+}
+
+#ifdef SH1106_PARALLEL
+static struct sh1106_parallel parallel;
+
+/* A heavy page: every pixel of a dithered radial gradient costs a few dozen multiplications */
+static int draw_heavy(void *context, uint8_t page_addr, uint8_t *strip) {
+  uint8_t x;
+
+  (void) context;
+  for (x = 0; x < SH1106_COLUMNS; x++) {
+    uint8_t line;
+
+    for (line = 0; line < 8; line++) {
+      int32_t dx = x - SH1106_COLUMNS / 2;
+      int32_t dy = page_addr * 8 + line - 32;
+      uint32_t level = (uint32_t) (dx * dx + dy * dy);
+      uint8_t round;
+
+      for (round = 0; round < 32; round++) {
+        level = level * 1103515245UL + 12345UL;
+      }
+      if ((level >> 24) < (uint32_t) (dx * dx + dy * dy) / 20) {
+        strip[x] |= (uint8_t) (1 << line);
+      }
+    }
+  }
+  return 1;
+}
+
+static void run_parallel(void) {
+  sh1106_parallel_render(&parallel, null_send8, null_send8, draw_heavy, NULL, pixels, SH1106_PAGE_MASK_ALL);
+}
+
+/* Scaling of the page-parallel executor from 1 to 4 workers */
+static void bench_parallel(void) {
+  double single = 0;
+  uint8_t workers;
+
+  printf("parallel: %ld cores online\n", sysconf(_SC_NPROCESSORS_ONLN));
+  for (workers = 1; workers <= 4; workers++) {
+    double time;
+
+    if (sh1106_parallel_init(&parallel, workers)) {
+      fprintf(stderr, "can not start %u workers\n", workers);
+      return;
+    }
+    time = measure(run_parallel);
+    sh1106_parallel_destroy(&parallel);
+
+    if (workers == 1) {
+      single = time;
+    }
+    printf("parallel, workers %u: %.1f ns per frame, %.2fx\n", workers, time, single / time);
+  }
+}
+#endif
+
+static uint8_t bitmap[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+static struct sh1106_asset image;
+static struct sh1106_affine affine;
+
+static void run_affine(void) {
+  sh1106_framebuffer_draw_affine(&framebuffer, &image, 0, &affine);
+}
+
+/* Affine blitter, a bitmap rotated by 30 degrees about its centre from 16x16 to full screen */
+static void bench_affine(void) {
+  static const uint8_t sizes[][2] = {{16, 2}, {32, 4}, {64, 8}, {128, 8}};
+  uint16_t index;
+
+  for (index = 0; index < sizeof(bitmap); index++) {
+    bitmap[index] = (uint8_t) (index * 37 + (index >> 3));
+  }
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+
+  for (index = 0; index < sizeof(sizes) / sizeof(sizes[0]); index++) {
+    double time;
+
+    image.frames = bitmap;
+    image.count = 1;
+    image.kind = SH1106_ASSET_IMAGE;
+    image.width = sizes[index][0];
+    image.pages = sizes[index][1];
+    image.first = 0;
+    sh1106_affine_rotation(&affine,
+                           30,
+                           0x0100,
+                           (int16_t) (image.width / 2),
+                           (int16_t) (image.pages * 4),
+                           SH1106_COLUMNS / 2,
+                           SH1106_PAGES * 4);
+
+    time = measure(run_affine);
+    printf("affine %ux%u: %.1f ns per blit, %.2f ns per source pixel\n",
+           image.width,
+           image.pages * 8,
+           time,
+           time / (image.width * image.pages * 8));
+  }
+}
+
+static uint8_t compressed[2 * SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+static size_t compressed_size;
+
+static void run_image(void) {
+  sh1106_draw_image(null_send8, null_send8, compressed, compressed_size, 0, 0);
+}
+
+/* Streaming decode of the dial face and of the affine test pattern, time per decoded byte against the ratio */
+static void bench_image(void) {
+  static const char *names[] = {"dial", "pattern"};
+  const uint8_t *images[] = {pixels, bitmap};
+  uint8_t index;
+
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  run_framebuffer();
+
+  for (index = 0; index < sizeof(images) / sizeof(images[0]); index++) {
+    double time;
+
+    compressed_size = sh1106_encode_image(images[index], SH1106_COLUMNS, SH1106_PAGES, compressed, sizeof(compressed));
+    time = measure(run_image);
+    printf("image %s: %u of %u bytes, ratio %.2f, %.1f ns per image, %.2f ns per decoded byte\n",
+           names[index],
+           (unsigned) compressed_size,
+           (unsigned) sizeof(pixels),
+           (double) sizeof(pixels) / compressed_size,
+           time,
+           time / sizeof(pixels));
+  }
+}
+
+int main(void) {
+  bench_strip();
+  bench_hash();
+  bench_device();
+  bench_budget();
+  bench_affine();
+  bench_image();
+#ifdef SH1106_PARALLEL
+  bench_parallel();
+#endif
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,37 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_BENCH_H
+#define YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_BENCH_H
+
+#include <stdint.h>
+
+#include "sh1106_framebuffer.h"
+
+/**
+ * @brief Flush dirty set of a framebuffer with sh1106::device into a null transport.
+ *
+ * @param[in,out] framebuffer Framebuffer or window
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t bench_device_flush(struct sh1106_framebuffer *framebuffer);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_BENCH_H
@@ -0,0 +1,49 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * sh1106::device side of the device against C flush benchmark in sh1106_bench.c.
+ */
+
+#include "sh1106.hpp"
+
+extern "C" {
+#include "sh1106_bench.h"
+}
+
+namespace {
+
+volatile uint8_t sink;
+
+struct null_transport {
+  static void send8_cmd(uint8_t cmd) {
+    sink = cmd;
+  }
+
+  static void send8_data(uint8_t data) {
+    sink = data;
+  }
+};
+
+} // namespace
+
+extern "C" uint16_t bench_device_flush(struct sh1106_framebuffer *framebuffer) {
+  return sh1106::device<null_transport>::flush(*framebuffer);
+}
@@ -0,0 +1,148 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Estimates wire time of a recorded workload (see sh1106_trace.h).
+ *
+ * Usage: sh1106_bus [-g <gap>] <spi4|spi3|i2c> <clock, Hz> <trace>
+ *
+ * The trace is split into frames at pauses of at least <gap> ticks (10 ms by default). Prints wire time per frame,
+ * the achievable frame rate of the heaviest frame and the bus utilization at the recorded frame rate.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sh1106_bus.h"
+#include "sh1106_trace.h"
+#include "file.h"
+
+int main(int argc, char *argv[]) {
+  struct sh1106_bus_model model;
+  struct sh1106_bus_stats frame;
+  struct sh1106_bus_stats total;
+  struct sh1106_bus_stats worst;
+  struct sh1106_trace_record record;
+  uint8_t *trace;
+  uint32_t size;
+  uint32_t ticks_per_second;
+  uint32_t offset;
+  uint32_t gap = 0;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  unsigned frames = 0;
+  int argi = 1;
+  int status;
+
+  if (argc > 2 && strcmp(argv[1], "-g") == 0) {
+    gap = (uint32_t) strtoul(argv[2], NULL, 0);
+    argi = 3;
+  }
+
+  if (argc - argi != 3) {
+    fprintf(stderr, "usage: %s [-g <gap>] <spi4|spi3|i2c> <clock, Hz> <trace>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (strcmp(argv[argi], "spi4") == 0) {
+    sh1106_bus_model_init(&model, SH1106_BUS_SPI_4_WIRE, (uint32_t) strtoul(argv[argi + 1], NULL, 0));
+  } else if (strcmp(argv[argi], "spi3") == 0) {
+    sh1106_bus_model_init(&model, SH1106_BUS_SPI_3_WIRE, (uint32_t) strtoul(argv[argi + 1], NULL, 0));
+  } else if (strcmp(argv[argi], "i2c") == 0) {
+    sh1106_bus_model_init(&model, SH1106_BUS_I2C, (uint32_t) strtoul(argv[argi + 1], NULL, 0));
+  } else {
+    fprintf(stderr, "%s: unknown bus\n", argv[argi]);
+    return EXIT_FAILURE;
+  }
+
+  trace = file_load(argv[argi + 2], &size);
+  if (trace == NULL || (offset = sh1106_trace_read_header(trace, size, &ticks_per_second)) == 0) {
+    fprintf(stderr, "%s: can not read trace\n", argv[argi + 2]);
+    return EXIT_FAILURE;
+  }
+  if (gap == 0) {
+    gap = ticks_per_second / 100;
+  }
+
+  sh1106_bus_reset(&frame);
+  sh1106_bus_reset(&total);
+  sh1106_bus_reset(&worst);
+  memset(&record, 0x00, sizeof(record));
+
+  printf("%6s %8s %8s %12s %12s\n", "frame", "commands", "data", "transactions", "wire, us");
+
+  for (;;) {
+    status = sh1106_trace_read(trace, size, &offset, &record);
+
+    if (frame.commands + frame.data != 0 && (status != 1 || record.time - last >= gap)) {
+      printf("%6u %8lu %8lu %12lu %12.1f\n",
+             frames,
+             (unsigned long) frame.commands,
+             (unsigned long) frame.data,
+             (unsigned long) frame.transactions,
+             frame.time / 1e3);
+      if (frame.time > worst.time) {
+        worst = frame;
+      }
+      total.commands += frame.commands;
+      total.data += frame.data;
+      total.transactions += frame.transactions;
+      total.time += frame.time;
+      frames++;
+      sh1106_bus_reset(&frame);
+    }
+
+    if (status != 1) {
+      break;
+    }
+
+    if (frames == 0 && frame.commands + frame.data == 0) {
+      first = record.time;
+    }
+    last = record.time;
+    sh1106_bus_account(&model, &frame, record.data, record.size);
+  }
+
+  if (frames == 0) {
+    fprintf(stderr, "%s: trace is empty\n", argv[argi + 2]);
+    return EXIT_FAILURE;
+  }
+
+  printf("%u frames, %lu command bytes, %lu data bytes, %lu transactions, %.1f us wire time per frame\n",
+         frames,
+         (unsigned long) total.commands,
+         (unsigned long) total.data,
+         (unsigned long) total.transactions,
+         total.time / 1e3 / frames);
+  printf("heaviest frame %.1f us, max %.2f fps\n", worst.time / 1e3, sh1106_bus_max_fps(&worst) / 100.0);
+
+  if (frames > 1 && last != first) {
+    double fps = (double) (frames - 1) * ticks_per_second / (last - first);
+
+    printf("recorded %.2f fps, bus utilization %.2f%%\n", fps, 100.0 * total.time / frames * fps / 1e9);
+  }
+
+  if (status < 0) {
+    fprintf(stderr, "%s: trace is truncated\n", argv[argi + 2]);
+  }
+
+  free(trace);
+  return status < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Checks of the library against the emulator, run by CTest when the host tools are built.
+ *
+ * Usage: sh1106_check
+ *
+ * Prints the number of mismatches of every check and fails if any check has one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sh1106_check.h"
+
+struct sh1106_emulator check_emulator;
+
+static uint32_t state = 1;
+
+void check_send8_cmd(uint8_t cmd) {
+  sh1106_emulator_cmd(&check_emulator, cmd);
+}
+
+void check_send8_data(uint8_t data) {
+  sh1106_emulator_data(&check_emulator, data);
+}
+
+uint16_t check_random(void) {
+  state = state * 1103515245UL + 12345UL;
+  return (uint16_t) ((state >> 16) & 0x7FFF);
+}
+
+static const struct {
+  const char *name;
+  int (*run)(void);
+} checks[] = {
+    {"device", check_device},
+    {"slide_in", check_slide_in},
+    {"sparse", check_sparse},
+    {"animation", check_animation},
+    {"scrub", check_scrub},
+    {"budget", check_budget},
+    {"asset", check_asset},
+    {"widget", check_widget},
+    {"partial", check_partial},
+    {"image", check_image},
+    {"window", check_window},
+    {"orientation", check_orientation},
+    {"tiled", check_tiled},
+    {"pacer", check_pacer},
+    {"transfer", check_transfer},
+    {"bus", check_bus},
+    {"compositor", check_compositor},
+    {"timing", check_timing},
+    {"affine", check_affine},
+    {"hash", check_hash},
+#ifdef SH1106_VIDEO
+    {"video", check_video},
+#endif
+};
+
+int main(void) {
+  int failed = 0;
+  size_t index;
+
+  for (index = 0; index < sizeof(checks) / sizeof(checks[0]); index++) {
+    int mismatches;
+
+    state = 1;
+    sh1106_emulator_reset(&check_emulator);
+    mismatches = checks[index].run();
+    printf("%s: %d mismatches\n", checks[index].name, mismatches);
+    failed |= mismatches != 0;
+  }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
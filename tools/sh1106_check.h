@@ -0,0 +1,214 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_CHECK_H
+#define YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_CHECK_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_emulator.h"
+
+/**
+ * @brief Emulator driven by check_send8_cmd() and check_send8_data().
+ */
+extern struct sh1106_emulator check_emulator;
+
+/**
+ * @brief Command transport into check_emulator.
+ *
+ * @param[in] cmd Command byte
+ */
+void check_send8_cmd(uint8_t cmd);
+
+/**
+ * @brief Data transport into check_emulator.
+ *
+ * @param[in] data Data byte
+ */
+void check_send8_data(uint8_t data);
+
+/**
+ * @brief Pseudo-random number, the same sequence on every host.
+ *
+ * @return Number in 0 - 32767
+ */
+uint16_t check_random(void);
+
+/**
+ * @brief Encode frames as an animation (see sh1106_animation.h), every delta in runs that end at the page.
+ *
+ * @param[out] data Animation, 8 + 4 * width * pages * (count + 1) bytes are enough
+ * @param[in] frames Frames of width * pages bytes, one after the other
+ * @param[in] width Width in columns
+ * @param[in] pages Height in pages, width * pages up to 255
+ * @param[in] count Number of frames
+ *
+ * @return Size of the animation
+ */
+uint16_t check_animation_encode(uint8_t *data, const uint8_t *frames, uint8_t width, uint8_t pages, uint16_t count);
+
+/**
+ * @brief Check that sh1106::device sends the same byte stream as the C API.
+ *
+ * @return Number of mismatches
+ */
+int check_device(void);
+
+/**
+ * @brief Check that a slide-in never shows the new frame above the old one.
+ *
+ * @return Number of mismatches
+ */
+int check_slide_in(void);
+
+/**
+ * @brief Check that the sparse framebuffer draws and flushes like the dense one.
+ *
+ * @return Number of mismatches
+ */
+int check_sparse(void);
+
+/**
+ * @brief Check that the animation player shows every frame in its region and nothing outside it.
+ *
+ * @return Number of mismatches
+ */
+int check_animation(void);
+
+/**
+ * @brief Check that the scrubber restores the display RAM every period and counts only real overruns.
+ *
+ * @return Number of mismatches
+ */
+int check_scrub(void);
+
+/**
+ * @brief Check that the budgeted flush keeps its byte and time budgets and ends with the display RAM of a dense flush.
+ *
+ * @return Number of mismatches
+ */
+int check_budget(void);
+
+/**
+ * @brief Check that asset bundle validation rejects entries that reach outside of the bundle.
+ *
+ * @return Number of mismatches
+ */
+int check_asset(void);
+
+/**
+ * @brief Check that incremental widget rendering flushes only the merged damage and matches a full render.
+ *
+ * @return Number of mismatches
+ */
+int check_widget(void);
+
+/**
+ * @brief Check that a partial display band shows the framebuffer on its COM lines and nothing else.
+ *
+ * @return Number of mismatches
+ */
+int check_partial(void);
+
+/**
+ * @brief Check that compressed images decode to what was encoded and that malformed streams are rejected.
+ *
+ * @return Number of mismatches
+ */
+int check_image(void);
+
+/**
+ * @brief Check that windows clip, translate and track their dirty sets on their own.
+ *
+ * @return Number of mismatches
+ */
+int check_window(void);
+
+/**
+ * @brief Check that portrait frames show upright on a module turned 90 or 270 degrees clockwise.
+ *
+ * @return Number of mismatches
+ */
+int check_orientation(void);
+
+/**
+ * @brief Check that the panels of a tiled canvas show their slices of it.
+ *
+ * @return Number of mismatches
+ */
+int check_tiled(void);
+
+/**
+ * @brief Check that the frame pacer coalesces bursts into paced flushes and counts what it drops.
+ *
+ * @return Number of mismatches
+ */
+int check_pacer(void);
+
+/**
+ * @brief Check that transfer lists, cached or not, send what a flush to the same pages sends.
+ *
+ * @return Number of mismatches
+ */
+int check_transfer(void);
+
+/**
+ * @brief Check that the bus model counts what the emulator decodes and keeps the wire time of byte-by-byte accounting.
+ *
+ * @return Number of mismatches
+ */
+int check_bus(void);
+
+/**
+ * @brief Check that the compositor shows the layers stacked bottom to top and sends only their merged damage.
+ *
+ * @return Number of mismatches
+ */
+int check_compositor(void);
+
+/**
+ * @brief Check that a compositor flush records its stages into the flush timing.
+ *
+ * @return Number of mismatches
+ */
+int check_timing(void);
+
+/**
+ * @brief Check that affine blits show the source pixel every pixel centre maps to, down to the smallest scale.
+ *
+ * @return Number of mismatches
+ */
+int check_affine(void);
+
+/**
+ * @brief Check that hashed flushes of a window send only its rectangle and bring it up to date.
+ *
+ * @return Number of mismatches
+ */
+int check_hash(void);
+
+/**
+ * @brief Check that the video player shows the newest frame sent in its region and nothing outside it.
+ *
+ * @return Number of mismatches
+ */
+int check_video(void);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_CHECK_H
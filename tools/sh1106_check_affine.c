@@ -0,0 +1,102 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Affine blits: a random image is rotated by random angles and scaled from the smallest scale (one source pixel per
+ * 256 screen pixels, steps of 2^24) to enlarging, about pivots anywhere on the screen, and flushed into the emulator.
+ * Every pixel must show the source pixel its centre maps to, computed from the rotation in 64 bit, or keep its value
+ * if that lies outside of the image.
+ */
+
+#include "sh1106_affine.h"
+#include "sh1106_check.h"
+
+int check_affine(void) {
+  static const uint16_t scales[] = {1, 2, 3, 64, 256, 300, 1024};
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t expected[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t source[32 * 4];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_asset image;
+  struct sh1106_affine affine;
+  int mismatches = 0;
+  unsigned frame;
+  unsigned offset;
+
+  for (offset = 0; offset < sizeof(source); offset++) {
+    source[offset] = (uint8_t) check_random();
+  }
+  image.frames = source;
+  image.count = 1;
+  image.kind = SH1106_ASSET_IMAGE;
+  image.first = 0;
+
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+
+  for (frame = 0; frame < 300; frame++) {
+    int16_t degrees = (int16_t) (check_random() % 720 - 360);
+    uint16_t scale = scales[check_random() % (sizeof(scales) / sizeof(scales[0]))];
+    int16_t x = (int16_t) (check_random() % SH1106_COLUMNS);
+    int16_t y = (int16_t) (check_random() % (SH1106_PAGES * 8));
+    int16_t source_x;
+    int16_t source_y;
+    int64_t sin;
+    int64_t cos;
+    int16_t column;
+    int16_t line;
+
+    image.width = (uint8_t) (check_random() % 32 + 1);
+    image.pages = (uint8_t) (check_random() % 4 + 1);
+    source_x = (int16_t) (check_random() % image.width);
+    source_y = (int16_t) (check_random() % (image.pages * 8));
+    sh1106_affine_rotation(&affine, degrees, scale, source_x, source_y, x, y);
+    sin = sh1106_sin(degrees) * 256 / scale;
+    cos = sh1106_cos(degrees) * 256 / scale;
+
+    for (offset = 0; offset < sizeof(expected); offset++) {
+      expected[offset] = pixels[offset];
+    }
+    for (column = 0; column < SH1106_COLUMNS; column++) {
+      for (line = 0; line < SH1106_PAGES * 8; line++) {
+        /* the pivot centre maps to the pivot centre, the rest is turned counterclockwise back */
+        int64_t u = ((int64_t) source_x << 16) + 0x8000 + cos * (column - x) + sin * (line - y);
+        int64_t v = ((int64_t) source_y << 16) + 0x8000 - sin * (column - x) + cos * (line - y);
+        uint8_t *pixel = &expected[(line / 8) * SH1106_COLUMNS + column];
+
+        if (u >= 0 && u < ((int64_t) image.width << 16) && v >= 0 && v < ((int64_t) image.pages << 19)) {
+          uint8_t bit = (uint8_t) ((source[(v >> 19) * image.width + (u >> 16)] >> ((v >> 16) & 0x07)) & 0x01);
+
+          *pixel = (uint8_t) ((*pixel & ~(1 << (line % 8))) | (bit << (line % 8)));
+        }
+      }
+    }
+
+    sh1106_framebuffer_draw_affine(&framebuffer, &image, 0, &affine);
+    sh1106_framebuffer_flush(check_send8_cmd, check_send8_data, &framebuffer);
+
+    for (offset = 0; offset < sizeof(expected); offset++) {
+      mismatches += check_emulator.ram[offset / SH1106_COLUMNS][offset % SH1106_COLUMNS] != expected[offset];
+    }
+  }
+
+  return mismatches;
+}
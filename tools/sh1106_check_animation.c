@@ -0,0 +1,141 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Animation player: after every frame the region of the display shows that frame and the rest of the display is left
+ * alone, also when a run starts a page right where the previous run ended the page before.
+ */
+
+#include <string.h>
+
+#include "sh1106_animation.h"
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+
+#define WIDTH 4
+#define PAGES 2
+#define FRAMES 16
+#define COLUMN 10
+#define PAGE_ADDR 2
+
+uint16_t check_animation_encode(uint8_t *data, const uint8_t *frames, uint8_t width, uint8_t pages, uint16_t count) {
+  uint16_t frame_size = (uint16_t) (width * pages);
+  uint16_t size = SH1106_ANIMATION_HEADER_SIZE;
+  uint16_t frame;
+
+  memcpy(data, "SHAN", 4);
+  data[4] = width;
+  data[5] = pages;
+  data[6] = (uint8_t) (count & 0xFF);
+  data[7] = (uint8_t) (count >> 8);
+  memcpy(&data[size], frames, frame_size);
+  size = (uint16_t) (size + frame_size);
+
+  for (frame = 0; frame < count; frame++) {
+    const uint8_t *from = &frames[frame * frame_size];
+    const uint8_t *to = &frames[((frame + 1) % count) * frame_size];
+    uint16_t position = 0;
+    uint16_t start = 0;
+
+    while (start < frame_size) {
+      uint16_t end = (uint16_t) (start + 1);
+
+      if (from[start] == to[start]) {
+        start++;
+        continue;
+      }
+
+      /* Runs end at the page, so a change on both sides of a page boundary gives a run with skip 0 */
+      while (end % width != 0 && from[end] != to[end]) {
+        end++;
+      }
+      data[size++] = (uint8_t) (start - position);
+      data[size++] = (uint8_t) (end - start);
+      for (; start < end; start++) {
+        data[size++] = (uint8_t) (from[start] ^ to[start]);
+      }
+      position = end;
+    }
+    data[size++] = 0;
+    data[size++] = 0;
+  }
+
+  return size;
+}
+
+int check_animation(void) {
+  static uint8_t frames[FRAMES][WIDTH * PAGES];
+  static uint8_t data[1024];
+  static uint8_t before[SH1106_PAGES][SH1106_COLUMNS];
+  uint8_t pixels[WIDTH * PAGES];
+  struct sh1106_animation animation;
+  int mismatches = 0;
+  uint16_t frame;
+  uint16_t index;
+  uint16_t size;
+  uint32_t now;
+
+  for (index = 0; index < sizeof(before); index++) {
+    before[index / SH1106_COLUMNS][index % SH1106_COLUMNS] = (uint8_t) check_random();
+  }
+  for (index = 0; index < SH1106_PAGES; index++) {
+    sh1106_write_span(check_send8_cmd, check_send8_data, (uint8_t) index, 0, before[index], SH1106_COLUMNS);
+  }
+
+  /* Frame 1 changes only the last byte of the first page and the first byte of the second page */
+  for (index = 0; index < WIDTH * PAGES; index++) {
+    frames[0][index] = (uint8_t) check_random();
+  }
+  memcpy(frames[1], frames[0], WIDTH * PAGES);
+  frames[1][WIDTH - 1] ^= 0xFF;
+  frames[1][WIDTH] ^= 0xFF;
+  for (frame = 2; frame < FRAMES; frame++) {
+    for (index = 0; index < WIDTH * PAGES; index++) {
+      frames[frame][index] = (uint8_t) (check_random() & 1 ? check_random() : frames[frame - 1][index]);
+    }
+  }
+
+  size = check_animation_encode(data, frames[0], WIDTH, PAGES, FRAMES);
+  if (sh1106_animation_check(data, size) != FRAMES) {
+    return 1;
+  }
+
+  sh1106_animation_init(&animation, data, pixels, COLUMN, PAGE_ADDR);
+  sh1106_animation_play(&animation, 0, 1, 2);
+  for (now = 0; now < 2 * FRAMES; now++) {
+    uint8_t page;
+
+    sh1106_animation_poll(&animation, check_send8_cmd, check_send8_data, now);
+    for (page = 0; page < SH1106_PAGES; page++) {
+      uint8_t column;
+
+      for (column = 0; column < SH1106_COLUMNS; column++) {
+        uint8_t expected = before[page][column];
+
+        if (page >= PAGE_ADDR && page < PAGE_ADDR + PAGES && column >= COLUMN && column < COLUMN + WIDTH) {
+          expected = frames[now % FRAMES][(page - PAGE_ADDR) * WIDTH + column - COLUMN];
+        }
+        mismatches += check_emulator.ram[page][column] != expected;
+      }
+    }
+  }
+
+  return mismatches;
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Asset bundle validation: a well-formed bundle passes, and crafted index entries that point outside of the bundle,
+ * are higher than the display or whose frame size times frame count wraps 32 bits are rejected.
+ */
+
+#include <string.h>
+
+#include "sh1106_asset.h"
+#include "sh1106_check.h"
+
+#define OFFSET (SH1106_ASSET_HEADER_SIZE + SH1106_ASSET_ENTRY_SIZE)
+
+static uint8_t bundle[70000];
+
+static void header(uint16_t count) {
+  memset(bundle, 0x00, sizeof(bundle));
+  memcpy(bundle, "SHAB", 4);
+  bundle[4] = (uint8_t) (count & 0xFF);
+  bundle[5] = (uint8_t) (count >> 8);
+}
+
+static void entry(uint16_t id, uint32_t offset, uint16_t frames, uint8_t kind, uint8_t width, uint8_t pages) {
+  uint8_t *bytes = &bundle[SH1106_ASSET_HEADER_SIZE + id * SH1106_ASSET_ENTRY_SIZE];
+
+  bytes[0] = (uint8_t) (offset & 0xFF);
+  bytes[1] = (uint8_t) ((offset >> 8) & 0xFF);
+  bytes[2] = (uint8_t) ((offset >> 16) & 0xFF);
+  bytes[3] = (uint8_t) (offset >> 24);
+  bytes[4] = (uint8_t) (frames & 0xFF);
+  bytes[5] = (uint8_t) (frames >> 8);
+  bytes[6] = kind;
+  bytes[7] = width;
+  bytes[8] = pages;
+  bytes[9] = 0;
+}
+
+static int single(uint32_t size, uint32_t offset, uint16_t frames, uint8_t kind, uint8_t width, uint8_t pages) {
+  header(1);
+  entry(0, offset, frames, kind, width, pages);
+  return sh1106_asset_bundle_check(bundle, size);
+}
+
+int check_asset(void) {
+  struct sh1106_asset asset;
+  int mismatches = 0;
+
+  /* An image of 2 frames of 4x1 and a sprite of 3x2 right after it */
+  header(2);
+  entry(0, 2 * SH1106_ASSET_ENTRY_SIZE + SH1106_ASSET_HEADER_SIZE, 2, SH1106_ASSET_IMAGE, 4, 1);
+  entry(1, 2 * SH1106_ASSET_ENTRY_SIZE + SH1106_ASSET_HEADER_SIZE + 8, 1, SH1106_ASSET_SPRITE, 3, 2);
+  mismatches += sh1106_asset_bundle_check(bundle, 2 * SH1106_ASSET_ENTRY_SIZE + SH1106_ASSET_HEADER_SIZE + 20) != 2;
+  mismatches += sh1106_asset_bundle_check(bundle, 2 * SH1106_ASSET_ENTRY_SIZE + SH1106_ASSET_HEADER_SIZE + 19) != -1;
+  mismatches += sh1106_asset_get(bundle, 1, &asset) != 0 || sh1106_asset_frame(&asset, 0) != &bundle[40];
+  mismatches += sh1106_asset_get(bundle, 2, &asset) != -1;
+
+  /* Header and index */
+  mismatches += sh1106_asset_bundle_check(bundle, SH1106_ASSET_HEADER_SIZE - 1) != -1;
+  mismatches += single(OFFSET - 1, OFFSET, 1, SH1106_ASSET_IMAGE, 1, 1) != -1;
+  bundle[0] = 'X';
+  mismatches += sh1106_asset_bundle_check(bundle, sizeof(bundle)) != -1;
+
+  /* Frames that fit exactly, one byte short, from past the end and of an unknown kind */
+  mismatches += single(OFFSET + 3 * 2 * 255 * 8, OFFSET, 3, SH1106_ASSET_SPRITE, 255, 8) != 1;
+  mismatches += single(OFFSET + 3 * 2 * 255 * 8 - 1, OFFSET, 3, SH1106_ASSET_SPRITE, 255, 8) != -1;
+  mismatches += single(OFFSET + 16, OFFSET + 17, 1, SH1106_ASSET_IMAGE, 1, 1) != -1;
+  mismatches += single(OFFSET + 16, UINT32_MAX, 1, SH1106_ASSET_IMAGE, 1, 1) != -1;
+  mismatches += single(OFFSET + 16, OFFSET, 1, SH1106_ASSET_FONT + 1, 1, 1) != -1;
+  mismatches += single(OFFSET + 16, OFFSET, 0, SH1106_ASSET_IMAGE, 1, 1) != -1;
+
+  /* Higher than the display */
+  mismatches += single(OFFSET + 9 * 8, OFFSET, 1, SH1106_ASSET_IMAGE, 8, SH1106_PAGES + 1) != -1;
+
+  /* 130050 bytes per frame times 33026 frames wraps to 63004 bytes, which would fit */
+  mismatches += single(sizeof(bundle), OFFSET, 33026, SH1106_ASSET_SPRITE, 255, 255) != -1;
+
+  return mismatches;
+}
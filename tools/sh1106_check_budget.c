@@ -0,0 +1,156 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Budgeted flush: random drawing flushed a slice at a time, under a byte budget or a time budget of a simulated clock
+ * that ticks once per byte sent. No flush goes over the byte budget, none takes longer than the time budget and one
+ * chunk with its page and column address, and once nothing is pending the display RAM equals a dense flush. Within a
+ * flush the emulator sees the columns of the priority 9 region first, then those of 5, then those of 1 and then the
+ * rest. With a clock that is late by the whole time budget at every read, every flush still sends a chunk.
+ */
+
+#include <string.h>
+
+#include "sh1106_budget.h"
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+
+static struct sh1106_emulator dense_emulator;
+
+static uint32_t ticks;
+static uint32_t lag;
+
+/* Rank of the region of the last data byte of the flush, and the flushes that went back to a higher one */
+static uint8_t rank;
+static unsigned reorders;
+
+static uint32_t budget_clock(void) {
+  ticks += lag;
+  return ticks;
+}
+
+/* 0 for the priority 9 region, 1 for 5, 2 for 1 and 3 for the rest, see flush() */
+static uint8_t rank_of(uint8_t page_addr, uint8_t column) {
+  if (page_addr >= 5 && column >= 100) {
+    return 0;
+  }
+  if (page_addr >= 2 && page_addr <= 3 && column >= 50 && column < 60) {
+    return 1;
+  }
+  if (page_addr <= 1 && column < 20) {
+    return 2;
+  }
+  return 3;
+}
+
+static void budget_send8_cmd(uint8_t cmd) {
+  ticks++;
+  check_send8_cmd(cmd);
+}
+
+static void budget_send8_data(uint8_t data) {
+  uint8_t data_rank = rank_of(check_emulator.page_addr, check_emulator.column_addr);
+
+  reorders += data_rank < rank;
+  rank = data_rank;
+  ticks++;
+  check_send8_data(data);
+}
+
+static uint16_t budget_flush(struct sh1106_budget *budget, uint16_t bytes, uint32_t time) {
+  rank = 0;
+  return sh1106_budget_flush(budget, budget_send8_cmd, budget_send8_data, bytes, time);
+}
+
+static void dense_send8_cmd(uint8_t cmd) {
+  sh1106_emulator_cmd(&dense_emulator, cmd);
+}
+
+static void dense_send8_data(uint8_t data) {
+  sh1106_emulator_data(&dense_emulator, data);
+}
+
+static int flush(uint16_t bytes, uint32_t time, uint32_t clock_lag) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_budget budget;
+  int mismatches = 0;
+  unsigned frame;
+
+  lag = clock_lag;
+  reorders = 0;
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_emulator_reset(&dense_emulator);
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  sh1106_budget_init(&budget, &framebuffer, budget_clock);
+  sh1106_budget_add_region(&budget, 0, 0, 20, 16, 1);
+  sh1106_budget_add_region(&budget, 100, 40, 32, 24, 9);
+  sh1106_budget_add_region(&budget, 50, 20, 10, 10, 5);
+
+  for (frame = 0; frame < 2000; frame++) {
+    unsigned operations = check_random() % 4;
+    uint32_t start = ticks;
+    int pending;
+    uint16_t sent;
+
+    while (operations-- != 0) {
+      sh1106_framebuffer_fill_rect(&framebuffer,
+                                   (int16_t) (check_random() % 140 - 4),
+                                   (int16_t) (check_random() % 70 - 3),
+                                   (int16_t) (check_random() % 40),
+                                   (int16_t) (check_random() % 20),
+                                   (uint8_t) (check_random() & 1));
+    }
+
+    pending = sh1106_budget_pending(&budget);
+    sent = budget_flush(&budget, bytes, time);
+    mismatches += bytes && sent > bytes;
+    mismatches += pending && sent == 0;
+    mismatches += time && !lag && ticks - start > time + 3 + SH1106_BUDGET_CHUNK;
+  }
+
+  mismatches += bytes && budget.metrics.max_bytes > bytes;
+  mismatches += time && !lag && budget.metrics.max_ticks > time + 3 + SH1106_BUDGET_CHUNK;
+  mismatches += (bytes || time) && budget.metrics.partial == 0;
+
+  /* The whole screen, in priority order within every flush */
+  sh1106_framebuffer_invalidate(&framebuffer);
+  for (frame = 0; frame < 1000 && sh1106_budget_pending(&budget); frame++) {
+    budget_flush(&budget, bytes, time);
+  }
+  mismatches += sh1106_budget_pending(&budget);
+  mismatches += reorders != 0;
+  sh1106_framebuffer_invalidate(&framebuffer);
+  sh1106_framebuffer_flush(dense_send8_cmd, dense_send8_data, &framebuffer);
+  mismatches += memcmp(check_emulator.ram, dense_emulator.ram, sizeof(check_emulator.ram)) != 0;
+  return mismatches;
+}
+
+int check_budget(void) {
+  int mismatches = 0;
+
+  mismatches += flush(40, 0, 0);
+  mismatches += flush(7, 0, 0);
+  mismatches += flush(0, 60, 0);
+  mismatches += flush(100, 30, 0);
+  mismatches += flush(0, 0, 0);
+  mismatches += flush(0, 30, 30);
+  return mismatches;
+}
@@ -0,0 +1,130 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Bus wire-time model: random dirty sets are flushed into the emulator on every bus interface, each byte accounted on
+ * its own as it goes out. The byte counts must match what the emulator decoded, and the transactions, D/C switches,
+ * bit times and wire time must match a model built from the runs of same-kind bytes seen on the wire, with the bit
+ * times rounded to ns once for the whole stream.
+ */
+
+#include "sh1106_bus.h"
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+
+static const struct sh1106_bus_model *bus_model;
+static struct sh1106_bus_stats bus_stats;
+
+/* Expected model */
+static uint32_t expected_transactions;
+static uint32_t expected_dc_switches;
+static uint64_t expected_bits;
+static uint8_t expected_kind;
+static uint8_t expected_dc;
+static uint32_t expected_length;
+
+static void expect(uint8_t kind) {
+  if (expected_kind != kind || (bus_model->transaction_max != 0 && expected_length == bus_model->transaction_max)) {
+    if (bus_model->bus == SH1106_BUS_SPI_4_WIRE && expected_dc != kind) {
+      expected_dc_switches++;
+      expected_dc = kind;
+    }
+    if (bus_model->bus == SH1106_BUS_I2C) {
+      expected_bits += 1 + 9 + 9 + 1;
+    }
+    expected_transactions++;
+    expected_kind = kind;
+    expected_length = 0;
+  }
+  expected_bits += bus_model->bus == SH1106_BUS_SPI_4_WIRE ? 8 : 9;
+  expected_length++;
+}
+
+static void bus_send8_cmd(uint8_t cmd) {
+  check_send8_cmd(cmd);
+  sh1106_bus_account(bus_model, &bus_stats, 0, 1);
+  expect(1);
+}
+
+static void bus_send8_data(uint8_t data) {
+  check_send8_data(data);
+  sh1106_bus_account(bus_model, &bus_stats, 1, 1);
+  expect(2);
+}
+
+static int bus(enum sh1106_bus interface, uint32_t clock) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_bus_model model;
+  int mismatches = 0;
+  unsigned frame;
+
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  sh1106_bus_model_init(&model, interface, clock);
+  sh1106_bus_reset(&bus_stats);
+  bus_model = &model;
+  expected_transactions = 0;
+  expected_dc_switches = 0;
+  expected_bits = 0;
+  expected_kind = 0;
+  expected_dc = 0;
+  expected_length = 0;
+
+  for (frame = 0; frame < 200; frame++) {
+    uint64_t time;
+
+    sh1106_framebuffer_fill_rect(&framebuffer,
+                                 (int16_t) (check_random() % 140 - 4),
+                                 (int16_t) (check_random() % 72 - 4),
+                                 (int16_t) (check_random() % 60 + 1),
+                                 (int16_t) (check_random() % 30 + 1),
+                                 (uint8_t) (check_random() % 2));
+    sh1106_framebuffer_flush(bus_send8_cmd, bus_send8_data, &framebuffer);
+    sh1106_bus_end(&bus_stats);
+    expected_kind = 0;
+    expected_length = 0;
+
+    time = (uint64_t) expected_transactions * model.transaction_overhead
+        + (uint64_t) expected_dc_switches * model.dc_switch
+        + expected_bits * 1000000000ULL / clock;
+
+    mismatches += bus_stats.commands != check_emulator.commands;
+    mismatches += bus_stats.data != check_emulator.data;
+    mismatches += bus_stats.transactions != expected_transactions;
+    mismatches += bus_stats.dc_switches != expected_dc_switches;
+    mismatches += bus_stats.bits != expected_bits;
+    mismatches += bus_stats.time != time;
+  }
+
+  return mismatches;
+}
+
+int check_bus(void) {
+  int mismatches = 0;
+
+  /* Clocks whose bit time is not a whole number of ns */
+  mismatches += bus(SH1106_BUS_SPI_4_WIRE, 3000000);
+  mismatches += bus(SH1106_BUS_SPI_3_WIRE, 7000000);
+  mismatches += bus(SH1106_BUS_I2C, 300000);
+
+  return mismatches;
+}
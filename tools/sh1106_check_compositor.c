@@ -0,0 +1,131 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Layer compositing: a stack of ORed and masked layers gets random drawing on random layers, now and then a new mask,
+ * and is flushed into the emulator. The display RAM must match the layers composited from scratch bottom to top, and
+ * every flush must send exactly the union of the layer dirty spans of each page.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_compositor.h"
+
+#define COMPOSITOR_LAYERS 3
+
+int check_compositor(void) {
+  static uint8_t pixels[COMPOSITOR_LAYERS][SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t masks[COMPOSITOR_LAYERS][SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t output[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t expected[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_layer layers[COMPOSITOR_LAYERS];
+  struct sh1106_compositor compositor;
+  struct sh1106_compositor full;
+  int mismatches = 0;
+  unsigned frame;
+  unsigned index;
+  unsigned offset;
+
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_compositor_init(&compositor, output);
+
+  /* An ORed layer at the bottom and masked layers above it */
+  for (index = 0; index < COMPOSITOR_LAYERS; index++) {
+    for (offset = 0; offset < sizeof(masks[index]); offset++) {
+      masks[index][offset] = (uint8_t) check_random();
+    }
+    sh1106_layer_init(&layers[index], pixels[index], index == 0 ? NULL : masks[index]);
+    mismatches += sh1106_compositor_add(&compositor, &layers[index]) != 0;
+  }
+
+  /* A stack takes no more than SH1106_COMPOSITOR_MAX_LAYERS */
+  sh1106_compositor_init(&full, expected);
+  for (index = 0; index <= SH1106_COMPOSITOR_MAX_LAYERS; index++) {
+    mismatches += sh1106_compositor_add(&full, &layers[0]) != (index < SH1106_COMPOSITOR_MAX_LAYERS ? 0 : -1);
+  }
+
+  for (frame = 0; frame < 1000; frame++) {
+    struct sh1106_layer *layer = &layers[check_random() % COMPOSITOR_LAYERS];
+    struct sh1106_dirty damage;
+    uint32_t data = check_emulator.data;
+    uint16_t size = 0;
+    uint16_t sent;
+    uint8_t page_addr;
+
+    if (layer->mask != NULL && check_random() % 8 == 0) {
+      /* New mask, the layer has to be invalidated */
+      for (offset = 0; offset < sizeof(masks[0]); offset++) {
+        masks[layer - layers][offset] = (uint8_t) check_random();
+      }
+      sh1106_framebuffer_invalidate(&layer->framebuffer);
+    } else {
+      sh1106_framebuffer_fill_rect(&layer->framebuffer,
+                                   (int16_t) (check_random() % 140 - 4),
+                                   (int16_t) (check_random() % 72 - 4),
+                                   (int16_t) (check_random() % 40 + 1),
+                                   (int16_t) (check_random() % 20 + 1),
+                                   (uint8_t) (check_random() % 2));
+    }
+
+    sh1106_dirty_reset(&damage);
+    for (index = 0; index < COMPOSITOR_LAYERS; index++) {
+      const struct sh1106_dirty *dirty = &layers[index].framebuffer.dirty;
+
+      for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+        if (dirty->pages & (1 << page_addr)) {
+          sh1106_dirty_mark(&damage, page_addr, dirty->first[page_addr], dirty->last[page_addr]);
+        }
+      }
+    }
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      if (damage.pages & (1 << page_addr)) {
+        size = (uint16_t) (size + damage.last[page_addr] - damage.first[page_addr] + 1);
+      }
+    }
+
+    sent = sh1106_compositor_flush(check_send8_cmd, check_send8_data, &compositor);
+    mismatches += sent != size;
+    mismatches += check_emulator.data - data != sent;
+    mismatches += compositor.output.dirty.pages != 0;
+    for (index = 0; index < COMPOSITOR_LAYERS; index++) {
+      mismatches += layers[index].framebuffer.dirty.pages != 0;
+    }
+
+    /* Composite from scratch */
+    memset(expected, 0x00, sizeof(expected));
+    for (index = 0; index < COMPOSITOR_LAYERS; index++) {
+      for (offset = 0; offset < sizeof(expected); offset++) {
+        uint8_t mask = layers[index].mask == NULL ? pixels[index][offset] : masks[index][offset];
+
+        expected[offset] = (uint8_t) ((expected[offset] & ~mask) | (pixels[index][offset] & mask));
+      }
+    }
+
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      mismatches += memcmp(check_emulator.ram[page_addr],
+                           &expected[page_addr * SH1106_COLUMNS],
+                           SH1106_COLUMNS) != 0;
+    }
+  }
+
+  return mismatches;
+}
@@ -0,0 +1,244 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Byte identity of sh1106::device and the C API: every command with every enum value and a range of arguments, and
+ * flushes of random dirty sets, are sent both ways into a byte log and into the emulator. A device of a smaller
+ * geometry flushes the same bytes as a window of that size.
+ */
+
+#include <string.h>
+
+#include "sh1106.hpp"
+
+extern "C" {
+#include "sh1106_check.h"
+}
+
+namespace {
+
+const unsigned log_size = 16384;
+
+/* Byte log, the A0 line in bit 8 */
+struct byte_log {
+  uint16_t bytes[log_size];
+  unsigned size;
+};
+
+byte_log c_log;
+byte_log cpp_log;
+
+void record(byte_log &log, uint16_t byte) {
+  if (log.size < log_size) {
+    log.bytes[log.size] = byte;
+  }
+  log.size++;
+}
+
+void c_send8_cmd(uint8_t cmd) {
+  record(c_log, cmd);
+  check_send8_cmd(cmd);
+}
+
+void c_send8_data(uint8_t data) {
+  record(c_log, (uint16_t) (0x100 | data));
+  check_send8_data(data);
+}
+
+struct sh1106_emulator cpp_emulator;
+
+struct log_transport {
+  static void send8_cmd(uint8_t cmd) {
+    record(cpp_log, cmd);
+    sh1106_emulator_cmd(&cpp_emulator, cmd);
+  }
+
+  static void send8_data(uint8_t data) {
+    record(cpp_log, (uint16_t) (0x100 | data));
+    sh1106_emulator_data(&cpp_emulator, data);
+  }
+};
+
+typedef sh1106::device<log_transport> device;
+
+void send_commands(uint8_t value) {
+  static const enum sh1106_pump_voltage pump_voltages[] = {
+      SH1106_PUMP_VOLTAGE_7_4, SH1106_PUMP_VOLTAGE_8_0, SH1106_PUMP_VOLTAGE_8_4, SH1106_PUMP_VOLTAGE_9_0};
+  static const enum sh1106_display_state display_states[] = {
+      SH1106_INTERNAL_ON, SH1106_INTERNAL_OFF, SH1106_OLED_OFF, SH1106_OLED_ON};
+  static const enum sh1106_oscillator_frequency oscillator_frequencies[] = {
+      SH1106_OSCILLATOR_FREQUENCY_MINUS_25_PERCENT, SH1106_OSCILLATOR_FREQUENCY_MINUS_20_PERCENT,
+      SH1106_OSCILLATOR_FREQUENCY_MINUS_15_PERCENT, SH1106_OSCILLATOR_FREQUENCY_MINUS_10_PERCENT,
+      SH1106_OSCILLATOR_FREQUENCY_MINUS_5_PERCENT, SH1106_OSCILLATOR_FREQUENCY_POR};
+  enum sh1106_pump_voltage pump_voltage = pump_voltages[value % 4];
+  enum sh1106_segment_re_map_direction segment_re_map =
+      value & 1 ? SH1106_SEGMENT_RE_MAP_REVERSE_DIRECTION : SH1106_SEGMENT_RE_MAP_NORMAL_DIRECTION;
+  enum sh1106_display_state display_state = display_states[value % 4];
+  enum sh1106_display_direction display_direction =
+      value & 1 ? SH1106_DISPLAY_REVERSE_DIRECTION : SH1106_DISPLAY_NORMAL_DIRECTION;
+  enum sh1106_dc_dc_mode dc_dc_mode = value & 1 ? SH1106_DC_DC_DISABLE : SH1106_DC_DC_ENABLE;
+  enum sh1106_common_output_scan_direction scan_direction =
+      value & 1 ? SH1106_COMMON_OUTPUT_SCAN_DIRECTION_VERTICALLY_FLIPPED : SH1106_COMMON_OUTPUT_SCAN_NORMAL_DIRECTION;
+  enum sh1106_oscillator_frequency oscillator_frequency = oscillator_frequencies[value % 6];
+  enum sh1106_common_signals_pad_configuration pads = value & 1 ? SH1106_COMMON_SIGNALS_PAD_CONFIGURATION_ALTERNATIVE
+                                                                : SH1106_COMMON_SIGNALS_PAD_CONFIGURATION_SEQUENTIAL;
+
+  sh1106_set_column_address(c_send8_cmd, (uint8_t) (value % SH1106_COLUMNS));
+  device::set_column_address((uint8_t) (value % SH1106_COLUMNS));
+  sh1106_set_pump_voltage(c_send8_cmd, pump_voltage);
+  device::set_pump_voltage(pump_voltage);
+  sh1106_set_display_start_line(c_send8_cmd, (uint8_t) (value % 64));
+  device::set_display_start_line((uint8_t) (value % 64));
+  sh1106_set_contrast_control_register(c_send8_cmd, value);
+  device::set_contrast_control_register(value);
+  sh1106_set_segment_re_map(c_send8_cmd, segment_re_map);
+  device::set_segment_re_map(segment_re_map);
+  sh1106_set_display_state(c_send8_cmd, display_state);
+  device::set_display_state(display_state);
+  sh1106_set_display_direction(c_send8_cmd, display_direction);
+  device::set_display_direction(display_direction);
+  sh1106_set_multiplex_ration(c_send8_cmd, (uint8_t) (value % 64));
+  device::set_multiplex_ration((uint8_t) (value % 64));
+  sh1106_set_dc_dc_mode(c_send8_cmd, dc_dc_mode);
+  device::set_dc_dc_mode(dc_dc_mode);
+  sh1106_set_page_address(c_send8_cmd, (uint8_t) (value % SH1106_PAGES));
+  device::set_page_address((uint8_t) (value % SH1106_PAGES));
+  sh1106_set_common_output_scan_direction(c_send8_cmd, scan_direction);
+  device::set_common_output_scan_direction(scan_direction);
+  sh1106_set_display_offset(c_send8_cmd, (uint8_t) (value % 64));
+  device::set_display_offset((uint8_t) (value % 64));
+  sh1106_set_display_clock_divide_ratio_oscillator_frequency(c_send8_cmd,
+                                                              (uint8_t) (value % 16 + 1),
+                                                              oscillator_frequency);
+  device::set_display_clock_divide_ratio_oscillator_frequency((uint8_t) (value % 16 + 1), oscillator_frequency);
+  sh1106_set_dis_charge_pre_charge_period(c_send8_cmd, (uint8_t) (value % 15 + 1), (uint8_t) (value / 16 % 15 + 1));
+  device::set_dis_charge_pre_charge_period((uint8_t) (value % 15 + 1), (uint8_t) (value / 16 % 15 + 1));
+  sh1106_set_common_pads_hardware_configuration(c_send8_cmd, pads);
+  device::set_common_pads_hardware_configuration(pads);
+  sh1106_set_vcom_deselect_level(c_send8_cmd, value);
+  device::set_vcom_deselect_level(value);
+  sh1106_nop(c_send8_cmd);
+  device::nop();
+  sh1106_read_modify_write(c_send8_cmd);
+  device::read_modify_write();
+  sh1106_write_display_data(c_send8_data, value);
+  device::write_display_data(value);
+  sh1106_end(c_send8_cmd);
+  device::end();
+  sh1106_write_display_data(c_send8_data, (uint8_t) ~value);
+  device::write_display_data((uint8_t) ~value);
+}
+
+/* A 64x32 panel in the top left corner of the display RAM */
+struct geometry_64x32 {
+  static const uint8_t columns = 64;
+  static const uint8_t pages = 4;
+};
+
+typedef sh1106::device<log_transport, geometry_64x32> small_device;
+
+/* The flush of a smaller geometry sends the same bytes as the flush of a window of that size */
+int check_geometry() {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer screen;
+  struct sh1106_framebuffer window;
+  int mismatches = 0;
+
+  for (unsigned frame = 0; frame < 64; frame++) {
+    memset(&c_log, 0x00, sizeof(c_log));
+    memset(&cpp_log, 0x00, sizeof(cpp_log));
+    sh1106_framebuffer_init(&screen, pixels, SH1106_PAGES);
+    sh1106_window_init(&window, &screen, 0, 0, geometry_64x32::columns, geometry_64x32::pages * 8);
+    sh1106_dirty_reset(&screen.dirty);
+
+    for (unsigned rectangles = check_random() % 4 + 1; rectangles != 0; rectangles--) {
+      int16_t x = (int16_t) (check_random() % geometry_64x32::columns);
+      int16_t y = (int16_t) (check_random() % (geometry_64x32::pages * 8));
+      int16_t width = (int16_t) (check_random() % (geometry_64x32::columns - x) + 1);
+      int16_t height = (int16_t) (check_random() % (geometry_64x32::pages * 8 - y) + 1);
+
+      sh1106_framebuffer_fill_rect(&screen, x, y, width, height, 1);
+      sh1106_framebuffer_fill_rect(&window, x, y, width, height, 1);
+    }
+
+    mismatches += sh1106_framebuffer_flush(c_send8_cmd, c_send8_data, &window) != small_device::flush(screen);
+
+    /* The whole display RAM dirty, clamped to the geometry */
+    sh1106_framebuffer_invalidate(&screen);
+    sh1106_framebuffer_invalidate(&window);
+    mismatches += sh1106_framebuffer_flush(c_send8_cmd, c_send8_data, &window) != small_device::flush(screen);
+    mismatches += screen.dirty.pages != 0;
+    mismatches += c_log.size != cpp_log.size;
+    for (unsigned index = 0; index < c_log.size && index < cpp_log.size && index < log_size; index++) {
+      mismatches += c_log.bytes[index] != cpp_log.bytes[index];
+    }
+  }
+
+  return mismatches;
+}
+
+} // namespace
+
+extern "C" int check_device(void) {
+  static uint8_t c_pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t cpp_pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer c_framebuffer;
+  struct sh1106_framebuffer cpp_framebuffer;
+  int mismatches = 0;
+  unsigned value;
+  unsigned frame;
+
+  memset(&c_log, 0x00, sizeof(c_log));
+  memset(&cpp_log, 0x00, sizeof(cpp_log));
+  sh1106_emulator_reset(&cpp_emulator);
+
+  for (value = 0; value < 256; value++) {
+    send_commands((uint8_t) value);
+  }
+
+  sh1106_framebuffer_init(&c_framebuffer, c_pixels, SH1106_PAGES);
+  for (frame = 0; frame < 64; frame++) {
+    unsigned rectangles = check_random() % 4;
+
+    while (rectangles-- != 0) {
+      sh1106_framebuffer_fill_rect(&c_framebuffer,
+                                   (int16_t) (check_random() % 140 - 4),
+                                   (int16_t) (check_random() % 72 - 4),
+                                   (int16_t) (check_random() % 40),
+                                   (int16_t) (check_random() % 24),
+                                   (uint8_t) (check_random() & 1));
+    }
+    cpp_framebuffer = c_framebuffer;
+    cpp_framebuffer.pixels = cpp_pixels;
+    memcpy(cpp_pixels, c_pixels, sizeof(c_pixels));
+
+    mismatches += sh1106_framebuffer_flush(c_send8_cmd, c_send8_data, &c_framebuffer)
+        != device::flush(cpp_framebuffer);
+    mismatches += c_framebuffer.dirty.pages != cpp_framebuffer.dirty.pages;
+  }
+
+  mismatches += c_log.size != cpp_log.size || c_log.size > log_size;
+  for (value = 0; value < c_log.size && value < cpp_log.size && value < log_size; value++) {
+    mismatches += c_log.bytes[value] != cpp_log.bytes[value];
+  }
+  mismatches += memcmp(check_emulator.ram, cpp_emulator.ram, sizeof(check_emulator.ram)) != 0;
+  mismatches += check_emulator.commands != cpp_emulator.commands || check_emulator.data != cpp_emulator.data;
+  mismatches += check_geometry();
+  return mismatches;
+}
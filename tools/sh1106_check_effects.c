@@ -0,0 +1,93 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Slide-in of the effects engine: after every step the screen shows the bottom of the old frame above the top of the
+ * new frame, whatever lines per step are asked for.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_effects.h"
+
+#define LINES (SH1106_PAGES * 8)
+
+static uint8_t line_of(const uint8_t *pixels, uint8_t column, uint8_t line) {
+  return (uint8_t) ((pixels[(line / 8) * SH1106_COLUMNS + column] >> (line % 8)) & 0x01);
+}
+
+int check_slide_in(void) {
+  static uint8_t old_pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t new_pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_effects effects;
+  int mismatches = 0;
+  uint8_t lines;
+
+  for (lines = 1; lines <= 20; lines++) {
+    uint32_t now;
+    uint16_t index;
+    uint8_t page_addr;
+
+    for (index = 0; index < sizeof(old_pixels); index++) {
+      old_pixels[index] = (uint8_t) check_random();
+    }
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      sh1106_write_span(check_send8_cmd,
+                        check_send8_data,
+                        page_addr,
+                        0,
+                        &old_pixels[page_addr * SH1106_COLUMNS],
+                        SH1106_COLUMNS);
+    }
+
+    sh1106_framebuffer_init(&framebuffer, new_pixels, SH1106_PAGES);
+    for (index = 0; index < sizeof(new_pixels); index++) {
+      new_pixels[index] = (uint8_t) check_random();
+    }
+
+    sh1106_effects_init(&effects);
+    sh1106_effect_slide_in(&effects, 0, 1, &framebuffer, lines);
+    for (now = 0; sh1106_effects_poll(&effects, check_send8_cmd, check_send8_data, now) != SH1106_EFFECT_NONE; now++) {
+      uint8_t shift = check_emulator.start_line;
+      uint8_t row;
+
+      for (row = 0; row < LINES; row++) {
+        uint8_t line = (uint8_t) ((check_emulator.start_line + row) % LINES);
+        uint8_t column;
+
+        for (column = 0; column < SH1106_COLUMNS; column++) {
+          uint8_t shown = (uint8_t) ((check_emulator.ram[line / 8][column] >> (line % 8)) & 0x01);
+
+          if (row < LINES - shift) {
+            mismatches += shown != line_of(old_pixels, column, (uint8_t) (row + shift));
+          } else {
+            mismatches += shown != line_of(new_pixels, column, (uint8_t) (row + shift - LINES));
+          }
+        }
+      }
+    }
+
+    mismatches += memcmp(check_emulator.ram, new_pixels, sizeof(new_pixels)) != 0;
+    mismatches += check_emulator.start_line != 0;
+  }
+
+  return mismatches;
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Hashed flushes of windows: random drawing goes into the shared pixels through the screen, and two windows, one of
+ * them sharing a page with the other, are flushed with page or chunk hashes of their own. Each flush must leave the
+ * display RAM outside of the pages and columns of its window as it was, bring the window up to date and send as many
+ * data bytes as it returns, and a second flush right after it must send nothing.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_hash.h"
+
+static int hash(uint8_t chunks) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t ram[SH1106_PAGES][SH1106_COLUMNS];
+  struct sh1106_framebuffer screen;
+  struct sh1106_framebuffer windows[2];
+  struct sh1106_page_hashes page_hashes[2];
+  struct sh1106_chunk_hashes chunk_hashes[2];
+  int mismatches = 0;
+  unsigned frame;
+  uint8_t index;
+
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_framebuffer_init(&screen, pixels, SH1106_PAGES);
+  sh1106_window_init(&windows[0], &screen, 3, 5, 60, 20);
+  sh1106_window_init(&windows[1], &screen, 70, 30, 55, 34);
+  for (index = 0; index < 2; index++) {
+    sh1106_page_hashes_reset(&page_hashes[index]);
+    sh1106_chunk_hashes_reset(&chunk_hashes[index]);
+  }
+
+  for (frame = 0; frame < 1000; frame++) {
+    struct sh1106_framebuffer *window;
+    uint32_t data = check_emulator.data;
+    uint16_t sent;
+    uint8_t page_addr;
+    uint8_t column;
+
+    if (check_random() % 2) {
+      sh1106_framebuffer_fill_rect(&screen,
+                                   (int16_t) (check_random() % 140 - 4),
+                                   (int16_t) (check_random() % 72 - 4),
+                                   (int16_t) (check_random() % 30 + 1),
+                                   (int16_t) (check_random() % 20 + 1),
+                                   (uint8_t) (check_random() % 2));
+    }
+
+    index = (uint8_t) (check_random() % 2);
+    window = &windows[index];
+    memcpy(ram, check_emulator.ram, sizeof(ram));
+    if (chunks) {
+      sent = sh1106_framebuffer_flush_hashed_chunks(check_send8_cmd, check_send8_data, window, &chunk_hashes[index]);
+    } else {
+      sent = sh1106_framebuffer_flush_hashed(check_send8_cmd, check_send8_data, window, &page_hashes[index]);
+    }
+    mismatches += check_emulator.data - data != sent;
+
+    /* Nothing changed since */
+    if (chunks) {
+      mismatches += sh1106_framebuffer_flush_hashed_chunks(check_send8_cmd,
+                                                           check_send8_data,
+                                                           window,
+                                                           &chunk_hashes[index]) != 0;
+    } else {
+      mismatches += sh1106_framebuffer_flush_hashed(check_send8_cmd,
+                                                    check_send8_data,
+                                                    window,
+                                                    &page_hashes[index]) != 0;
+    }
+
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      for (column = 0; column < SH1106_COLUMNS; column++) {
+        uint8_t inside = page_addr >= window->clip_y0 / 8 && page_addr <= (window->clip_y1 - 1) / 8
+            && column >= window->clip_x0 && column < window->clip_x1;
+
+        mismatches += check_emulator.ram[page_addr][column]
+            != (inside ? pixels[page_addr * SH1106_COLUMNS + column] : ram[page_addr][column]);
+      }
+    }
+  }
+
+  return mismatches;
+}
+
+int check_hash(void) {
+  int mismatches = 0;
+
+  mismatches += hash(0);
+  mismatches += hash(1);
+  return mismatches;
+}
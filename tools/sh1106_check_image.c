@@ -0,0 +1,182 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Image codec round trip: random images of runs, fills, repeats and noise are encoded, drawn into the emulator at a
+ * random position and must come back byte for byte, with the display RAM around them untouched. An image repeating
+ * itself exactly 256 bytes back must be encoded with COPY tokens that reach the far edge of the window, and every
+ * truncated stream, a stream with a trailing byte and a COPY from before the first byte must be rejected.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_image.h"
+
+#define IMAGE_SIZE (SH1106_COLUMNS * SH1106_PAGES)
+
+static uint8_t pixels[IMAGE_SIZE];
+static uint8_t image[2 * IMAGE_SIZE];
+static uint8_t ram[SH1106_PAGES][SH1106_COLUMNS];
+
+/* Random display RAM, kept in ram to check what the decoder must not touch */
+static void scramble(void) {
+  uint8_t page_addr;
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    uint8_t column;
+
+    sh1106_set_page_address(check_send8_cmd, page_addr);
+    sh1106_set_column_address(check_send8_cmd, 0);
+    for (column = 0; column < SH1106_COLUMNS; column++) {
+      sh1106_write_display_data(check_send8_data, (uint8_t) check_random());
+    }
+  }
+  memcpy(ram, check_emulator.ram, sizeof(ram));
+}
+
+/* Display RAM against the image at the position and the saved RAM elsewhere */
+static int compare(uint8_t width, uint8_t pages, uint8_t column_addr, uint8_t page_addr) {
+  int mismatches = 0;
+  uint8_t page;
+
+  for (page = 0; page < SH1106_PAGES; page++) {
+    uint8_t column;
+
+    for (column = 0; column < SH1106_COLUMNS; column++) {
+      uint8_t expected = ram[page][column];
+
+      if (page >= page_addr && page < page_addr + pages && column >= column_addr && column < column_addr + width) {
+        expected = pixels[(page - page_addr) * width + column - column_addr];
+      }
+      mismatches += check_emulator.ram[page][column] != expected;
+    }
+  }
+  return mismatches;
+}
+
+/* Number of COPY tokens reaching the full window back */
+static unsigned far_copies(size_t size) {
+  unsigned copies = 0;
+  size_t position = SH1106_IMAGE_HEADER_SIZE;
+
+  while (position < size) {
+    uint8_t token = image[position];
+
+    if (token < SH1106_IMAGE_ZERO) {
+      position += (size_t) (token - SH1106_IMAGE_LITERAL) + 2;
+    } else if (token < SH1106_IMAGE_FILL) {
+      position++;
+    } else if (token < SH1106_IMAGE_COPY) {
+      position += 2;
+    } else {
+      copies += image[position + 1] == SH1106_IMAGE_WINDOW_SIZE - 1;
+      position += 2;
+    }
+  }
+  return copies;
+}
+
+/* Runs of zeros, fills, repeats from up to 300 bytes back and noise */
+static void generate(size_t total) {
+  size_t position = 0;
+
+  while (position < total) {
+    size_t n = check_random() % 40 + 1;
+    unsigned kind = check_random() % 4;
+    size_t back = check_random() % 300 + 1;
+    uint8_t data = (uint8_t) check_random();
+
+    for (; n != 0 && position < total; n--, position++) {
+      switch (kind) {
+        case 0:
+          pixels[position] = 0x00;
+          break;
+        case 1:
+          pixels[position] = data;
+          break;
+        case 2:
+          pixels[position] = position >= back ? pixels[position - back] : data;
+          break;
+        default:
+          pixels[position] = (uint8_t) check_random();
+          break;
+      }
+    }
+  }
+}
+
+static int round_trip(uint8_t width, uint8_t pages) {
+  uint8_t column_addr = (uint8_t) (check_random() % (SH1106_COLUMNS - width + 1));
+  uint8_t page_addr = (uint8_t) (check_random() % (SH1106_PAGES - pages + 1));
+  size_t size = sh1106_encode_image(pixels, width, pages, image, sizeof(image));
+  int mismatches = 0;
+  size_t length;
+
+  if (size == 0) {
+    return 1;
+  }
+
+  scramble();
+  mismatches += sh1106_draw_image(check_send8_cmd, check_send8_data, image, size, column_addr, page_addr) != 0;
+  mismatches += compare(width, pages, column_addr, page_addr);
+
+  for (length = 0; length < size; length++) {
+    mismatches += sh1106_draw_image(check_send8_cmd, check_send8_data, image, length, column_addr, page_addr) == 0;
+  }
+  image[size] = 0x00;
+  mismatches += sh1106_draw_image(check_send8_cmd, check_send8_data, image, size + 1, column_addr, page_addr) == 0;
+  return mismatches;
+}
+
+int check_image(void) {
+  int mismatches = 0;
+  unsigned round;
+  size_t index;
+
+  for (round = 0; round < 100; round++) {
+    uint8_t width = (uint8_t) (check_random() % SH1106_COLUMNS + 1);
+    uint8_t pages = (uint8_t) (check_random() % SH1106_PAGES + 1);
+
+    generate((size_t) width * pages);
+    mismatches += round_trip(width, pages);
+  }
+
+  /* 256 bytes of noise repeated, only a COPY from the far edge of the window matches */
+  for (index = 0; index < IMAGE_SIZE; index++) {
+    pixels[index] = index < SH1106_IMAGE_WINDOW_SIZE ? (uint8_t) check_random()
+                                                     : pixels[index - SH1106_IMAGE_WINDOW_SIZE];
+  }
+  mismatches += round_trip(SH1106_COLUMNS, SH1106_PAGES);
+  mismatches += far_copies(sh1106_encode_image(pixels, SH1106_COLUMNS, SH1106_PAGES, image, sizeof(image))) == 0;
+
+  /* A COPY from before the first byte */
+  image[0] = 4;
+  image[1] = 1;
+  image[2] = SH1106_IMAGE_LITERAL;
+  image[3] = 0x55;
+  image[4] = SH1106_IMAGE_COPY;
+  image[5] = 1;
+  mismatches += sh1106_draw_image(check_send8_cmd, check_send8_data, image, 6, 0, 0) == 0;
+  image[5] = 0;
+  mismatches += sh1106_draw_image(check_send8_cmd, check_send8_data, image, 6, 0, 0) != 0;
+
+  return mismatches;
+}
@@ -0,0 +1,116 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Portrait orientations: a portrait frame is transposed into display RAM, sent to the emulator and the orientation
+ * programmed. Seen through the segment re-map and the COM scan direction, every portrait pixel (x, y) must light
+ * segment y of COM line 63 - x at 90 degrees and segment 131 - y of COM line x at 270 degrees, the module turned
+ * clockwise. Regions that do not fit the portrait frame or the display RAM are rejected.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_orientation.h"
+
+#define PORTRAIT_WIDTH (SH1106_PAGES * 8)
+#define PORTRAIT_PAGES 16
+
+static uint8_t portrait[PORTRAIT_PAGES * PORTRAIT_WIDTH];
+static uint8_t landscape[SH1106_PAGES * SH1106_COLUMNS];
+
+/* Pixel on the segment and COM line of the panel */
+static uint8_t lit(uint8_t segment, uint8_t com_line) {
+  uint8_t column = check_emulator.segment_re_map ? (uint8_t) (SH1106_COLUMNS - 1 - segment) : segment;
+  uint8_t line = check_emulator.scan_flipped ? (uint8_t) (SH1106_PAGES * 8 - 1 - com_line) : com_line;
+
+  return (uint8_t) ((check_emulator.ram[line / 8][column] >> (line % 8)) & 0x01);
+}
+
+static int show(enum sh1106_orientation orientation) {
+  int mismatches = 0;
+  uint8_t page_addr;
+
+  memset(landscape, 0x00, sizeof(landscape));
+  mismatches += sh1106_transpose_region(portrait,
+                                        PORTRAIT_WIDTH,
+                                        landscape,
+                                        SH1106_COLUMNS,
+                                        0,
+                                        0,
+                                        PORTRAIT_WIDTH,
+                                        PORTRAIT_PAGES) != 0;
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    sh1106_write_span(check_send8_cmd,
+                      check_send8_data,
+                      page_addr,
+                      0,
+                      &landscape[page_addr * SH1106_COLUMNS],
+                      SH1106_COLUMNS);
+  }
+  sh1106_set_orientation(check_send8_cmd, orientation);
+  return mismatches;
+}
+
+int check_orientation(void) {
+  int mismatches = 0;
+  uint16_t index;
+  uint8_t x;
+  uint8_t y;
+
+  /* One pixel at a known place */
+  memset(portrait, 0x00, sizeof(portrait));
+  portrait[(20 / 8) * PORTRAIT_WIDTH + 5] = 1 << (20 % 8);
+  mismatches += show(SH1106_ORIENTATION_90);
+  mismatches += !lit(20, 58);
+  mismatches += show(SH1106_ORIENTATION_270);
+  mismatches += !lit(111, 5);
+
+  /* Every pixel of a random frame */
+  for (index = 0; index < sizeof(portrait); index++) {
+    portrait[index] = (uint8_t) check_random();
+  }
+  mismatches += show(SH1106_ORIENTATION_90);
+  for (y = 0; y < PORTRAIT_PAGES * 8; y++) {
+    for (x = 0; x < PORTRAIT_WIDTH; x++) {
+      uint8_t pixel = (uint8_t) ((portrait[(y / 8) * PORTRAIT_WIDTH + x] >> (y % 8)) & 0x01);
+
+      mismatches += lit(y, (uint8_t) (SH1106_PAGES * 8 - 1 - x)) != pixel;
+    }
+  }
+  mismatches += show(SH1106_ORIENTATION_270);
+  for (y = 0; y < PORTRAIT_PAGES * 8; y++) {
+    for (x = 0; x < PORTRAIT_WIDTH; x++) {
+      uint8_t pixel = (uint8_t) ((portrait[(y / 8) * PORTRAIT_WIDTH + x] >> (y % 8)) & 0x01);
+
+      mismatches += lit((uint8_t) (SH1106_COLUMNS - 1 - y), x) != pixel;
+    }
+  }
+
+  /* Portrait frame wider than the display is high, region past the frame, destination too narrow */
+  mismatches += sh1106_transpose_region(portrait, 72, landscape, SH1106_COLUMNS, 0, 0, 72, 1) == 0;
+  mismatches += sh1106_transpose_region(portrait, PORTRAIT_WIDTH, landscape, SH1106_COLUMNS, 60, 0, 8, 1) == 0;
+  mismatches += sh1106_transpose_region(portrait, PORTRAIT_WIDTH, landscape, 120, 0, 8, 8, 8) == 0;
+  mismatches += sh1106_transpose_region(portrait, PORTRAIT_WIDTH, landscape, 120, 0, 7, 8, 8) != 0;
+  mismatches += sh1106_transpose_region(portrait, PORTRAIT_WIDTH, landscape, 120, 60, 0, 0, 1) != 0;
+
+  return mismatches;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Frame pacing on a simulated clock polled every tick: random bursts of drawing invalidate pages, and a flush into
+ * the emulator follows every granted poll. A flush is granted exactly when the oldest pending invalidation may go out,
+ * never sooner than one frame period after the previous flush, with the union of the pages invalidated since. Every
+ * invalidation that did not get a flush of its own is counted as dropped, and the display ends up with the last frame.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_pacer.h"
+
+static int pace(uint16_t target_fps) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_pacer pacer;
+  uint32_t period = target_fps ? 1000 / target_fps : 0;
+  uint32_t previous = 0;
+  uint32_t oldest = 0;
+  uint32_t flushes = 0;
+  uint8_t pages = 0;
+  int mismatches = 0;
+  uint32_t now;
+
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  sh1106_pacer_init(&pacer, 1000, target_fps);
+
+  for (now = 0; now < 5000 || pacer.dirty_pages; now++) {
+    uint8_t page_mask;
+
+    /* Bursts of a few ticks with several frames each, then quiet */
+    if (now < 5000 && now % 97 < 20) {
+      unsigned frames;
+
+      for (frames = check_random() % 4; frames != 0; frames--) {
+        int16_t y = (int16_t) (check_random() % (SH1106_PAGES * 8));
+        int16_t height = (int16_t) (check_random() % 12 + 1);
+        uint8_t first = (uint8_t) (y / 8);
+        uint8_t last = (uint8_t) ((y + height - 1) / 8 < SH1106_PAGES ? (y + height - 1) / 8 : SH1106_PAGES - 1);
+        uint8_t mask = (uint8_t) ((0xFF << first) & (0xFF >> (SH1106_PAGES - 1 - last)));
+
+        sh1106_framebuffer_fill_rect(&framebuffer,
+                                     (int16_t) (check_random() % SH1106_COLUMNS),
+                                     y,
+                                     (int16_t) (check_random() % 40 + 1),
+                                     height,
+                                     (uint8_t) (check_random() % 2));
+        if (pages == 0) {
+          oldest = now;
+        }
+        pages |= mask;
+        sh1106_pacer_invalidate(&pacer, mask);
+      }
+    }
+
+    page_mask = sh1106_pacer_poll(&pacer, now);
+    if (page_mask) {
+      uint32_t due = flushes == 0 || oldest >= previous + period ? oldest : previous + period;
+
+      mismatches += now != due;
+      mismatches += flushes != 0 && now - previous < period;
+      mismatches += page_mask != pages;
+      sh1106_framebuffer_flush(check_send8_cmd, check_send8_data, &framebuffer);
+      previous = now;
+      pages = 0;
+      flushes++;
+    } else {
+      mismatches += pages != 0 && flushes != 0 && now >= previous + period && now >= oldest;
+    }
+  }
+
+  mismatches += pacer.metrics.flushes != flushes;
+  mismatches += pacer.metrics.dropped != pacer.metrics.invalidations - flushes;
+  mismatches += target_fps != 0 && pacer.metrics.merged == 0;
+  mismatches += memcmp(check_emulator.ram, pixels, sizeof(pixels)) != 0;
+  return mismatches;
+}
+
+int check_pacer(void) {
+  return pace(30) + pace(100) + pace(0);
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Partial display bands away from page 0 and COM line 0: a model of the row scan (COM line c drives row
+ * (c + display offset) mod 64 of the rows counted from the start line, rows past the multiplex ratio are not driven)
+ * must show every line of the framebuffer on COM line com_line + line and nothing on the other COM lines.
+ */
+
+#include "sh1106_check.h"
+#include "sh1106_partial.h"
+
+/* Display RAM line shown on the COM line, -1 if the COM line is not driven */
+static int16_t scan(uint8_t com_line) {
+  uint8_t row = (uint8_t) ((com_line + check_emulator.display_offset) & (SH1106_LINES - 1));
+
+  if (row > check_emulator.multiplex_ratio) {
+    return -1;
+  }
+  return (int16_t) ((check_emulator.start_line + row) & (SH1106_LINES - 1));
+}
+
+int check_partial(void) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_partial partial;
+  int mismatches = 0;
+  unsigned band;
+
+  for (band = 0; band < 64; band++) {
+    uint8_t ram_page = (uint8_t) (band % (SH1106_PAGES - 1) + 1);
+    uint8_t com_line;
+    uint16_t index;
+    uint8_t page_addr;
+
+    /* Garbage in the pages outside of the band */
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      uint8_t column;
+
+      sh1106_set_page_address(check_send8_cmd, page_addr);
+      sh1106_set_column_address(check_send8_cmd, 0);
+      for (column = 0; column < SH1106_COLUMNS; column++) {
+        sh1106_write_display_data(check_send8_data, (uint8_t) check_random());
+      }
+    }
+
+    sh1106_partial_init(&partial,
+                        ram_page,
+                        (uint8_t) (check_random() % (SH1106_PAGES - ram_page) + 1),
+                        (uint8_t) (check_random() % SH1106_LINES));
+    sh1106_partial_framebuffer_init(&partial, &framebuffer, pixels);
+    for (index = 0; index < SH1106_FRAMEBUFFER_SIZE(partial.pages); index++) {
+      pixels[index] = (uint8_t) check_random();
+    }
+    sh1106_framebuffer_invalidate(&framebuffer);
+    sh1106_set_partial_display(check_send8_cmd, &partial);
+    sh1106_partial_flush(check_send8_cmd, check_send8_data, &partial, &framebuffer);
+
+    for (com_line = 0; com_line < SH1106_LINES; com_line++) {
+      uint8_t line = (uint8_t) ((com_line - partial.com_line) & (SH1106_LINES - 1));
+      int16_t shown = scan(com_line);
+      uint8_t column;
+
+      if (line >= partial.pages * 8) {
+        mismatches += shown != -1;
+        continue;
+      }
+      if (shown < 0) {
+        mismatches++;
+        continue;
+      }
+      for (column = 0; column < SH1106_COLUMNS; column++) {
+        mismatches += ((check_emulator.ram[shown / 8][column] >> (shown % 8)) & 0x01)
+            != ((pixels[(line / 8) * SH1106_COLUMNS + column] >> (line % 8)) & 0x01);
+      }
+    }
+  }
+
+  return mismatches;
+}
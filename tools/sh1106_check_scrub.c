@@ -0,0 +1,98 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Scrubber: polled often enough, every refresh restores the display RAM and the configured registers, none is counted
+ * as an overrun and the refreshes keep the cadence of the period. With a budget too small for the polls, every refresh
+ * is an overrun. The registers are configured away from their POR values and garbled in the emulator with the RAM.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_scrub.h"
+
+#define PERIOD 1000
+#define CYCLES 20
+
+static int scrub(uint32_t step, uint16_t budget, uint8_t overrun) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_registers registers;
+  struct sh1106_scrub scrub;
+  int mismatches = 0;
+  uint32_t cycles = 0;
+  uint32_t now;
+  uint16_t index;
+
+  sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+  sh1106_registers_init(&registers);
+  registers.contrast = (uint8_t) check_random();
+  registers.segment_re_map = check_random() % 2 ? SH1106_SEGMENT_RE_MAP_REVERSE_DIRECTION
+                                                : SH1106_SEGMENT_RE_MAP_NORMAL_DIRECTION;
+  registers.common_output_scan_direction = check_random() % 2 ? SH1106_COMMON_OUTPUT_SCAN_DIRECTION_VERTICALLY_FLIPPED
+                                                              : SH1106_COMMON_OUTPUT_SCAN_NORMAL_DIRECTION;
+  registers.multiplex_ratio = (uint8_t) (check_random() % 49 + 15);
+  registers.dc_dc_mode = check_random() % 2 ? SH1106_DC_DC_DISABLE : SH1106_DC_DC_ENABLE;
+  sh1106_scrub_init(&scrub, &registers, &framebuffer, 0, PERIOD, budget);
+
+  for (now = 0; now < CYCLES * PERIOD; now += step) {
+    /* Corrupted at the start of a refresh, restored by its end */
+    if (scrub.position == 0) {
+      for (index = 0; index < sizeof(pixels); index++) {
+        pixels[index] = (uint8_t) check_random();
+      }
+      check_emulator.ram[check_random() % SH1106_PAGES][check_random() % SH1106_COLUMNS] ^= 0xFF;
+      check_emulator.contrast = (uint8_t) check_random();
+      check_emulator.segment_re_map = (uint8_t) (check_random() % 2);
+      check_emulator.scan_flipped = (uint8_t) (check_random() % 2);
+      check_emulator.multiplex_ratio = (uint8_t) (check_random() % 64);
+      check_emulator.dc_dc = (uint8_t) (check_random() % 2);
+    }
+
+    mismatches += sh1106_scrub_poll(&scrub, check_send8_cmd, check_send8_data, now) > budget;
+    if (scrub.metrics.cycles != cycles) {
+      cycles = scrub.metrics.cycles;
+      mismatches += memcmp(check_emulator.ram, pixels, sizeof(pixels)) != 0;
+      mismatches += check_emulator.contrast != registers.contrast;
+      mismatches += check_emulator.segment_re_map
+          != (registers.segment_re_map == SH1106_SEGMENT_RE_MAP_REVERSE_DIRECTION);
+      mismatches += check_emulator.scan_flipped
+          != (registers.common_output_scan_direction == SH1106_COMMON_OUTPUT_SCAN_DIRECTION_VERTICALLY_FLIPPED);
+      mismatches += check_emulator.multiplex_ratio != registers.multiplex_ratio;
+      mismatches += check_emulator.dc_dc != (registers.dc_dc_mode == SH1106_DC_DC_ENABLE);
+      mismatches += !overrun && scrub.start != cycles * PERIOD;
+    }
+  }
+
+  mismatches += cycles == 0;
+  mismatches += scrub.metrics.overruns != (overrun ? cycles : 0);
+  return mismatches;
+}
+
+int check_scrub(void) {
+  int mismatches = 0;
+
+  mismatches += scrub(1, 64, 0);
+  mismatches += scrub(7, 64, 0);
+  mismatches += scrub(50, 64, 0);
+  mismatches += scrub(7, 8, 1);
+  return mismatches;
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Equivalence of the sparse and the dense framebuffer: the same random pixels, rectangles and clears are drawn into
+ * both, and after every flush the display RAM of both emulators must be equal.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_sparse.h"
+
+static struct sh1106_emulator sparse_emulator;
+
+static void sparse_send8_cmd(uint8_t cmd) {
+  sh1106_emulator_cmd(&sparse_emulator, cmd);
+}
+
+static void sparse_send8_data(uint8_t data) {
+  sh1106_emulator_data(&sparse_emulator, data);
+}
+
+int check_sparse(void) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t bytes[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffer;
+  struct sh1106_sparse sparse;
+  int mismatches = 0;
+  unsigned trial;
+
+  for (trial = 0; trial < 50; trial++) {
+    unsigned frame;
+
+    sh1106_emulator_reset(&check_emulator);
+    sh1106_emulator_reset(&sparse_emulator);
+    sh1106_framebuffer_init(&framebuffer, pixels, SH1106_PAGES);
+    sh1106_sparse_init(&sparse, bytes, sizeof(bytes));
+
+    for (frame = 0; frame < 60; frame++) {
+      unsigned operations = check_random() % 20;
+      uint16_t occupied = 0;
+      uint16_t index;
+
+      while (operations-- != 0) {
+        uint16_t kind = check_random() % 10;
+        int16_t x = (int16_t) (check_random() % 160 - 14);
+        int16_t y = (int16_t) (check_random() % 80 - 8);
+        int16_t width = (int16_t) (check_random() % 40);
+        int16_t height = (int16_t) (check_random() % 20);
+        uint8_t on = (uint8_t) (check_random() % 3 != 0);
+
+        if (kind < 6) {
+          sh1106_framebuffer_set_pixel(&framebuffer, x, y, on);
+          mismatches += sh1106_sparse_set_pixel(&sparse, x, y, on) != 0;
+        } else if (kind < 9) {
+          sh1106_framebuffer_fill_rect(&framebuffer, x, y, width, height, on);
+          mismatches += sh1106_sparse_fill_rect(&sparse, x, y, width, height, on) != 0;
+        } else if (check_random() % 4 == 0) {
+          sh1106_framebuffer_clear(&framebuffer);
+          sh1106_sparse_clear(&sparse);
+        }
+      }
+
+      sh1106_framebuffer_flush(check_send8_cmd, check_send8_data, &framebuffer);
+      sh1106_sparse_flush(sparse_send8_cmd, sparse_send8_data, &sparse);
+      mismatches += memcmp(check_emulator.ram, sparse_emulator.ram, sizeof(check_emulator.ram)) != 0;
+
+      for (index = 0; index < sizeof(pixels); index++) {
+        occupied = (uint16_t) (occupied + (pixels[index] != 0));
+        mismatches += pixels[index] != sh1106_sparse_get(&sparse,
+                                                         (uint8_t) (index / SH1106_COLUMNS),
+                                                         (uint8_t) (index % SH1106_COLUMNS));
+      }
+      mismatches += occupied != sparse.size;
+    }
+  }
+
+  /* A full pool fails the drawing instead of dropping pixels silently */
+  sh1106_sparse_init(&sparse, bytes, 10);
+  mismatches += sh1106_sparse_fill_rect(&sparse, 0, 0, 20, 8, 1) != -1;
+  mismatches += sparse.size != 10;
+
+  return mismatches;
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Tiled canvas of a landscape and a portrait panel, both modules with 128 visible columns from column 2 of display
+ * RAM, then with 120 from column 12. Random drawing is flushed into one emulator per panel, and the display RAM of
+ * each must equal its slice of the canvas: canvas pixel (x, y) of the landscape slice at line y and column
+ * offset + x, of the portrait slice at line x and column offset + y. Columns outside of the visible ones are never
+ * written, and every flush returns the number of data bytes it sent.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_tiled.h"
+
+#define CANVAS_PAGES 16
+
+static struct sh1106_emulator portrait_emulator;
+
+static void portrait_send8_cmd(uint8_t cmd) {
+  sh1106_emulator_cmd(&portrait_emulator, cmd);
+}
+
+static void portrait_send8_data(uint8_t data) {
+  sh1106_emulator_data(&portrait_emulator, data);
+}
+
+static uint8_t ram_pixel(const struct sh1106_emulator *emulator, uint8_t column, uint8_t line) {
+  return (uint8_t) ((emulator->ram[line / 8][column] >> (line % 8)) & 0x01);
+}
+
+static int tiles(uint8_t column_offset, uint8_t visible) {
+  static uint8_t pixels[(SH1106_COLUMNS + SH1106_PAGES * 8) * CANVAS_PAGES];
+  uint16_t canvas_width = (uint16_t) (visible + SH1106_PAGES * 8);
+  struct sh1106_tiled tiled;
+  struct sh1106_panel panel;
+  int mismatches = 0;
+  unsigned frame;
+
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_emulator_reset(&portrait_emulator);
+  sh1106_tiled_init(&tiled, pixels, canvas_width, CANVAS_PAGES);
+
+  memset(&panel, 0x00, sizeof(panel));
+  panel.send8_cmd = check_send8_cmd;
+  panel.send8_data = check_send8_data;
+  panel.width = visible;
+  panel.pages = SH1106_PAGES;
+  panel.column_offset = column_offset;
+  panel.orientation = SH1106_ORIENTATION_0;
+  mismatches += sh1106_tiled_add_panel(&tiled, &panel) != 0;
+
+  /* 64 columns right of the landscape panel */
+  panel.send8_cmd = portrait_send8_cmd;
+  panel.send8_data = portrait_send8_data;
+  panel.x = visible;
+  panel.orientation = SH1106_ORIENTATION_90;
+  panel.bus = 1;
+  mismatches += sh1106_tiled_add_panel(&tiled, &panel) != 1;
+
+  for (frame = 0; frame < 200; frame++) {
+    struct sh1106_emulator *emulators[] = {&check_emulator, &portrait_emulator};
+    unsigned operations;
+    uint8_t index;
+    uint8_t column;
+    uint8_t line;
+
+    for (operations = check_random() % 6; operations != 0; operations--) {
+      int16_t x = (int16_t) (check_random() % (canvas_width + 20) - 10);
+      int16_t y = (int16_t) (check_random() % (CANVAS_PAGES * 8 + 20) - 10);
+
+      if (check_random() % 2) {
+        sh1106_tiled_fill_rect(&tiled,
+                               x,
+                               y,
+                               (int16_t) (check_random() % 60),
+                               (int16_t) (check_random() % 40),
+                               (uint8_t) (check_random() % 2));
+      } else {
+        sh1106_tiled_set_pixel(&tiled, x, y, (uint8_t) (check_random() % 2));
+      }
+    }
+    for (index = 0; index < 2; index++) {
+      uint32_t data = emulators[index]->data;
+
+      mismatches += sh1106_tiled_flush_panel(&tiled, index) != emulators[index]->data - data;
+    }
+
+    for (column = 0; column < SH1106_COLUMNS; column++) {
+      for (line = 0; line < SH1106_PAGES * 8; line++) {
+        uint8_t landscape = 0;
+        uint8_t portrait = 0;
+
+        if (column >= column_offset && column < column_offset + visible) {
+          landscape = sh1106_tiled_get_pixel(&tiled, (int16_t) (column - column_offset), line);
+          portrait = sh1106_tiled_get_pixel(&tiled, (int16_t) (visible + line), (int16_t) (column - column_offset));
+        }
+        mismatches += ram_pixel(&check_emulator, column, line) != landscape;
+        mismatches += ram_pixel(&portrait_emulator, column, line) != portrait;
+      }
+    }
+  }
+
+  /* The portrait panel mounted at 90 degrees */
+  sh1106_tiled_set_orientation(&tiled);
+  mismatches += check_emulator.segment_re_map || check_emulator.scan_flipped;
+  mismatches += portrait_emulator.segment_re_map || !portrait_emulator.scan_flipped;
+
+  return mismatches;
+}
+
+int check_tiled(void) {
+  return tiles(2, 128) + tiles(12, 120);
+}
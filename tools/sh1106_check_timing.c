@@ -0,0 +1,106 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+/*
+ * Flush timing of the compositor: the simulated clock advances by a random number of ticks of drawing after
+ * sh1106_timing_begin() and by one tick per byte sent into the emulator. Each flush must record the drawing as the
+ * render stage, nothing for diff and encode, the bytes as the transfer stage and their sum as the total. Built without
+ * SH1106_TIMING nothing is recorded. Either way the display must show the composited layer.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_compositor.h"
+#include "sh1106_timing.h"
+
+static uint32_t timing_now;
+
+static uint32_t timing_clock(void) {
+  return timing_now;
+}
+
+static void timing_send8_cmd(uint8_t cmd) {
+  check_send8_cmd(cmd);
+  timing_now++;
+}
+
+static void timing_send8_data(uint8_t data) {
+  check_send8_data(data);
+  timing_now++;
+}
+
+int check_timing(void) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t output[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_layer layer;
+  struct sh1106_compositor compositor;
+  struct sh1106_timing timing;
+  int mismatches = 0;
+  unsigned frame;
+  uint8_t page_addr;
+
+  sh1106_emulator_reset(&check_emulator);
+  sh1106_layer_init(&layer, pixels, NULL);
+  sh1106_compositor_init(&compositor, output);
+  sh1106_compositor_add(&compositor, &layer);
+  compositor.timing = &timing;
+  timing_now = 0;
+
+  for (frame = 0; frame < 200; frame++) {
+    uint32_t render = check_random() % 1000;
+    uint32_t bytes = check_emulator.commands + check_emulator.data;
+    uint8_t stage;
+
+    sh1106_timing_init(&timing, timing_clock);
+    sh1106_timing_begin(&timing);
+    sh1106_framebuffer_fill_rect(&layer.framebuffer,
+                                 (int16_t) (check_random() % 140 - 4),
+                                 (int16_t) (check_random() % 72 - 4),
+                                 (int16_t) (check_random() % 60 + 1),
+                                 (int16_t) (check_random() % 30 + 1),
+                                 (uint8_t) (check_random() % 2));
+    timing_now += render;
+    sh1106_compositor_flush(timing_send8_cmd, timing_send8_data, &compositor);
+    bytes = check_emulator.commands + check_emulator.data - bytes;
+
+#ifdef SH1106_TIMING
+    for (stage = 0; stage < SH1106_STAGES; stage++) {
+      mismatches += timing.stages[stage].count != 1;
+    }
+    mismatches += timing.stages[SH1106_STAGE_RENDER].max != render;
+    mismatches += timing.stages[SH1106_STAGE_DIFF].max != 0;
+    mismatches += timing.stages[SH1106_STAGE_ENCODE].max != 0;
+    mismatches += timing.stages[SH1106_STAGE_TRANSFER].max != bytes;
+    mismatches += timing.stages[SH1106_STAGE_TOTAL].max != render + bytes;
+#else
+    for (stage = 0; stage < SH1106_STAGES; stage++) {
+      mismatches += timing.stages[stage].count != 0;
+    }
+#endif
+
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      mismatches += memcmp(check_emulator.ram[page_addr], &pixels[page_addr * SH1106_COLUMNS], SH1106_COLUMNS) != 0;
+    }
+  }
+
+  return mismatches;
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Transfer lists: random dirty sets of a framebuffer of 8 pages and of one of 4 pages sharing the same pixels are
+ * compiled for random page offsets, often for the same dirty set again so the cached list is reused, and run into the
+ * emulator. The display RAM and the data byte count must match sh1106_framebuffer_flush_at() into a second emulator.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_transfer.h"
+
+static struct sh1106_emulator flush_emulator;
+
+static void flush_send8_cmd(uint8_t cmd) {
+  sh1106_emulator_cmd(&flush_emulator, cmd);
+}
+
+static void flush_send8_data(uint8_t data) {
+  sh1106_emulator_data(&flush_emulator, data);
+}
+
+int check_transfer(void) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer framebuffers[2];
+  struct sh1106_transfer_list list;
+  struct sh1106_dirty dirty;
+  int mismatches = 0;
+  unsigned frame;
+
+  sh1106_emulator_reset(&flush_emulator);
+  sh1106_framebuffer_init(&framebuffers[0], pixels, SH1106_PAGES);
+  sh1106_framebuffer_init(&framebuffers[1], pixels, SH1106_PAGES / 2);
+  sh1106_transfer_reset(&list);
+  sh1106_dirty_reset(&dirty);
+
+  for (frame = 0; frame < 2000; frame++) {
+    struct sh1106_framebuffer *framebuffer = &framebuffers[check_random() % 2];
+    uint8_t page_offset = framebuffer->pages == SH1106_PAGES ? 0 : (uint8_t) (check_random() % (SH1106_PAGES / 2 + 1));
+    uint16_t sent;
+
+    /* Draw something new, or flush the last dirty set again */
+    if (check_random() % 3 == 0) {
+      sh1106_dirty_reset(&framebuffer->dirty);
+      sh1106_framebuffer_fill_rect(framebuffer,
+                                   (int16_t) (check_random() % 140 - 4),
+                                   (int16_t) (check_random() % 36 - 2),
+                                   (int16_t) (check_random() % 40 + 1),
+                                   (int16_t) (check_random() % 20 + 1),
+                                   (uint8_t) (check_random() % 2));
+      dirty = framebuffer->dirty;
+    } else {
+      framebuffer->dirty = dirty;
+    }
+
+    sh1106_transfer_compile_at(&list, framebuffer, page_offset);
+    sent = sh1106_transfer_run(check_send8_cmd, check_send8_data, &list);
+    mismatches += sent != sh1106_framebuffer_flush_at(flush_send8_cmd, flush_send8_data, framebuffer, page_offset);
+    mismatches += memcmp(check_emulator.ram, flush_emulator.ram, sizeof(check_emulator.ram)) != 0;
+  }
+
+  return mismatches;
+}
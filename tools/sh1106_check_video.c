@@ -0,0 +1,132 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Video player: played from a temporary animation file into the emulator, polled on time and polled late, the region
+ * of the display shows the newest frame sent and the rest of the display is left alone. Every frame is either
+ * presented or dropped.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+#include "sh1106_video.h"
+
+#define WIDTH 32
+#define PAGES 3
+#define FRAMES 40
+#define COLUMN 10
+#define PAGE_ADDR 2
+#define PERIOD 10
+
+static uint8_t frames[FRAMES][WIDTH * PAGES];
+static uint8_t before[SH1106_PAGES][SH1106_COLUMNS];
+
+static int compare(uint32_t frame) {
+  int mismatches = 0;
+  uint8_t page;
+
+  for (page = 0; page < SH1106_PAGES; page++) {
+    uint8_t column;
+
+    for (column = 0; column < SH1106_COLUMNS; column++) {
+      uint8_t expected = before[page][column];
+
+      if (page >= PAGE_ADDR && page < PAGE_ADDR + PAGES && column >= COLUMN && column < COLUMN + WIDTH) {
+        expected = frames[frame][(page - PAGE_ADDR) * WIDTH + column - COLUMN];
+      }
+      mismatches += check_emulator.ram[page][column] != expected;
+    }
+  }
+
+  return mismatches;
+}
+
+/* Polls every step periods, at every poll until the due frame is sent: the worker thread may still be decoding it */
+static int play(const char *path, uint32_t step) {
+  static struct sh1106_video video;
+  int mismatches = 0;
+  uint32_t now;
+
+  if (sh1106_video_open(&video, path, NULL, COLUMN, PAGE_ADDR, PERIOD)) {
+    return 1;
+  }
+
+  for (now = 0; video.tail < FRAMES; now += step * PERIOD) {
+    uint32_t due = now / PERIOD < FRAMES ? now / PERIOD : FRAMES - 1;
+
+    while (video.tail <= due) {
+      sh1106_video_poll(&video, check_send8_cmd, check_send8_data, now);
+    }
+    mismatches += compare(due);
+  }
+
+  mismatches += video.metrics.presented + video.metrics.dropped != FRAMES;
+  mismatches += step == 1 && video.metrics.dropped != 0;
+  sh1106_video_close(&video);
+  return mismatches;
+}
+
+int check_video(void) {
+  static uint8_t data[8 + 4 * WIDTH * PAGES * (FRAMES + 1)];
+  char path[] = "/tmp/sh1106_check_video_XXXXXX";
+  int mismatches = 0;
+  uint16_t frame;
+  uint16_t index;
+  uint16_t size;
+  int fd;
+
+  for (index = 0; index < sizeof(before); index++) {
+    before[index / SH1106_COLUMNS][index % SH1106_COLUMNS] = (uint8_t) check_random();
+  }
+  for (index = 0; index < SH1106_PAGES; index++) {
+    sh1106_write_span(check_send8_cmd, check_send8_data, (uint8_t) index, 0, before[index], SH1106_COLUMNS);
+  }
+
+  for (index = 0; index < WIDTH * PAGES; index++) {
+    frames[0][index] = (uint8_t) check_random();
+  }
+  for (frame = 1; frame < FRAMES; frame++) {
+    for (index = 0; index < WIDTH * PAGES; index++) {
+      frames[frame][index] = (uint8_t) (check_random() & 1 ? check_random() : frames[frame - 1][index]);
+    }
+  }
+  size = check_animation_encode(data, frames[0], WIDTH, PAGES, FRAMES);
+
+  if ((fd = mkstemp(path)) == -1) {
+    return 1;
+  }
+  if (write(fd, data, size) != (ssize_t) size) {
+    mismatches++;
+  }
+  close(fd);
+
+  if (mismatches == 0) {
+    mismatches += play(path, 1);
+    mismatches += play(path, 3);
+  }
+  unlink(path);
+  return mismatches;
+}
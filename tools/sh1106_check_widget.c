@@ -0,0 +1,162 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Incremental rendering of the widget tree: random value changes, moves, removals and additions in nested groups are
+ * flushed into the emulator. The flush must send exactly the merged damage spans, the display RAM must equal a full
+ * render of the tree, and no pixel may be drawn outside of the groups the widgets are nested in.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_widget.h"
+
+/* Outer group and the inner group nested in it, in screen coordinates */
+#define OUTER_X 10
+#define OUTER_Y 4
+#define INNER_X (OUTER_X - 6)
+#define INNER_Y (OUTER_Y + 6)
+
+#define LEAVES 5
+
+/* Leaves are clipped to both groups, the inner group sticks out of the outer group to the left and below */
+static int inside_groups(const struct sh1106_widget *outer, const struct sh1106_widget *inner, int16_t x, int16_t y) {
+  int16_t inner_x = (int16_t) (outer->x + inner->x);
+  int16_t inner_y = (int16_t) (outer->y + inner->y);
+
+  return x >= outer->x && x < outer->x + outer->width && y >= outer->y && y < outer->y + outer->height
+      && x >= inner_x && x < inner_x + inner->width && y >= inner_y && y < inner_y + inner->height;
+}
+
+/* Sum of the damage spans, the bytes the next flush sends */
+static uint16_t damage_size(const struct sh1106_dirty *damage) {
+  uint16_t size = 0;
+  uint8_t page_addr;
+
+  for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+    if (damage->pages & (1 << page_addr)) {
+      size = (uint16_t) (size + damage->last[page_addr] - damage->first[page_addr] + 1);
+    }
+  }
+  return size;
+}
+
+int check_widget(void) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t incremental[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  static uint8_t glyphs[13 * 5];
+  struct sh1106_framebuffer screen;
+  struct sh1106_widgets widgets;
+  struct sh1106_widget outer;
+  struct sh1106_widget inner;
+  struct sh1106_widget leaves[LEAVES];
+  struct sh1106_asset font;
+  int mismatches = 0;
+  unsigned frame;
+  unsigned index;
+
+  /* '-' to '9' */
+  for (index = 0; index < sizeof(glyphs); index++) {
+    glyphs[index] = (uint8_t) check_random();
+  }
+  font.frames = glyphs;
+  font.count = 13;
+  font.kind = SH1106_ASSET_FONT;
+  font.width = 5;
+  font.pages = 1;
+  font.first = '-';
+
+  sh1106_framebuffer_init(&screen, pixels, SH1106_PAGES);
+  sh1106_widgets_init(&widgets, &screen);
+  sh1106_group_init(&outer, OUTER_X, OUTER_Y, 100, 52);
+  sh1106_group_init(&inner, INNER_X - OUTER_X, INNER_Y - OUTER_Y, 80, 60);
+  sh1106_value_init(&leaves[0], 2, 2, 30, 8, &font, 42);
+  sh1106_bar_init(&leaves[1], -4, 14, 50, 9, 0, 100, 30);
+  sh1106_gauge_init(&leaves[2], 30, 20, 41, 21, 0, 100, 70);
+  sh1106_bar_init(&leaves[3], 50, 44, 40, 12, -50, 50, 0);
+  sh1106_value_init(&leaves[4], 60, 0, 26, 16, &font, -7);
+  sh1106_widget_add(&widgets, NULL, &outer);
+  sh1106_widget_add(&widgets, &outer, &inner);
+  for (index = 0; index < LEAVES; index++) {
+    sh1106_widget_add(&widgets, &inner, &leaves[index]);
+  }
+
+  for (frame = 0; frame < 400; frame++) {
+    struct sh1106_widget *leaf = &leaves[check_random() % LEAVES];
+    uint32_t data = check_emulator.data;
+    uint16_t expected;
+    uint16_t column;
+    uint8_t page_addr;
+
+    switch (frame == 0 ? 4 : check_random() % 4) {
+      case 0:
+        sh1106_widget_set_value(&widgets, leaf, (int32_t) (check_random() % 1200) - 110);
+        break;
+      case 1:
+        sh1106_widget_move(&widgets, leaf, (int16_t) (check_random() % 100 - 20), (int16_t) (check_random() % 70 - 10));
+        break;
+      case 2:
+        if (leaf->parent == NULL) {
+          sh1106_widget_add(&widgets, &inner, leaf);
+        } else {
+          sh1106_widget_remove(&widgets, leaf);
+        }
+        break;
+      case 3:
+        sh1106_widget_move(&widgets, &inner, (int16_t) (check_random() % 13 - 12), (int16_t) (check_random() % 13));
+        break;
+      default:
+        break;
+    }
+
+    expected = damage_size(&widgets.damage);
+    mismatches += sh1106_widgets_flush(check_send8_cmd, check_send8_data, &widgets) != expected;
+    mismatches += check_emulator.data - data != expected;
+
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      for (column = 0; column < SH1106_COLUMNS; column++) {
+        mismatches += check_emulator.ram[page_addr][column] != pixels[page_addr * SH1106_COLUMNS + column];
+      }
+    }
+
+    /* Full render of the same tree */
+    memcpy(incremental, pixels, sizeof(pixels));
+    sh1106_widget_invalidate(&widgets, &widgets.root);
+    sh1106_widgets_render(&widgets);
+    sh1106_dirty_reset(&screen.dirty);
+    for (index = 0; index < sizeof(pixels); index++) {
+      mismatches += pixels[index] != incremental[index];
+    }
+
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      for (column = 0; column < SH1106_COLUMNS; column++) {
+        uint8_t line;
+
+        for (line = 0; line < 8; line++) {
+          mismatches += (pixels[page_addr * SH1106_COLUMNS + column] >> line & 0x01)
+              && !inside_groups(&outer, &inner, (int16_t) column, (int16_t) (page_addr * 8 + line));
+        }
+      }
+    }
+  }
+
+  return mismatches;
+}
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Windows: clip rectangles are the window rectangle clamped to the parent clip, drawing is translated by the origin
+ * and clipped against a pixel model, and every window keeps its own dirty set. A window's flush only sends bytes
+ * inside of its clip rectangle, leaves the dirty sets of the screen and of other windows alone, and after all windows
+ * are flushed the display RAM equals the screen.
+ */
+
+#include <string.h>
+
+#include "sh1106_check.h"
+#include "sh1106_framebuffer.h"
+
+#define WINDOWS 4
+
+static uint8_t model[SH1106_PAGES * 8][SH1106_COLUMNS];
+
+/* Clip rectangle of the window being flushed, and bytes sent outside of it */
+static const struct sh1106_framebuffer *flushed;
+static unsigned outside;
+
+static void window_send8_data(uint8_t data) {
+  uint8_t column = check_emulator.column_addr;
+  uint8_t page_addr = check_emulator.page_addr;
+
+  outside += column < flushed->clip_x0 || column >= flushed->clip_x1
+      || page_addr < flushed->clip_y0 / 8 || page_addr > (flushed->clip_y1 - 1) / 8;
+  check_send8_data(data);
+}
+
+static uint8_t clamp(int16_t value, uint8_t min, uint8_t max) {
+  return (uint8_t) (value < min ? min : value > max ? max : value);
+}
+
+/* Model of a rectangle drawn into the window */
+static void model_fill(const struct sh1106_framebuffer *window,
+                       int16_t x,
+                       int16_t y,
+                       int16_t width,
+                       int16_t height,
+                       uint8_t color) {
+  int16_t line;
+  int16_t column;
+
+  for (line = (int16_t) (y + window->origin_y); line < y + window->origin_y + height; line++) {
+    for (column = (int16_t) (x + window->origin_x); column < x + window->origin_x + width; column++) {
+      if (column >= window->clip_x0 && column < window->clip_x1 && line >= window->clip_y0 && line < window->clip_y1) {
+        model[line][column] = color;
+      }
+    }
+  }
+}
+
+int check_window(void) {
+  static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+  struct sh1106_framebuffer screen;
+  struct sh1106_framebuffer windows[WINDOWS];
+  int mismatches = 0;
+  unsigned frame;
+
+  for (frame = 0; frame < 200; frame++) {
+    uint8_t index;
+    uint8_t page_addr;
+
+    sh1106_emulator_reset(&check_emulator);
+    sh1106_framebuffer_init(&screen, pixels, SH1106_PAGES);
+    sh1106_dirty_reset(&screen.dirty);
+    memset(model, 0x00, sizeof(model));
+
+    /* The last window is nested in the first one */
+    for (index = 0; index < WINDOWS; index++) {
+      const struct sh1106_framebuffer *parent = index == WINDOWS - 1 ? &windows[0] : &screen;
+      int16_t x = (int16_t) (check_random() % 180 - 30);
+      int16_t y = (int16_t) (check_random() % 100 - 20);
+      int16_t width = (int16_t) (check_random() % 100);
+      int16_t height = (int16_t) (check_random() % 60);
+      uint8_t clip_x0 = clamp(x, parent->clip_x0, parent->clip_x1);
+      uint8_t clip_y0 = clamp(y, parent->clip_y0, parent->clip_y1);
+
+      sh1106_window_init(&windows[index], parent, x, y, width, height);
+      mismatches += windows[index].origin_x != x || windows[index].origin_y != y;
+      mismatches += windows[index].clip_x0 != clip_x0 || windows[index].clip_y0 != clip_y0;
+      mismatches += windows[index].clip_x1 != clamp((int16_t) (x + width), clip_x0, parent->clip_x1);
+      mismatches += windows[index].clip_y1 != clamp((int16_t) (y + height), clip_y0, parent->clip_y1);
+      mismatches += windows[index].dirty.pages != 0;
+    }
+
+    for (index = 0; index < WINDOWS; index++) {
+      struct sh1106_framebuffer *window = &windows[index];
+      unsigned rectangles;
+      uint8_t other;
+
+      for (rectangles = check_random() % 4; rectangles != 0; rectangles--) {
+        int16_t x = (int16_t) (check_random() % 120 - 40);
+        int16_t y = (int16_t) (check_random() % 80 - 20);
+        int16_t width = (int16_t) (check_random() % 50);
+        int16_t height = (int16_t) (check_random() % 30);
+
+        sh1106_framebuffer_fill_rect(window, x, y, width, height, 1);
+        model_fill(window, x, y, width, height, 1);
+      }
+
+      /* Drawing into one window marks nothing dirty anywhere else */
+      mismatches += screen.dirty.pages != 0;
+      for (other = 0; other < WINDOWS; other++) {
+        mismatches += other != index && windows[other].dirty.pages != 0;
+      }
+
+      flushed = window;
+      outside = 0;
+      sh1106_framebuffer_flush(check_send8_cmd, window_send8_data, window);
+      mismatches += outside != 0;
+      mismatches += window->dirty.pages != 0;
+    }
+
+    for (page_addr = 0; page_addr < SH1106_PAGES; page_addr++) {
+      uint8_t column;
+
+      for (column = 0; column < SH1106_COLUMNS; column++) {
+        uint8_t expected = 0;
+        uint8_t line;
+
+        for (line = 0; line < 8; line++) {
+          expected = (uint8_t) (expected | model[page_addr * 8 + line][column] << line);
+        }
+        mismatches += pixels[page_addr * SH1106_COLUMNS + column] != expected;
+        mismatches += check_emulator.ram[page_addr][column] != expected;
+      }
+    }
+  }
+
+  return mismatches;
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Converts a PBM image into the compressed page-major format of sh1106_image.h.
+ *
+ * Usage: sh1106_image <name> <image.pbm>
+ *
+ * Prints a C array named <name> to stdout and reports compression ratio and decode throughput to stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sh1106_image.h"
+#include "pbm.h"
+
+static volatile uint8_t sink;
+
+static void null_send8(uint8_t byte) {
+  sink = byte;
+}
+
+int main(int argc, char *argv[]) {
+  struct pbm_bitmap bitmap;
+  uint8_t image[SH1106_IMAGE_HEADER_SIZE + 2 * SH1106_PAGES * SH1106_COLUMNS];
+  size_t size;
+  size_t i;
+  unsigned long iterations = 0;
+  clock_t start;
+  double elapsed;
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <name> <image.pbm>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (pbm_load(argv[2], &bitmap)) {
+    fprintf(stderr, "%s: can not read PBM image\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  if (bitmap.width > SH1106_COLUMNS || bitmap.pages > SH1106_PAGES) {
+    fprintf(stderr, "%s: image is larger than %ux%u\n", argv[2], SH1106_COLUMNS, SH1106_PAGES * 8);
+    return EXIT_FAILURE;
+  }
+
+  size = sh1106_encode_image(bitmap.pixels, (uint8_t) bitmap.width, (uint8_t) bitmap.pages, image, sizeof(image));
+  if (size == 0) {
+    fprintf(stderr, "%s: can not encode image\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  printf("/* %s: %ux%u */\n", argv[2], bitmap.width, bitmap.height);
+  printf("const uint8_t %s[%lu] = {", argv[1], (unsigned long) size);
+  for (i = 0; i < size; i++) {
+    printf("%s0x%02X,", i % 16 ? " " : "\n    ", image[i]);
+  }
+  printf("\n};\n");
+
+  start = clock();
+  do {
+    if (sh1106_draw_image(null_send8, null_send8, image, size, 0, 0)) {
+      fprintf(stderr, "%s: decoder rejected the encoded image\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+    iterations++;
+    elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+  } while (elapsed < 0.2);
+
+  fprintf(stderr, "%s: %u -> %lu bytes (%.1f%%), decode %.1f MB/s\n",
+          argv[2],
+          bitmap.width * bitmap.pages,
+          (unsigned long) size,
+          100.0 * (double) size / (bitmap.width * bitmap.pages),
+          (double) iterations * bitmap.width * bitmap.pages / elapsed / 1e6);
+
+  free(bitmap.pixels);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Replays a transport trace (see sh1106_trace.h) through the command decoder.
+ *
+ * Usage: sh1106_replay [-g <gap>] <trace> [<prefix>]
+ *
+ * The trace is split into frames at pauses of at least <gap> ticks (10 ms by default). Per-frame byte and time
+ * statistics are printed to stdout, and display RAM is dumped to <prefix>NNNN.pbm after every frame if a prefix is
+ * given.
+ *
+ * A record holds the time of its first byte only. The time of a frame runs to the end of its last record, whose
+ * duration is estimated from the average time per byte of the records that directly follow another one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sh1106_emulator.h"
+#include "sh1106_trace.h"
+#include "file.h"
+#include "pbm.h"
+
+struct frame {
+  uint32_t start;
+  uint32_t end;
+  uint32_t commands;
+  uint32_t data;
+};
+
+static int dump(const char *prefix, unsigned index, const struct sh1106_emulator *emulator) {
+  char path[4096];
+  FILE *stream;
+  int status;
+
+  snprintf(path, sizeof(path), "%s%04u.pbm", prefix, index);
+  stream = fopen(path, "wb");
+  if (stream == NULL) {
+    return -1;
+  }
+
+  status = pbm_write(stream, &emulator->ram[0][0], SH1106_COLUMNS, SH1106_PAGES);
+  return fclose(stream) || status ? -1 : 0;
+}
+
+static void report(unsigned index, const struct frame *frame, uint32_t ticks_per_second) {
+  printf("%6u %12.3f %10.3f %8lu %8lu\n",
+         index,
+         1e3 * frame->start / ticks_per_second,
+         1e3 * (frame->end - frame->start) / ticks_per_second,
+         (unsigned long) frame->commands,
+         (unsigned long) frame->data);
+}
+
+/* Average ticks per byte of records that follow another record of the same frame */
+static double byte_time(const uint8_t *trace, uint32_t size, uint32_t offset, uint32_t gap) {
+  struct sh1106_trace_record record;
+  uint32_t previous_time = 0;
+  uint8_t previous_size = 0;
+  double ticks = 0;
+  double bytes = 0;
+
+  memset(&record, 0x00, sizeof(record));
+  while (sh1106_trace_read(trace, size, &offset, &record) == 1) {
+    if (previous_size != 0 && record.time - previous_time < gap) {
+      ticks += record.time - previous_time;
+      bytes += previous_size;
+    }
+    previous_time = record.time;
+    previous_size = record.size;
+  }
+
+  return bytes != 0 ? ticks / bytes : 0;
+}
+
+struct replay {
+  struct sh1106_emulator emulator;
+  const char *prefix;
+  uint32_t ticks_per_second;
+  double byte_time;
+  unsigned frames;
+  unsigned max_frame;
+  uint32_t max_bytes;
+};
+
+static int finish(struct replay *replay, struct frame *frame) {
+  report(replay->frames, frame, replay->ticks_per_second);
+  if (replay->prefix != NULL && dump(replay->prefix, replay->frames, &replay->emulator)) {
+    fprintf(stderr, "%s: can not write frame %u\n", replay->prefix, replay->frames);
+    return -1;
+  }
+
+  if (frame->commands + frame->data > replay->max_bytes) {
+    replay->max_bytes = frame->commands + frame->data;
+    replay->max_frame = replay->frames;
+  }
+  replay->frames++;
+  memset(frame, 0x00, sizeof(*frame));
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  static struct replay replay;
+  struct sh1106_trace_record record;
+  struct frame frame;
+  uint8_t *trace;
+  uint32_t size;
+  uint32_t offset;
+  uint32_t gap = 0;
+  int argi = 1;
+  int status;
+
+  if (argc > 2 && strcmp(argv[1], "-g") == 0) {
+    gap = (uint32_t) strtoul(argv[2], NULL, 0);
+    argi = 3;
+  }
+
+  if (argc - argi < 1 || argc - argi > 2) {
+    fprintf(stderr, "usage: %s [-g <gap>] <trace> [<prefix>]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (argc - argi == 2) {
+    replay.prefix = argv[argi + 1];
+  }
+
+  trace = file_load(argv[argi], &size);
+  if (trace == NULL || (offset = sh1106_trace_read_header(trace, size, &replay.ticks_per_second)) == 0) {
+    fprintf(stderr, "%s: can not read trace\n", argv[argi]);
+    return EXIT_FAILURE;
+  }
+  if (gap == 0) {
+    gap = replay.ticks_per_second / 100;
+  }
+
+  replay.byte_time = byte_time(trace, size, offset, gap);
+
+  sh1106_emulator_reset(&replay.emulator);
+  memset(&record, 0x00, sizeof(record));
+  memset(&frame, 0x00, sizeof(frame));
+
+  printf("%6s %12s %10s %8s %8s\n", "frame", "start, ms", "time, ms", "commands", "data");
+
+  while ((status = sh1106_trace_read(trace, size, &offset, &record)) == 1) {
+    uint8_t i;
+
+    if (frame.commands + frame.data != 0 && record.time - frame.end >= gap && finish(&replay, &frame)) {
+      return EXIT_FAILURE;
+    }
+
+    if (frame.commands + frame.data == 0) {
+      frame.start = record.time;
+    }
+    frame.end = record.time + (uint32_t) (record.size * replay.byte_time + 0.5);
+
+    for (i = 0; i < record.size; i++) {
+      if (record.data) {
+        sh1106_emulator_data(&replay.emulator, record.payload[i]);
+      } else {
+        sh1106_emulator_cmd(&replay.emulator, record.payload[i]);
+      }
+    }
+    if (record.data) {
+      frame.data += record.size;
+    } else {
+      frame.commands += record.size;
+    }
+  }
+
+  if (frame.commands + frame.data != 0 && finish(&replay, &frame)) {
+    return EXIT_FAILURE;
+  }
+
+  printf("%u frames, %lu command bytes, %lu data bytes, largest frame %u (%lu bytes)\n",
+         replay.frames,
+         (unsigned long) replay.emulator.commands,
+         (unsigned long) replay.emulator.data,
+         replay.max_frame,
+         (unsigned long) replay.max_bytes);
+
+  if (status < 0) {
+    fprintf(stderr, "%s: trace is truncated\n", argv[argi]);
+  }
+
+  free(trace);
+  return status < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
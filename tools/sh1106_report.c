@@ -0,0 +1,74 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Times the code of sh1106_report_code.c, see the sh1106_report target.
+ *
+ * Usage: sh1106_report_<variant> <variant>
+ *
+ * Prints the time per initialization and per full flush into null transports.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sh1106_report.h"
+
+static volatile uint8_t sink;
+
+static void null_send8(uint8_t byte) {
+  sink = byte;
+}
+
+static double measure(void (*run)(void)) {
+  unsigned long iterations = 0;
+  clock_t start = clock();
+  double elapsed;
+
+  do {
+    run();
+    iterations++;
+    elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+  } while (elapsed < 0.2);
+
+  return elapsed / iterations * 1e9;
+}
+
+static uint8_t pixels[SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES)];
+static struct sh1106_framebuffer framebuffer;
+
+static void run_init(void) {
+  report_init(null_send8);
+}
+
+static void run_flush(void) {
+  report_flush(null_send8, null_send8, &framebuffer);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <variant>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  report_framebuffer_init(&framebuffer, pixels);
+  printf("%s: init %.1f ns, flush %.1f ns\n", argv[1], measure(run_init), measure(run_flush));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_REPORT_H
+#define YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_REPORT_H
+
+#include <stdint.h>
+
+#include "sh1106.h"
+#include "sh1106_framebuffer.h"
+
+/**
+ * @brief Initialize framebuffer.
+ *
+ * @param[out] framebuffer Framebuffer
+ * @param[in] pixels Pixel storage, SH1106_FRAMEBUFFER_SIZE(SH1106_PAGES) bytes
+ */
+void report_framebuffer_init(struct sh1106_framebuffer *framebuffer, uint8_t *pixels);
+
+/**
+ * @brief Initialization sequence of the README example.
+ *
+ * @param[in] send8_cmd Command transport
+ */
+void report_init(const sh1106_send8_cmd_t send8_cmd);
+
+/**
+ * @brief Invalidate and flush the whole framebuffer.
+ *
+ * @param[in] send8_cmd Command transport
+ * @param[in] send8_data Data transport
+ * @param[in,out] framebuffer Framebuffer
+ *
+ * @return Number of data bytes sent
+ */
+uint16_t report_flush(const sh1106_send8_cmd_t send8_cmd,
+                      const sh1106_send8_data_t send8_data,
+                      struct sh1106_framebuffer *framebuffer);
+
+#endif // YET_ANOTHER_GAUGE__SH1106__TOOLS__SH1106_REPORT_H
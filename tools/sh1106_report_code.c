@@ -0,0 +1,53 @@
+/*
+ * This file is part of the 'Yet another gauge' project.
+ *
+ * Copyright (C) 2018 Ivan Dyachenko <vandyachen@gmail.com>
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Code measured by the sh1106_report target. It is built together with sh1106.c and sh1106_framebuffer.c into one
+ * static library per variant (out-of-line or SH1106_INLINE_COMMANDS and SH1106_INLINE_FRAMEBUFFER, -Os or -O2), so
+ * the size of the library is the flash cost of initialization and flush.
+ */
+
+#include "sh1106_report.h"
+
+void report_framebuffer_init(struct sh1106_framebuffer *framebuffer, uint8_t *pixels) {
+  sh1106_framebuffer_init(framebuffer, pixels, SH1106_PAGES);
+}
+
+void report_init(const sh1106_send8_cmd_t send8_cmd) {
+  sh1106_set_segment_re_map(send8_cmd, SH1106_SEGMENT_RE_MAP_REVERSE_DIRECTION);
+  sh1106_set_common_pads_hardware_configuration(send8_cmd, SH1106_COMMON_SIGNALS_PAD_CONFIGURATION_ALTERNATIVE);
+  sh1106_set_common_output_scan_direction(send8_cmd, SH1106_COMMON_OUTPUT_SCAN_NORMAL_DIRECTION);
+  sh1106_set_multiplex_ration(send8_cmd, 0x3F);
+  sh1106_set_display_clock_divide_ratio_oscillator_frequency(send8_cmd, 1, SH1106_OSCILLATOR_FREQUENCY_POR);
+  sh1106_set_vcom_deselect_level(send8_cmd, 0x35);
+  sh1106_set_contrast_control_register(send8_cmd, 0xFF);
+  sh1106_set_pump_voltage(send8_cmd, SH1106_PUMP_VOLTAGE_7_4);
+  sh1106_set_dc_dc_mode(send8_cmd, SH1106_DC_DC_ENABLE);
+  sh1106_set_display_state(send8_cmd, SH1106_OLED_ON);
+  sh1106_set_display_start_line(send8_cmd, 0);
+  sh1106_set_page_address(send8_cmd, 0);
+  sh1106_set_column_address(send8_cmd, 0);
+}
+
+uint16_t report_flush(const sh1106_send8_cmd_t send8_cmd,
+                      const sh1106_send8_data_t send8_data,
+                      struct sh1106_framebuffer *framebuffer) {
+  sh1106_framebuffer_invalidate(framebuffer);
+  return sh1106_framebuffer_flush(send8_cmd, send8_data, framebuffer);
+}